@@ -1,170 +1,302 @@
-#include "Actor.h"
-
-Actor::Actor(Mesh* mesh, Material* material, Texture* diffuseMap, Texture* specularMap, XMFLOAT3 position, XMFLOAT3 rotation, XMFLOAT3 scale)
-{ 
-
-    m_mesh = mesh;
-    m_material = material;
-    m_diffuseMap = diffuseMap;
-    m_specularMap = specularMap;
-
-    //Load vertex and index buffers from the mesh passed in
-    m_indexBuffer = m_mesh->IndexBuffer;
-    m_indexCount = m_mesh->IndexCount;
-    m_vertexBuffer = m_mesh->VertexBuffer;
-
-    //Set default translation matrices
-    XMStoreFloat4x4(&m_world, XMMatrixIdentity());
-
-    m_position = XMFLOAT3(0.0f, 0.0f, 0.0f);
-    m_rotation = XMFLOAT3(0.0f, 0.0f, 0.0f);
-    m_scale = XMFLOAT3(0.0f, 0.0f, 0.0f);
-
-    SetTransform(position, rotation, scale);
-}
-
-Actor::~Actor()
-{
-    if (m_vertexBuffer) m_vertexBuffer->Release();
-    if (m_indexBuffer) m_indexBuffer->Release();
-}
-
-#pragma region Translation
-
-void Actor::Translate(XMFLOAT3 translation)
-{
-    m_position = Add(m_position, translation);
-    UpdateTransform();
-}
-
-void Actor::SetPosition(XMFLOAT3 newPosition)
-{
-    m_position = newPosition;
-    UpdateTransform();
-}
-
-XMFLOAT3 Actor::GetPosition()
-{
-    return m_position;
-}
-
-void Actor::Rotate(XMFLOAT3 rotation)
-{
-    m_rotation = Add(m_rotation, rotation);
-    UpdateTransform();
-}
-
-void Actor::SetRotation(XMFLOAT3 newRotation)
-{
-    m_rotation = newRotation;
-    UpdateTransform();
-}
-
-XMFLOAT3 Actor::GetRotation()
-{
-    return m_rotation;
-}
-
-void Actor::Scale(XMFLOAT3 scale)
-{
-    m_scale = Add(m_scale, scale);
-    UpdateTransform();
-}
-
-void Actor::SetScale(XMFLOAT3 newScale)
-{
-    m_scale = newScale;
-    UpdateTransform();
-}
-
-XMFLOAT3 Actor::GetScale()
-{
-    return m_scale;
-}
-
-void Actor::Transform(XMFLOAT3 translation, XMFLOAT3 rotation, XMFLOAT3 scale)
-{
-    Translate(translation);
-    Rotate(rotation);
-    Scale(scale);
-    UpdateTransform();
-}
-
-void Actor::SetTransform(XMFLOAT3 newPosition, XMFLOAT3 newRotation, XMFLOAT3 newScale)
-{
-    SetPosition(newPosition);
-    SetRotation(newRotation);
-    SetScale(newScale);
-    UpdateTransform();
-}
-
-void Actor::SetTexture(Texture* texture)
-{
-    m_diffuseMap = texture;
-}
-
-#pragma endregion
-
-void Actor::UpdateTransform()
-{
-    XMMATRIX scale = XMMatrixScaling(m_scale.x, m_scale.y, m_scale.z);
-    XMMATRIX rotation = XMMatrixRotationRollPitchYaw(m_rotation.x, m_rotation.y, m_rotation.z);
-    XMMATRIX translation = XMMatrixTranslation(m_position.x, m_position.y, m_position.z);
-    XMStoreFloat4x4(&m_world, scale * rotation * translation); //calculate translation matrix and store _world
-}
-
-void Actor::Update()
-{
-
-}
-
-void Actor::Draw(ID3D11DeviceContext* immediateContext, ID3D11Buffer* constantBuffer, ConstantBuffer cb)
-{
-    UINT stride = sizeof(SimpleVertex);
-    UINT offset = 0;
-    //Load the pyramid's vertex and index buffers into the immediate context
-    immediateContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
-    immediateContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R16_UINT, 0);
-
-    //Binds textures
-    immediateContext->PSSetShaderResources(0, 1, &m_diffuseMap);
-    immediateContext->PSSetShaderResources(1, 1, &m_specularMap);
-
-    // Converts the XMFLOAT$X$ of the cube to an XMMATRIX
-    XMMATRIX world = XMLoadFloat4x4(&m_world);
-    // Transposes the matrix and copies it into the local constant buffer
-    cb.mWorld = XMMatrixTranspose(world);
-
-    //Materials:
-    // copies the rendered diffuse material into the constant buffer
-    cb.material.diffuse = m_material->diffuse;
-    cb.material.ambient = m_material->ambient;
-    cb.material.specular = m_material->specular;
-    cb.material.specularFalloff = m_material->specularFalloff;
-
-    // Set vertex buffer
-    immediateContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
-
-    // Set index buffer
-    immediateContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R16_UINT, 0);
-
-
-    /*Copies the local constant buffer into the constant buffer on the GPU. UpdateSubresource(  a pointer to the destination resource,
-                                                                                                    a zero based index that identifies the destination subresource,
-                                                                                                    A box that defines the portion of the destination subresource to copy the resource data into. If NULL, the data is written to the destination subresource with no offset,
-                                                                                                    A pointer to the source data memory,
-                                                                                                    the size of one depth slice of source data  )*/
-    immediateContext->UpdateSubresource(constantBuffer, 0, nullptr, &cb, 0, 0);
-
-    //
-    // Renders a triangle
-    //
-
-    //Draws the object with the new world matrix
-    immediateContext->DrawIndexed(m_indexCount, 0, 0);    //Draws the shape, total indices,starting index, starting vertex   
-}
-
-XMFLOAT3 Actor::Add(XMFLOAT3 a, XMFLOAT3 b)
-{
-    return XMFLOAT3(a.x + b.y, a.y + b.y, a.z + b.z);
-}
+#include "Actor.h"
+
+Actor::Actor(Mesh* mesh, Material* material, Texture* diffuseMap, Texture* specularMap, XMFLOAT3 position, XMFLOAT3 rotation, XMFLOAT3 scale, bool cullBackfaces)
+{ 
+
+    m_mesh = mesh;
+    m_cullBackfaces = cullBackfaces;
+    m_material = material;
+    m_diffuseMap = diffuseMap;
+    m_specularMap = specularMap;
+
+    //Load vertex and index buffers from the mesh passed in. A pooled mesh has none of its own, see Draw
+    m_indexBuffer = m_mesh->IndexBuffer;
+    m_indexFormat = m_mesh->IndexFormat;
+    m_vertexBuffer = m_mesh->VertexBuffer;
+    m_vertexFormat = m_mesh->Format;
+    m_vertexStride = m_mesh->VBStride;
+
+    //Every submesh is drawn with the actor's own material and textures until the level says otherwise
+    m_submeshSurfaces.assign(m_mesh->Submeshes.size(), { nullptr, nullptr, nullptr });
+
+    //Set default translation matrices
+    XMStoreFloat4x4(&m_world, XMMatrixIdentity());
+
+    m_position = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    m_rotation = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    m_scale = XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+    SetTransform(position, rotation, scale);
+}
+
+Actor::~Actor()
+{
+    //The buffers belong to the mesh, which other actors may share, so MeshCache releases them
+}
+
+#pragma region Translation
+
+void Actor::Translate(XMFLOAT3 translation)
+{
+    m_position = Add(m_position, translation);
+    UpdateTransform();
+}
+
+void Actor::SetPosition(XMFLOAT3 newPosition)
+{
+    m_position = newPosition;
+    UpdateTransform();
+}
+
+XMFLOAT3 Actor::GetPosition()
+{
+    return m_position;
+}
+
+void Actor::Rotate(XMFLOAT3 rotation)
+{
+    m_rotation = Add(m_rotation, rotation);
+    UpdateTransform();
+}
+
+void Actor::SetRotation(XMFLOAT3 newRotation)
+{
+    m_rotation = newRotation;
+    UpdateTransform();
+}
+
+XMFLOAT3 Actor::GetRotation()
+{
+    return m_rotation;
+}
+
+void Actor::Scale(XMFLOAT3 scale)
+{
+    m_scale = Add(m_scale, scale);
+    UpdateTransform();
+}
+
+void Actor::SetScale(XMFLOAT3 newScale)
+{
+    m_scale = newScale;
+    UpdateTransform();
+}
+
+XMFLOAT3 Actor::GetScale()
+{
+    return m_scale;
+}
+
+void Actor::Transform(XMFLOAT3 translation, XMFLOAT3 rotation, XMFLOAT3 scale)
+{
+    Translate(translation);
+    Rotate(rotation);
+    Scale(scale);
+    UpdateTransform();
+}
+
+void Actor::SetTransform(XMFLOAT3 newPosition, XMFLOAT3 newRotation, XMFLOAT3 newScale)
+{
+    SetPosition(newPosition);
+    SetRotation(newRotation);
+    SetScale(newScale);
+    UpdateTransform();
+}
+
+void Actor::SetTexture(Texture* texture)
+{
+    m_diffuseMap = texture;
+}
+
+bool Actor::SetSubmeshSurface(const std::string& materialName, Material* material, Texture* diffuseMap, Texture* specularMap)
+{
+    for (size_t i = 0; i < m_mesh->Submeshes.size(); i++)
+    {
+        if (m_mesh->Submeshes[i].GetMaterialName() == materialName)
+        {
+            m_submeshSurfaces[i] = { material, diffuseMap, specularMap };
+            return true;
+        }
+    }
+    return false;
+}
+
+VertexFormat Actor::GetVertexFormat()
+{
+    return m_vertexFormat;
+}
+
+bool Actor::IsPooled()
+{
+    return m_mesh->Pool != nullptr;
+}
+
+const MeshBounds& Actor::GetWorldBounds()
+{
+    return m_worldBounds;
+}
+
+#pragma endregion
+
+void Actor::UpdateTransform()
+{
+    XMMATRIX scale = XMMatrixScaling(m_scale.x, m_scale.y, m_scale.z);
+    XMMATRIX rotation = XMMatrixRotationRollPitchYaw(m_rotation.x, m_rotation.y, m_rotation.z);
+    XMMATRIX translation = XMMatrixTranslation(m_position.x, m_position.y, m_position.z);
+    XMStoreFloat4x4(&m_world, scale * rotation * translation); //calculate translation matrix and store _world
+    m_worldBounds = Bounds::Transform(m_mesh->Bounds, m_world);
+}
+
+void Actor::Update()
+{
+
+}
+
+void Actor::Draw(ID3D11DeviceContext* immediateContext, ID3D11Buffer* constantBuffer, ConstantBuffer cb, const XMFLOAT4X4& viewProjection, float pixelScale)
+{
+    //Binds textures
+    immediateContext->PSSetShaderResources(0, 1, &m_diffuseMap->View);
+    immediateContext->PSSetShaderResources(1, 1, &m_specularMap->View);
+
+    // Converts the XMFLOAT$X$ of the cube to an XMMATRIX
+    XMMATRIX world = XMLoadFloat4x4(&m_world);
+    // Transposes the matrix and copies it into the local constant buffer
+    cb.mWorld = XMMatrixTranspose(world);
+
+    // Lets the vertex shader turn compact positions back into model space
+    const VertexQuantization& quantization = m_mesh->Quantization;
+    cb.PositionOffset = XMFLOAT4(quantization.PositionOffset[0], quantization.PositionOffset[1], quantization.PositionOffset[2], 0.0f);
+    cb.PositionScale = XMFLOAT4(quantization.PositionScale[0], quantization.PositionScale[1], quantization.PositionScale[2], 0.0f);
+
+    //Materials:
+    // copies the rendered diffuse material into the constant buffer
+    cb.material.diffuse = m_material->diffuse;
+    cb.material.ambient = m_material->ambient;
+    cb.material.specular = m_material->specular;
+    cb.material.specularFalloff = m_material->specularFalloff;
+
+    //A pooled mesh shares its buffers with every other mesh of its formats, so they're only bound if the last actor drawn used different ones,
+    //and its ranges of them are drawn from its start index and base vertex
+    UINT startIndex = 0;
+    INT baseVertex = 0;
+    if (m_mesh->Pool)
+    {
+        m_mesh->Pool->Bind(immediateContext, m_mesh->Geometry);
+        startIndex = m_mesh->Pool->GetStartIndex(m_mesh->Geometry);
+        baseVertex = m_mesh->Pool->GetBaseVertex(m_mesh->Geometry);
+    }
+    else
+    {
+        UINT stride = m_vertexStride;
+        UINT offset = 0;
+
+        // Set vertex buffer
+        immediateContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
+
+        // Set index buffer
+        immediateContext->IASetIndexBuffer(m_indexBuffer, m_indexFormat, 0);
+    }
+
+
+    /*Copies the local constant buffer into the constant buffer on the GPU. UpdateSubresource(  a pointer to the destination resource,
+                                                                                                    a zero based index that identifies the destination subresource,
+                                                                                                    A box that defines the portion of the destination subresource to copy the resource data into. If NULL, the data is written to the destination subresource with no offset,
+                                                                                                    A pointer to the source data memory,
+                                                                                                    the size of one depth slice of source data  )*/
+    immediateContext->UpdateSubresource(constantBuffer, 0, nullptr, &cb, 0, 0);
+
+    //
+    // Renders a triangle
+    //
+
+    //Far enough away, a lower level of detail looks the same. Its error is in model units, so the distance is scaled into them too.
+    //The distance is to the middle of the mesh rather than its origin, which may be nowhere near it
+    XMFLOAT3 eye = XMFLOAT3(cb.EyeWorldPos.x, cb.EyeWorldPos.y, cb.EyeWorldPos.z);
+    XMFLOAT3 center = XMFLOAT3(m_worldBounds.Center[0], m_worldBounds.Center[1], m_worldBounds.Center[2]);
+    float scale = fmaxf(fabsf(m_scale.x), fmaxf(fabsf(m_scale.y), fabsf(m_scale.z)));
+    float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&eye), XMLoadFloat3(&center))));
+
+    //Cull the meshlets in model space, so only the camera has to be transformed
+    MeshletCullingView view = Meshlets::CreateCullingView(m_world, viewProjection, eye, m_cullBackfaces);
+
+    //Every submesh shares the buffers bound above, so each only costs its own draw calls, and a constant buffer update if it has its own material
+    Material* boundMaterial = m_material;
+    Texture* boundDiffuseMap = m_diffuseMap;
+    Texture* boundSpecularMap = m_specularMap;
+    for (size_t i = 0; i < m_mesh->Submeshes.size(); i++)
+    {
+        const Submesh& submesh = m_mesh->Submeshes[i];
+        const SubmeshSurface& surface = m_submeshSurfaces[i];
+
+        Texture* diffuseMap = surface.diffuseMap ? surface.diffuseMap : m_diffuseMap;
+        Texture* specularMap = surface.specularMap ? surface.specularMap : m_specularMap;
+        if (diffuseMap != boundDiffuseMap || specularMap != boundSpecularMap)
+        {
+            immediateContext->PSSetShaderResources(0, 1, &diffuseMap->View);
+            immediateContext->PSSetShaderResources(1, 1, &specularMap->View);
+            boundDiffuseMap = diffuseMap;
+            boundSpecularMap = specularMap;
+        }
+
+        Material* material = surface.material ? surface.material : m_material;
+        if (material != boundMaterial)
+        {
+            cb.material.diffuse = material->diffuse;
+            cb.material.ambient = material->ambient;
+            cb.material.specular = material->specular;
+            cb.material.specularFalloff = material->specularFalloff;
+            immediateContext->UpdateSubresource(constantBuffer, 0, nullptr, &cb, 0, 0);
+            boundMaterial = material;
+        }
+
+        unsigned int lod = scale > 0.0f ? Simplifier::SelectLod(m_mesh->Lods.data() + submesh.LodStart, submesh.LodCount, distance / scale, pixelScale) : 0;
+        if (lod != 0)
+        {
+            const MeshLod& level = m_mesh->Lods[submesh.LodStart + lod];
+            immediateContext->DrawIndexed(level.IndexCount, startIndex + level.IndexStart, baseVertex);    //Draws the simplified shape, total indices, starting index, starting vertex
+            continue;
+        }
+
+        //A submesh without meshlets is drawn whole
+        if (submesh.MeshletCount == 0)
+        {
+            immediateContext->DrawIndexed(submesh.IndexCount, startIndex + submesh.IndexStart, baseVertex);    //Draws the shape, total indices, starting index, starting vertex
+            continue;
+        }
+
+        //Neighbouring visible meshlets share a draw call
+        Meshlets::Cull(m_mesh->Meshlets.data() + submesh.MeshletStart, submesh.MeshletCount, view, m_drawRanges);
+        for (const MeshletDrawRange& range : m_drawRanges)
+        {
+            immediateContext->DrawIndexed(range.IndexCount, startIndex + range.IndexStart, baseVertex);    //Draws the visible part of the shape, indices in the range, starting index, starting vertex
+        }
+    }
+}
+
+void Actor::RequireTextures(TextureLoader* textureLoader, XMFLOAT3 eye, float pixelScale)
+{
+    //The nearest the surface can come is the near side of the bounding sphere. From inside it, it could be right in front of the camera
+    XMFLOAT3 center = XMFLOAT3(m_worldBounds.Center[0], m_worldBounds.Center[1], m_worldBounds.Center[2]);
+    float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&eye), XMLoadFloat3(&center))));
+    distance = fmaxf(distance - m_worldBounds.Radius, 0.0f);
+
+    //Scaling the actor up spreads its texture coordinates over more of the world
+    float scale = fmaxf(fabsf(m_scale.x), fmaxf(fabsf(m_scale.y), fabsf(m_scale.z)));
+    if (scale <= 0.0f)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < m_mesh->Submeshes.size(); i++)
+    {
+        const SubmeshSurface& surface = m_submeshSurfaces[i];
+        float density = m_mesh->Submeshes[i].GetTexCoordDensity() / scale;
+        textureLoader->Require(surface.diffuseMap ? surface.diffuseMap : m_diffuseMap, density, distance, pixelScale);
+        textureLoader->Require(surface.specularMap ? surface.specularMap : m_specularMap, density, distance, pixelScale);
+    }
+}
+
+XMFLOAT3 Actor::Add(XMFLOAT3 a, XMFLOAT3 b)
+{
+    return XMFLOAT3(a.x + b.y, a.y + b.y, a.z + b.z);
+}
@@ -1,103 +1,146 @@
-#pragma once
-#include <DirectXMath.h>
-#include <d3d11_1.h>
-#include <vector>
-
-#include "Loading.h"
-
-#include "Materials.h"
-#include "Vertices.h"
-#include "Buffers.h"
-#include "Normals.h"
-
-using namespace DirectX;
-
-/// <summary><para>Stores all the information about an object: <br/>
-///  - indices, a vector of words containing the indices <br/>
-///  - vertices, a vector SimpleVertex, which contain the local position and the normal of each vertex <br/>
-///  - ID3D11Buffer* pointers to vertex, and index buffers <br/>
-///  - An XMFLOAT4X4 4 by 4 matrix containing the world transforms of the object <br/>
-/// </para></summary>
-class Actor
-{
-protected:
-	/// <summary>An XMFLOAT4X4 4 by 4 matrix containing the world transforms of the object</summary>
-	XMFLOAT4X4 m_world;
-
-	/// <summary>ID3D11Buffer* pointer to vertex buffer</summary>
-	ID3D11Buffer* m_vertexBuffer;
-	/// <summary>ID3D11Buffer* pointer to index buffer</summary>
-	ID3D11Buffer* m_indexBuffer;
-
-	/// <summary>vertices, a vector SimpleVertex, which contain the local position and the normal of each vertex</summary>
-	std::vector<SimpleVertex> m_vertices;
-	/// <summary>indices, a vector of words containing the indices</summary>
-	std::vector<WORD> m_indices;
-	int m_indexCount;
-
-	XMFLOAT3 m_position;
-	XMFLOAT3 m_rotation;
-	XMFLOAT3 m_scale;
-
-	/// <summary>The objects model data</summary>
-	Mesh* m_mesh;
-	/// <summary>The Objects texture</summary>
-	Texture* m_diffuseMap;
-	/// <summary>The objects specular map. Leave blank to use the material's specular instead</summary>
-	Texture* m_specularMap;
-	/// <summary>The objects specular, ambient and diffuse</summary>
-	Material* m_material;
-
-public:
-	Actor(Mesh* mesh, Material* material, Texture* diffuseMap, Texture* specularMap, XMFLOAT3 position, XMFLOAT3 rotation, XMFLOAT3 scale);
-	~Actor();
-
-	#pragma region Translation
-
-	/// <param name="translation">Translation vector (xyz) to translate the object by</param>
-	void Translate(XMFLOAT3 translation);
-
-	/// <param name="newPosition">The objects new (x, y, z) position</param>
-	void SetPosition(XMFLOAT3 newPosition);
-
-	XMFLOAT3 GetPosition();
-
-	/// <param name="rotation"><para>X: Rotation around X (pitch)</para><para>Y: Rotation around Y (yaw)</para><para>Z: Rotation around Z (roll)</para></param>
-	void Rotate(XMFLOAT3 rotation);
-
-	/// <param name="newRotation"><para>X: New Rotation around X (pitch)</para><para>Y: New Rotation around Y (yaw)</para><para>Z: New Rotation around Z (roll)</para></param>
-	void SetRotation(XMFLOAT3 newRotation);
-
-	XMFLOAT3 GetRotation();
-
-	/// <param name="scale">The (xyz) to scale the object by</param>
-	void Scale(XMFLOAT3 scale);
-
-	/// <param name="newScale">The objects new (xyz) scale</param>
-	void SetScale(XMFLOAT3 newScale);
-
-	XMFLOAT3 GetScale();
-
-	/// <param name="translation">Translation vector (x, y, z) to translate the object by</param>
-	/// <param name="rotation">Rotation vector (pitch/around x, yaw/around y, roll/around z) to rotate the object by</param>
-	/// <param name="scale">Scaling vector (x, y, z) to scale the object by</param>
-	void Transform(XMFLOAT3 translation, XMFLOAT3 rotation, XMFLOAT3 scale);
-
-	/// <param name="newPosition">The objects new position (x, y, z)</param>
-	/// <param name="newRotation">The objects new rotation (pitch/around x, yaw/around y, roll/around z)</param>
-	/// <param name="newScale">The objects new scale (x, y, z)</param>
-	void SetTransform(XMFLOAT3 newPosition, XMFLOAT3 newRotation, XMFLOAT3 newScale);
-
-	void SetTexture(Texture* texture);
-
-private:
-	void UpdateTransform();
-
-	#pragma endregion
-
-public:
-	void Update();
-	void Draw(ID3D11DeviceContext* immediateContext, ID3D11Buffer* constantBuffer, ConstantBuffer cb);
-private:
-	XMFLOAT3 Add(XMFLOAT3 a, XMFLOAT3 b);
-};
+#pragma once
+#include <DirectXMath.h>
+#include <d3d11_1.h>
+#include <vector>
+
+#include "Loading.h"
+#include "TextureLoader.h"
+
+#include "Materials.h"
+#include "Vertices.h"
+#include "Buffers.h"
+#include "Normals.h"
+
+using namespace DirectX;
+
+/// <summary>What one of an actor's submeshes is drawn with. Anything left null is drawn with the actor's own</summary>
+struct SubmeshSurface
+{
+	Material* material;
+	Texture* diffuseMap;
+	Texture* specularMap;
+};
+
+/// <summary><para>Stores all the information about an object: <br/>
+///  - indices, a vector of words containing the indices <br/>
+///  - vertices, a vector SimpleVertex, which contain the local position and the normal of each vertex <br/>
+///  - ID3D11Buffer* pointers to vertex, and index buffers <br/>
+///  - An XMFLOAT4X4 4 by 4 matrix containing the world transforms of the object <br/>
+/// </para></summary>
+class Actor
+{
+protected:
+	/// <summary>An XMFLOAT4X4 4 by 4 matrix containing the world transforms of the object</summary>
+	XMFLOAT4X4 m_world;
+
+	/// <summary>ID3D11Buffer* pointer to vertex buffer</summary>
+	ID3D11Buffer* m_vertexBuffer;
+	/// <summary>ID3D11Buffer* pointer to index buffer</summary>
+	ID3D11Buffer* m_indexBuffer;
+
+	/// <summary>vertices, a vector SimpleVertex, which contain the local position and the normal of each vertex</summary>
+	std::vector<SimpleVertex> m_vertices;
+	/// <summary>indices, a vector of words containing the indices</summary>
+	std::vector<WORD> m_indices;
+	/// <summary>Whether the index buffer holds 16 or 32 bit indices</summary>
+	DXGI_FORMAT m_indexFormat;
+	/// <summary>The format of the vertex buffer, which decides which vertex shader draws it</summary>
+	VertexFormat m_vertexFormat;
+	UINT m_vertexStride;
+	/// <summary>The parts of the index buffer left to draw after culling the mesh's meshlets, kept so it isn't reallocated every frame</summary>
+	std::vector<MeshletDrawRange> m_drawRanges;
+
+	XMFLOAT3 m_position;
+	XMFLOAT3 m_rotation;
+	XMFLOAT3 m_scale;
+	/// <summary>The mesh's bounds moved into world space, kept up to date with m_world</summary>
+	MeshBounds m_worldBounds;
+
+	/// <summary>The objects model data</summary>
+	Mesh* m_mesh;
+	/// <summary>Whether meshlets facing away from the camera are culled, which is only safe if the level says the mesh is closed. Kept on the actor
+	/// rather than the mesh, as level entries that disagree about it still share one mesh</summary>
+	bool m_cullBackfaces;
+	/// <summary>The Objects texture</summary>
+	Texture* m_diffuseMap;
+	/// <summary>The objects specular map. Leave blank to use the material's specular instead</summary>
+	Texture* m_specularMap;
+	/// <summary>The objects specular, ambient and diffuse</summary>
+	Material* m_material;
+	/// <summary>What each of the mesh's submeshes is drawn with, in the same order</summary>
+	std::vector<SubmeshSurface> m_submeshSurfaces;
+
+public:
+	Actor(Mesh* mesh, Material* material, Texture* diffuseMap, Texture* specularMap, XMFLOAT3 position, XMFLOAT3 rotation, XMFLOAT3 scale, bool cullBackfaces);
+	~Actor();
+
+	#pragma region Translation
+
+	/// <param name="translation">Translation vector (xyz) to translate the object by</param>
+	void Translate(XMFLOAT3 translation);
+
+	/// <param name="newPosition">The objects new (x, y, z) position</param>
+	void SetPosition(XMFLOAT3 newPosition);
+
+	XMFLOAT3 GetPosition();
+
+	/// <param name="rotation"><para>X: Rotation around X (pitch)</para><para>Y: Rotation around Y (yaw)</para><para>Z: Rotation around Z (roll)</para></param>
+	void Rotate(XMFLOAT3 rotation);
+
+	/// <param name="newRotation"><para>X: New Rotation around X (pitch)</para><para>Y: New Rotation around Y (yaw)</para><para>Z: New Rotation around Z (roll)</para></param>
+	void SetRotation(XMFLOAT3 newRotation);
+
+	XMFLOAT3 GetRotation();
+
+	/// <param name="scale">The (xyz) to scale the object by</param>
+	void Scale(XMFLOAT3 scale);
+
+	/// <param name="newScale">The objects new (xyz) scale</param>
+	void SetScale(XMFLOAT3 newScale);
+
+	XMFLOAT3 GetScale();
+
+	/// <param name="translation">Translation vector (x, y, z) to translate the object by</param>
+	/// <param name="rotation">Rotation vector (pitch/around x, yaw/around y, roll/around z) to rotate the object by</param>
+	/// <param name="scale">Scaling vector (x, y, z) to scale the object by</param>
+	void Transform(XMFLOAT3 translation, XMFLOAT3 rotation, XMFLOAT3 scale);
+
+	/// <param name="newPosition">The objects new position (x, y, z)</param>
+	/// <param name="newRotation">The objects new rotation (pitch/around x, yaw/around y, roll/around z)</param>
+	/// <param name="newScale">The objects new scale (x, y, z)</param>
+	void SetTransform(XMFLOAT3 newPosition, XMFLOAT3 newRotation, XMFLOAT3 newScale);
+
+	void SetTexture(Texture* texture);
+
+	/// <summary>Draws the submesh whose .obj material is materialName with its own material and textures. Pass null for any the actor's own should be used for</summary>
+	/// <returns>false if the mesh has no submesh with that material</returns>
+	bool SetSubmeshSurface(const std::string& materialName, Material* material, Texture* diffuseMap, Texture* specularMap);
+
+	VertexFormat GetVertexFormat();
+	/// <summary>Whether the mesh's geometry is in a GeometryPool. If not, Draw binds the mesh's own buffers, which the pool doesn't know about</summary>
+	bool IsPooled();
+
+	/// <summary>The box and sphere around the actor in world space, which grow and move with its transform</summary>
+	const MeshBounds& GetWorldBounds();
+
+private:
+	void UpdateTransform();
+
+	#pragma endregion
+
+public:
+	void Update();
+	/// <summary>Draws each submesh of the actor's mesh, at the coarsest level of detail that looks the same from the camera, or as the meshlets of its
+	/// full detail triangles that the camera can see. The buffers are bound once for every submesh, and not at all if the mesh is pooled and the last actor
+	/// drawn used the same pool buffers</summary>
+	/// <param name="cb">The constant buffer for the frame, with the camera's eye position in it</param>
+	/// <param name="viewProjection">The camera's view matrix multiplied by its projection matrix, to cull meshlets with</param>
+	/// <param name="pixelScale">The camera's Camera::GetPixelScale, to pick the level of detail with</param>
+	void Draw(ID3D11DeviceContext* immediateContext, ID3D11Buffer* constantBuffer, ConstantBuffer cb, const XMFLOAT4X4& viewProjection, float pixelScale);
+	/// <summary>Tells the texture loader how much detail each submesh's textures need from where the camera is, from how densely the submesh's
+	/// texture coordinates are spread over it and how near the actor's bounding sphere comes, see TextureLoader::Require</summary>
+	/// <param name="pixelScale">The camera's Camera::GetPixelScale</param>
+	void RequireTextures(TextureLoader* textureLoader, XMFLOAT3 eye, float pixelScale);
+private:
+	XMFLOAT3 Add(XMFLOAT3 a, XMFLOAT3 b);
+};
@@ -1,77 +1,77 @@
-#pragma once
-
-#include <windows.h>
-#include <d3d11_1.h>
-#include <d3dcompiler.h>
-#include <directxmath.h>
-#include <directxcolors.h>
-#include "resource.h"
-
-#include "Keyboard.h"
-#include "Mouse.h"
-
-#include "Level.h"
-
-
-using namespace DirectX;
-
-class Application
-{
-private:
-	HINSTANCE               _hInst;
-	HWND                    _hWnd;
-	D3D_DRIVER_TYPE         _driverType;
-	D3D_FEATURE_LEVEL       _featureLevel;
-	ID3D11Device*           _pd3dDevice;
-	ID3D11DeviceContext*    _pImmediateContext;
-	IDXGISwapChain*         _pSwapChain;
-	ID3D11RenderTargetView* _pRenderTargetView;
-	/// <summary> Holds the texture sampler, passed across to texture shader for use</summary>
-	ID3D11SamplerState*		_pSamplerLinear;
-	ID3D11VertexShader*     _pVertexShader;
-	ID3D11PixelShader*      _pPixelShader;
-	/// <summary>A rasterizer state used to draw objects as wireframe.</summary>
-	ID3D11RasterizerState*	_wireFrame;
-	/// <summary>A rasterizer state used to draw in block, solid fill.</summary>
-	ID3D11RasterizerState*	_solidFill;
-	/// <summary>Used to track the current rasterizer state when switching between cube and wireframe.</summary>
-	ID3D11RasterizerState*	_currentRasterizerState;
-	ID3D11InputLayout*      _pVertexLayout;
-	ID3D11Buffer*			_pVertexBuffer;
-	ID3D11Buffer*			_pIndexBuffer;
-	ID3D11Buffer*           _pConstantBuffer;
-	/// <summary>Interface Used to store the depth/stencil view</summary>
-	ID3D11DepthStencilView*	_depthStencilView;
-	/// <summary>Interface Used to store the depth/stencil buffer</summary>
-	ID3D11Texture2D*		_depthStencilBuffer;
-
-	std::unique_ptr<DirectX::Keyboard> _keyboard;
-	std::unique_ptr<DirectX::Mouse> _mouse;
-	DirectX::Keyboard::KeyboardStateTracker _keys;
-	DirectX::Mouse::ButtonStateTracker _mouseButtons;
-	XMFLOAT2 _mousePosition;
-
-	Level* _level;
-
-private:
-	HRESULT InitWindow(HINSTANCE hInstance, int nCmdShow);
-	HRESULT InitDevice();
-	HRESULT InitShadersAndInputLayout();
-
-	void Cleanup();
-	
-	HRESULT CompileShaderFromFile(WCHAR* szFileName, LPCSTR szEntryPoint, LPCSTR szShaderModel, ID3DBlob** ppBlobOut);
-
-	UINT _WindowHeight;
-	UINT _WindowWidth;
-
-public:
-	Application();
-	~Application();
-
-	HRESULT Initialise(HINSTANCE hInstance, int nCmdShow);
-
-	void Update();
-	void Draw();
-};
-
+#pragma once
+
+#include <windows.h>
+#include <d3d11_1.h>
+#include <d3dcompiler.h>
+#include <directxmath.h>
+#include <directxcolors.h>
+#include "resource.h"
+
+#include "Keyboard.h"
+#include "Mouse.h"
+
+#include "Level.h"
+
+
+using namespace DirectX;
+
+class Application
+{
+private:
+	HINSTANCE               _hInst;
+	HWND                    _hWnd;
+	D3D_DRIVER_TYPE         _driverType;
+	D3D_FEATURE_LEVEL       _featureLevel;
+	ID3D11Device*           _pd3dDevice;
+	ID3D11DeviceContext*    _pImmediateContext;
+	IDXGISwapChain*         _pSwapChain;
+	ID3D11RenderTargetView* _pRenderTargetView;
+	/// <summary> Holds the texture sampler, passed across to texture shader for use</summary>
+	ID3D11SamplerState*		_pSamplerLinear;
+	/// <summary>A vertex shader and input layout for each vertex format, so each mesh can be drawn in whichever format it was loaded in</summary>
+	VertexShaderSet			_vertexShaders;
+	ID3D11PixelShader*      _pPixelShader;
+	/// <summary>A rasterizer state used to draw objects as wireframe.</summary>
+	ID3D11RasterizerState*	_wireFrame;
+	/// <summary>A rasterizer state used to draw in block, solid fill.</summary>
+	ID3D11RasterizerState*	_solidFill;
+	/// <summary>Used to track the current rasterizer state when switching between cube and wireframe.</summary>
+	ID3D11RasterizerState*	_currentRasterizerState;
+	ID3D11Buffer*			_pVertexBuffer;
+	ID3D11Buffer*			_pIndexBuffer;
+	ID3D11Buffer*           _pConstantBuffer;
+	/// <summary>Interface Used to store the depth/stencil view</summary>
+	ID3D11DepthStencilView*	_depthStencilView;
+	/// <summary>Interface Used to store the depth/stencil buffer</summary>
+	ID3D11Texture2D*		_depthStencilBuffer;
+
+	std::unique_ptr<DirectX::Keyboard> _keyboard;
+	std::unique_ptr<DirectX::Mouse> _mouse;
+	DirectX::Keyboard::KeyboardStateTracker _keys;
+	DirectX::Mouse::ButtonStateTracker _mouseButtons;
+	XMFLOAT2 _mousePosition;
+
+	Level* _level;
+
+private:
+	HRESULT InitWindow(HINSTANCE hInstance, int nCmdShow);
+	HRESULT InitDevice();
+	HRESULT InitShadersAndInputLayout();
+
+	void Cleanup();
+	
+	HRESULT CompileShaderFromFile(WCHAR* szFileName, LPCSTR szEntryPoint, LPCSTR szShaderModel, ID3DBlob** ppBlobOut);
+
+	UINT _WindowHeight;
+	UINT _WindowWidth;
+
+public:
+	Application();
+	~Application();
+
+	HRESULT Initialise(HINSTANCE hInstance, int nCmdShow);
+
+	void Update();
+	void Draw();
+};
+
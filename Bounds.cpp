@@ -0,0 +1,215 @@
+#include "Bounds.h"
+#include <cmath>
+
+namespace
+{
+	//How much each refinement shrinks the best sphere so far before regrowing it, 0.95 being 5% smaller
+	const float RefinementShrink = 0.95f;
+
+	//Grows a sphere just enough to take in a point, moving the centre towards the point so the far side of the old sphere stays on the new one
+	void GrowSphere(XMVECTOR& centre, float& radius, const XMFLOAT3& point)
+	{
+		XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&point), centre);
+		float distance = XMVectorGetX(XMVector3Length(offset));
+		if (distance > radius)
+		{
+			float grownRadius = (radius + distance) * 0.5f;
+			centre = XMVectorAdd(centre, XMVectorScale(offset, (grownRadius - radius) / distance));
+			radius = grownRadius;
+		}
+	}
+
+	size_t GreatestCommonDivisor(size_t a, size_t b)
+	{
+		while (b != 0)
+		{
+			size_t remainder = a % b;
+			a = b;
+			b = remainder;
+		}
+		return a;
+	}
+}
+
+void Bounds::BoundingSphere(const std::vector<XMFLOAT3>& points, XMFLOAT3& center, float& radius)
+{
+	size_t minimum[3] = { 0, 0, 0 };
+	size_t maximum[3] = { 0, 0, 0 };
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		const float* point = &points[i].x;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (point[axis] < (&points[minimum[axis]].x)[axis]) minimum[axis] = i;
+			if (point[axis] > (&points[maximum[axis]].x)[axis]) maximum[axis] = i;
+		}
+	}
+
+	XMVECTOR a = XMLoadFloat3(&points[minimum[0]]);
+	XMVECTOR b = XMLoadFloat3(&points[maximum[0]]);
+	float widest = -1.0f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		XMVECTOR low = XMLoadFloat3(&points[minimum[axis]]);
+		XMVECTOR high = XMLoadFloat3(&points[maximum[axis]]);
+		float distance = XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(high, low)));
+		if (distance > widest)
+		{
+			widest = distance;
+			a = low;
+			b = high;
+		}
+	}
+
+	XMVECTOR centre = XMVectorScale(XMVectorAdd(a, b), 0.5f);
+	radius = sqrtf(widest) * 0.5f;
+
+	for (const XMFLOAT3& point : points)
+	{
+		GrowSphere(centre, radius, point);
+	}
+
+	XMStoreFloat3(&center, centre);
+}
+
+MeshBounds Bounds::Compute(const std::vector<SimpleVertex>& vertices)
+{
+	std::vector<XMFLOAT3> points(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		points[i] = vertices[i].Pos;
+	}
+	return Compute(points);
+}
+
+MeshBounds Bounds::Compute(const std::vector<XMFLOAT3>& points)
+{
+	MeshBounds bounds = {};
+	if (points.empty())
+	{
+		return bounds;
+	}
+
+	XMVECTOR low = XMLoadFloat3(&points[0]);
+	XMVECTOR high = low;
+	for (const XMFLOAT3& point : points)
+	{
+		low = XMVectorMin(low, XMLoadFloat3(&point));
+		high = XMVectorMax(high, XMLoadFloat3(&point));
+	}
+	XMFLOAT3 minimum, maximum;
+	XMStoreFloat3(&minimum, low);
+	XMStoreFloat3(&maximum, high);
+
+	XMFLOAT3 center;
+	float radius;
+	BoundingSphere(points, center, radius);
+
+	//Ritter's sphere depends on the order it meets the points in, so shrink the best sphere so far and regrow it in a different order each time.
+	//Stepping through the points by a stride that shares no factor with their count visits every one, and is the same order every run
+	size_t count = points.size();
+	size_t stride = 7919;
+	while (GreatestCommonDivisor(stride, count) != 1)
+	{
+		stride++;
+	}
+	for (unsigned int refinement = 0; refinement < SphereRefinements; refinement++)
+	{
+		XMVECTOR centre = XMLoadFloat3(&center);
+		float shrunk = radius * RefinementShrink;
+		size_t start = count * refinement / SphereRefinements;
+		for (size_t i = 0; i < count; i++)
+		{
+			GrowSphere(centre, shrunk, points[(start + i * stride) % count]);
+		}
+
+		if (shrunk < radius)
+		{
+			XMStoreFloat3(&center, centre);
+			radius = shrunk;
+		}
+	}
+
+	//Boxy meshes like a cube have their corners furthest out, where the sphere through the box's corners is the smallest there is
+	XMVECTOR boxCentre = XMVectorScale(XMVectorAdd(low, high), 0.5f);
+	float boxRadius = 0.0f;
+	for (const XMFLOAT3& point : points)
+	{
+		boxRadius = fmaxf(boxRadius, XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&point), boxCentre))));
+	}
+	if (boxRadius < radius)
+	{
+		XMStoreFloat3(&center, boxCentre);
+		radius = boxRadius;
+	}
+
+	bounds.Min[0] = minimum.x; bounds.Min[1] = minimum.y; bounds.Min[2] = minimum.z;
+	bounds.Max[0] = maximum.x; bounds.Max[1] = maximum.y; bounds.Max[2] = maximum.z;
+	bounds.Center[0] = center.x; bounds.Center[1] = center.y; bounds.Center[2] = center.z;
+	bounds.Radius = radius;
+	return bounds;
+}
+
+void Bounds::MeasureSurface(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, size_t start, size_t count, float& modelArea, float& texCoordArea)
+{
+	//Summed in double, as a scan's triangles are tiny next to its whole surface
+	double model = 0.0;
+	double texCoords = 0.0;
+	size_t end = start + count < indices.size() ? start + count : indices.size();
+	for (size_t i = start; i + 3 <= end; i += 3)
+	{
+		const SimpleVertex& a = vertices[indices[i]];
+		const SimpleVertex& b = vertices[indices[i + 1]];
+		const SimpleVertex& c = vertices[indices[i + 2]];
+
+		XMVECTOR ab = XMVectorSubtract(XMLoadFloat3(&b.Pos), XMLoadFloat3(&a.Pos));
+		XMVECTOR ac = XMVectorSubtract(XMLoadFloat3(&c.Pos), XMLoadFloat3(&a.Pos));
+		model += 0.5 * XMVectorGetX(XMVector3Length(XMVector3Cross(ab, ac)));
+
+		float u1 = b.TexCoord.x - a.TexCoord.x;
+		float v1 = b.TexCoord.y - a.TexCoord.y;
+		float u2 = c.TexCoord.x - a.TexCoord.x;
+		float v2 = c.TexCoord.y - a.TexCoord.y;
+		texCoords += 0.5 * fabs((double)u1 * v2 - (double)u2 * v1);
+	}
+	modelArea = (float)model;
+	texCoordArea = (float)texCoords;
+}
+
+MeshBounds Bounds::Transform(const MeshBounds& bounds, const XMFLOAT4X4& world)
+{
+	//Arvo's method: each corner of the box is the translation plus every row of the matrix scaled by the box's min or max along that row's axis,
+	//so the new box's extremes come from picking the smaller or larger of each row's two contributions
+	MeshBounds transformed;
+	for (int column = 0; column < 3; column++)
+	{
+		float low = world.m[3][column];
+		float high = world.m[3][column];
+		for (int row = 0; row < 3; row++)
+		{
+			float a = world.m[row][column] * bounds.Min[row];
+			float b = world.m[row][column] * bounds.Max[row];
+			low += a < b ? a : b;
+			high += a < b ? b : a;
+		}
+		transformed.Min[column] = low;
+		transformed.Max[column] = high;
+	}
+
+	XMFLOAT3 center = XMFLOAT3(bounds.Center[0], bounds.Center[1], bounds.Center[2]);
+	XMMATRIX matrix = XMLoadFloat4x4(&world);
+	XMStoreFloat3(&center, XMVector3TransformCoord(XMLoadFloat3(&center), matrix));
+	transformed.Center[0] = center.x;
+	transformed.Center[1] = center.y;
+	transformed.Center[2] = center.z;
+
+	//Each of the first three rows is where one model space axis ends up, so the longest is the most the sphere can be stretched
+	float scale = 0.0f;
+	for (int row = 0; row < 3; row++)
+	{
+		float length = sqrtf(world.m[row][0] * world.m[row][0] + world.m[row][1] * world.m[row][1] + world.m[row][2] * world.m[row][2]);
+		if (length > scale) scale = length;
+	}
+	transformed.Radius = bounds.Radius * scale;
+	return transformed;
+}
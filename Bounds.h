@@ -0,0 +1,50 @@
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+
+#include "Vertices.h"
+
+using namespace DirectX;
+
+/// <summary><para>An axis-aligned box and a sphere that both contain every vertex of a mesh. </para>
+/// <para>Bounds are stored in binary meshes as they are, so every field is fixed width.</para></summary>
+struct MeshBounds
+{
+	/// <summary>The lowest x, y and z of any vertex</summary>
+	float Min[3];
+	/// <summary>The highest x, y and z of any vertex</summary>
+	float Max[3];
+	float Center[3];
+	/// <summary>0 for a mesh with a single vertex, or none</summary>
+	float Radius;
+};
+
+/// <summary>Works out how much space meshes and parts of meshes take up, so they can be culled and compared against the camera without reading their vertices</summary>
+namespace Bounds
+{
+	/// <summary>How many times Compute shrinks and regrows the sphere it starts with, looking for a smaller one</summary>
+	const unsigned int SphereRefinements = 8;
+
+	/// <summary><para>Ritter's bounding sphere: starts from the two points furthest apart along an axis, then grows the sphere to take in any point outside it. </para>
+	/// <para>Not the smallest sphere, but usually within a few percent of it, in a single pass over the points.</para></summary>
+	void BoundingSphere(const std::vector<XMFLOAT3>& points, XMFLOAT3& center, float& radius);
+
+	/// <summary><para>Finds the box and sphere around every vertex. </para>
+	/// <para>The sphere starts as BoundingSphere's, which is then shrunk and regrown over the points in a different order SphereRefinements times,
+	/// keeping the smallest sphere found. This is the iterative version of Ritter's from Ericson's "Real-Time Collision Detection".
+	/// The sphere centred on the box is used instead if it's smaller.</para></summary>
+	MeshBounds Compute(const std::vector<SimpleVertex>& vertices);
+	/// <summary>The same for bare positions, e.g. an .obj file's pool of them when its vertices are never all in memory at once</summary>
+	MeshBounds Compute(const std::vector<XMFLOAT3>& points);
+
+	/// <summary><para>Adds up the area of some triangles in model space, and the area they cover of their textures. </para>
+	/// <para>Together they say how much of a texture a unit of the surface shows, which is how much of the texture's detail it needs, see Submesh.</para></summary>
+	/// <param name="indices">count indices from start, three to a triangle</param>
+	void MeasureSurface(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, size_t start, size_t count, float& modelArea, float& texCoordArea);
+
+	/// <summary><para>Moves bounds into the space world puts them in, e.g. from an actor's model space into world space. </para>
+	/// <para>The box is the tightest axis-aligned box around the transformed one, so it grows as the mesh rotates. The sphere's radius is
+	/// scaled by the largest scale in world, so it stays around the mesh under non-uniform scaling.</para></summary>
+	/// <param name="world">A matrix made of scaling, rotation and translation, like Actor's world matrix</param>
+	MeshBounds Transform(const MeshBounds& bounds, const XMFLOAT4X4& world);
+};
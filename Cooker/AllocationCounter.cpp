@@ -0,0 +1,39 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<uint64_t> g_allocations(0);
+	std::atomic<uint64_t> g_allocatedBytes(0);
+
+	void* Allocate(size_t size)
+	{
+		g_allocations.fetch_add(1, std::memory_order_relaxed);
+		g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		void* memory = malloc(size != 0 ? size : 1);
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return memory;
+	}
+}
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+
+uint64_t AllocationCounter::GetAllocations()
+{
+	return g_allocations.load();
+}
+
+uint64_t AllocationCounter::GetAllocatedBytes()
+{
+	return g_allocatedBytes.load();
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+
+//Counts every heap allocation made through new, on any thread, so the allocations a piece of code makes can be counted by the difference across it.
+//Linking AllocationCounter.cpp into a program replaces its global operator new and delete, see CMakeLists.txt
+namespace AllocationCounter
+{
+	uint64_t GetAllocations();
+	uint64_t GetAllocatedBytes();
+}
@@ -0,0 +1,330 @@
+//The asset cooker: builds the binary caches for every mesh a level uses ahead of time, so the first launch of the game doesn't have to parse them.
+//It only uses the loading code that doesn't need Direct3D, so it builds on Linux as well as Windows, see CMakeLists.txt.
+//Run it from the directory the game runs from, as the paths in level files are relative to it:
+//	AssetCooker [--force] [--compress] [--budget MB] Levels/Level1.json [more levels...]
+#include "MappedFile.h"
+#include "MeshBinary.h"
+#include "OBJImporter.h"
+#include "OBJStreamImporter.h"
+#include "ThreadPool.h"
+#include "include/nlohmann/json.hpp"
+#include <algorithm>
+#include <chrono>		//For timing each asset
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace
+{
+	enum class AssetType
+	{
+		Mesh,
+		Texture,
+	};
+
+	enum class CookResult
+	{
+		Cooked,
+		UpToDate,
+		Failed,
+	};
+
+	struct Asset
+	{
+		AssetType Type;
+		std::string Path;
+		//The vertex format the level loads a mesh in, which is the one its cache has to be in
+		VertexFormat Format;
+		CookResult Result;
+		//Why a mesh needed cooking, or why an asset failed
+		std::string Note;
+		double Seconds;
+		uint64_t SourceSize;
+		uint64_t CookedSize;
+	};
+
+	struct CookOptions
+	{
+		//Cook every mesh even if its cache is up to date
+		bool Force;
+		MeshEncoding Encoding;
+		//The memory budget of each mesh big enough to be streamed, see OBJStreamImporter. Meshes are cooked in parallel, so several may stream at once
+		size_t StreamingBudget;
+	};
+
+	//"DDS " read as a little-endian uint32_t, followed by the size of the rest of the header
+	const uint32_t DDSMagic = 0x20534444;
+	const uint32_t DDSHeaderSize = 124;
+
+	//Adds an asset unless the same one is already there, as levels share models and textures
+	void AddAsset(std::vector<Asset>& assets, AssetType type, const std::string& path, VertexFormat format)
+	{
+		for (const Asset& asset : assets)
+		{
+			if (asset.Type == type && asset.Path == path && (type != AssetType::Mesh || asset.Format == format))
+			{
+				return;
+			}
+		}
+
+		Asset asset = {};
+		asset.Type = type;
+		asset.Path = path;
+		asset.Format = format;
+		assets.push_back(asset);
+	}
+
+	//Finds the meshes and textures a level uses, the same way Level::Load reads them
+	bool ReadLevel(const std::string& levelFilename, std::vector<Asset>& assets)
+	{
+		std::ifstream in(levelFilename);
+		if (!in.good())
+		{
+			fprintf(stderr, "%s: couldn't be opened\n", levelFilename.c_str());
+			return false;
+		}
+
+		try
+		{
+			json level;
+			in >> level;
+
+			for (const json& meshDesc : level.value("meshes", json::array()))
+			{
+				//Meshes are compact unless the level asks for full float vertices, as in Level::LoadMeshes
+				VertexFormat format = VertexFormat::Compact;
+				VertexFormats::FromName(meshDesc.value("vertexFormat", VertexFormats::GetName(format)), format);
+				AddAsset(assets, AssetType::Mesh, meshDesc["path"], format);
+			}
+			for (const json& textureDesc : level.value("textures", json::array()))
+			{
+				AddAsset(assets, AssetType::Texture, textureDesc["path"], VertexFormat::Compact);
+			}
+		}
+		catch (const json::exception& exception)
+		{
+			fprintf(stderr, "%s: %s\n", levelFilename.c_str(), exception.what());
+			return false;
+		}
+		return true;
+	}
+
+	void CookMesh(Asset& asset, const CookOptions& options)
+	{
+		MeshSourceInfo source;
+		if (!MeshBinary::GetSourceInfo(asset.Path, source, false))
+		{
+			asset.Result = CookResult::Failed;
+			asset.Note = "source missing";
+			return;
+		}
+		asset.SourceSize = source.Size;
+
+		//A cache the game would accept as it is doesn't need cooking, whichever encoding it's in
+		std::string binaryFilename = OBJImporter::GetBinaryFilename(asset.Path);
+		if (!options.Force)
+		{
+			MappedFile file;
+			std::vector<char> decoded;
+			MeshBinaryView view;
+			MeshBinaryStatus status = MeshBinary::Map(binaryFilename, asset.Path, asset.Format, file, decoded, view);
+			if (status == MeshBinaryStatus::Valid)
+			{
+				asset.Result = CookResult::UpToDate;
+				asset.CookedSize = file.GetSize();
+				return;
+			}
+			asset.Note = std::string("cache ") + MeshBinary::GetStatusName(status);
+		}
+
+		//Scans too big to import in memory are streamed straight into their cache, which is always raw
+		if (source.Size >= OBJStreamImporter::StreamingThreshold)
+		{
+			StreamingImportOptions streaming = OBJStreamImporter::GetDefaultOptions();
+			streaming.MemoryBudget = options.StreamingBudget;
+			streaming.Format = asset.Format;
+			StreamingImportStats stats;
+			if (!OBJStreamImporter::Import(asset.Path, binaryFilename, streaming, stats))
+			{
+				asset.Result = CookResult::Failed;
+				asset.Note = "couldn't be streamed";
+				return;
+			}
+
+			MappedFile file(binaryFilename);
+			asset.Result = CookResult::Cooked;
+			asset.Note = "streamed";
+			asset.CookedSize = file.GetSize();
+			return;
+		}
+
+		CookedMesh mesh;
+		if (!OBJImporter::Cook(asset.Path, mesh, true, asset.Format) || !MeshBinary::GetSourceInfo(asset.Path, source, true))
+		{
+			asset.Result = CookResult::Failed;
+			asset.Note = "couldn't be read";
+			return;
+		}
+		if (!MeshBinary::Write(binaryFilename, source, mesh.Contents, options.Encoding))
+		{
+			asset.Result = CookResult::Failed;
+			asset.Note = "cache couldn't be written";
+			return;
+		}
+
+		MappedFile file(binaryFilename);
+		asset.Result = CookResult::Cooked;
+		asset.CookedSize = file.GetSize();
+	}
+
+	//Textures are already DDS, which is what the game uploads, so there's nothing to cook. They're still checked, so a missing
+	//or broken texture is caught here rather than when the level loads
+	void CheckTexture(Asset& asset)
+	{
+		MappedFile file(asset.Path);
+		if (!file.IsOpen())
+		{
+			asset.Result = CookResult::Failed;
+			asset.Note = "source missing";
+			return;
+		}
+		asset.SourceSize = file.GetSize();
+		asset.CookedSize = file.GetSize();
+
+		uint32_t header[2] = {};
+		if (file.GetSize() >= sizeof(uint32_t) + DDSHeaderSize)
+		{
+			memcpy(header, file.GetData(), sizeof(header));
+		}
+		if (header[0] != DDSMagic || header[1] != DDSHeaderSize)
+		{
+			asset.Result = CookResult::Failed;
+			asset.Note = "not a DDS file";
+			return;
+		}
+		asset.Result = CookResult::UpToDate;
+	}
+
+	const char* GetResultName(CookResult result)
+	{
+		switch (result)
+		{
+		case CookResult::Cooked: return "cooked";
+		case CookResult::UpToDate: return "up to date";
+		case CookResult::Failed: return "FAILED";
+		}
+		return "unknown";
+	}
+
+	void PrintTable(const std::vector<Asset>& assets, double wallSeconds)
+	{
+		printf("%-8s %-11s %-8s %10s %12s %12s  %s\n", "type", "result", "format", "time (ms)", "source", "cache", "path");
+
+		size_t counts[3] = {};
+		double assetSeconds = 0.0;
+		for (const Asset& asset : assets)
+		{
+			bool mesh = asset.Type == AssetType::Mesh;
+			printf("%-8s %-11s %-8s %10.1f %12llu %12llu  %s%s%s%s\n", mesh ? "mesh" : "texture", GetResultName(asset.Result),
+				mesh ? VertexFormats::GetName(asset.Format) : "dds", asset.Seconds * 1000.0, (unsigned long long)asset.SourceSize,
+				(unsigned long long)asset.CookedSize, asset.Path.c_str(), asset.Note.empty() ? "" : " (", asset.Note.c_str(), asset.Note.empty() ? "" : ")");
+			counts[(int)asset.Result]++;
+			assetSeconds += asset.Seconds;
+		}
+
+		printf("%zu assets: %zu cooked, %zu up to date, %zu failed in %.1f ms, %.1f ms of work on %u threads\n", assets.size(),
+			counts[(int)CookResult::Cooked], counts[(int)CookResult::UpToDate], counts[(int)CookResult::Failed], wallSeconds * 1000.0,
+			assetSeconds * 1000.0, ThreadPool::GetShared().GetThreadCount());
+	}
+}
+
+int main(int argc, char** argv)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	CookOptions options = { false, MeshEncoding::Raw, OBJStreamImporter::DefaultMemoryBudget };
+	std::vector<std::string> levels;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--force") == 0)
+		{
+			options.Force = true;
+		}
+		else if (strcmp(argv[i], "--compress") == 0)
+		{
+			options.Encoding = MeshEncoding::Compressed;
+		}
+		else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+		{
+			options.StreamingBudget = (size_t)atoi(argv[++i]) * 1024 * 1024;
+		}
+		else
+		{
+			levels.push_back(argv[i]);
+		}
+	}
+	if (levels.empty())
+	{
+		fprintf(stderr, "usage: %s [--force] [--compress] [--budget MB] <level.json>...\n"
+			"  --force     cook every mesh, even if its cache is up to date\n"
+			"  --compress  write compressed caches, which the game decodes rather than loading straight from the mapping\n"
+			"  --budget    the memory each mesh of %llu MB or more may stream in, %zu MB by default\n", argv[0],
+			(unsigned long long)(OBJStreamImporter::StreamingThreshold / (1024 * 1024)), OBJStreamImporter::DefaultMemoryBudget / (1024 * 1024));
+		return 2;
+	}
+
+	std::vector<Asset> assets;
+	for (const std::string& level : levels)
+	{
+		if (!ReadLevel(level, assets))
+		{
+			return 1;
+		}
+	}
+
+	//Start the biggest sources first, so one large model isn't left cooking on its own at the end while every other thread is idle
+	std::vector<size_t> order(assets.size());
+	std::vector<uint64_t> sizes(assets.size());
+	std::iota(order.begin(), order.end(), 0);
+	for (size_t i = 0; i < assets.size(); i++)
+	{
+		MeshSourceInfo source;
+		sizes[i] = MeshBinary::GetSourceInfo(assets[i].Path, source, false) ? source.Size : 0;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+	//Each model's import also spreads its parsing over the shared pool, which ParallelFor allows from inside its own items
+	Clock::time_point start = Clock::now();
+	ThreadPool::GetShared().ParallelFor(assets.size(), [&](size_t i)
+	{
+		Asset& asset = assets[order[i]];
+		Clock::time_point assetStart = Clock::now();
+		if (asset.Type == AssetType::Mesh)
+		{
+			CookMesh(asset, options);
+		}
+		else
+		{
+			CheckTexture(asset);
+		}
+		asset.Seconds = std::chrono::duration<double>(Clock::now() - assetStart).count();
+	});
+	double wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	PrintTable(assets, wallSeconds);
+
+	for (const Asset& asset : assets)
+	{
+		if (asset.Result == CookResult::Failed)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,537 @@
+//The import benchmark: times each stage of importing every .obj file under a directory, by default Models/, and reports throughput,
+//peak memory and heap allocations per stage as a table and as JSON. Builds alongside the asset cooker, without Direct3D, see CMakeLists.txt.
+//	ImportBenchmark [--iterations N] [--json file] [--compress] [directory]
+//With --streaming it instead checks OBJStreamImporter stays within a memory budget, by importing a generated scan a few times bigger than it.
+//	ImportBenchmark --streaming MB
+//With --allocator it instead churns the geometry pool's allocator through N allocations and frees and reports how fragmented it gets.
+//	ImportBenchmark --allocator N
+#include "AllocationCounter.h"
+#include "GeometryAllocator.h"
+#include "MappedFile.h"
+#include "MeshBinary.h"
+#include "OBJImporter.h"
+#include "OBJStreamImporter.h"
+#include "ThreadPool.h"
+#include "include/nlohmann/json.hpp"
+#include <algorithm>
+#include <chrono>		//For timing each stage
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif !defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	enum Stage
+	{
+		//OBJParser::ParseFile, from the text to the pools and index lists. Bytes are the file's, vertices are its positions
+		Tokenize,
+		//OBJImporter::ExpandVertices, from the pools to one position, normal and texture coordinate per face corner. Bytes and vertices are those written
+		Expand,
+		//OBJImporter::CreateIndices, welding the corners into vertices and an index buffer. Bytes and vertices are the corners read
+		Weld,
+		//MeshBinary::Write of the cooked mesh. Bytes are the file's, vertices are the cooked mesh's
+		Write,
+		//MeshBinary::Map of the file just written, with it in the page cache. Bytes are the file's, vertices are the cooked mesh's
+		Read,
+		StageCount,
+	};
+	const char* StageNames[StageCount] = { "tokenize", "expand", "CreateIndices", "binary write", "binary read" };
+
+	struct StageResult
+	{
+		//The fastest of every iteration
+		double Seconds;
+		uint64_t Bytes;
+		uint64_t Vertices;
+		//Made by one iteration, which are all the same
+		uint64_t Allocations;
+		uint64_t AllocatedBytes;
+		//The most memory the process had resident during the stage, the highest of every iteration
+		uint64_t PeakRSS;
+	};
+
+	struct ModelResult
+	{
+		std::string Path;
+		StageResult Stages[StageCount];
+	};
+
+	//Resets the process's peak resident size, so each stage's peak is its own rather than the largest of everything run before it.
+	//Only Linux can do this, elsewhere the peak is the process's so far
+	void ResetPeakRSS()
+	{
+#ifdef __linux__
+		FILE* file = fopen("/proc/self/clear_refs", "w");
+		if (file != nullptr)
+		{
+			fputs("5", file);
+			fclose(file);
+		}
+#endif
+	}
+
+	uint64_t GetPeakRSS()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+#elif defined(__linux__)
+		uint64_t peak = 0;
+		FILE* file = fopen("/proc/self/status", "r");
+		if (file != nullptr)
+		{
+			char line[256];
+			while (fgets(line, sizeof(line), file) != nullptr)
+			{
+				unsigned long long kilobytes;
+				if (sscanf(line, "VmHWM: %llu kB", &kilobytes) == 1)
+				{
+					peak = kilobytes * 1024;
+					break;
+				}
+			}
+			fclose(file);
+		}
+		return peak;
+#else
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return (uint64_t)usage.ru_maxrss;
+#endif
+	}
+
+	//What the process has resident right now, so the memory an import takes can be told apart from what was resident before it. 0 where it can't be read
+	uint64_t GetCurrentRSS()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0;
+#elif defined(__linux__)
+		uint64_t current = 0;
+		FILE* file = fopen("/proc/self/status", "r");
+		if (file != nullptr)
+		{
+			char line[256];
+			while (fgets(line, sizeof(line), file) != nullptr)
+			{
+				unsigned long long kilobytes;
+				if (sscanf(line, "VmRSS: %llu kB", &kilobytes) == 1)
+				{
+					current = kilobytes * 1024;
+					break;
+				}
+			}
+			fclose(file);
+		}
+		return current;
+#else
+		return 0;
+#endif
+	}
+
+	//Runs one iteration of a stage and folds it into the stage's result
+	template <typename Body>
+	void Measure(StageResult& stage, int iteration, Body body)
+	{
+		ResetPeakRSS();
+		uint64_t allocations = AllocationCounter::GetAllocations();
+		uint64_t allocatedBytes = AllocationCounter::GetAllocatedBytes();
+
+		Clock::time_point start = Clock::now();
+		body();
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		uint64_t peak = GetPeakRSS();
+		if (iteration == 0 || seconds < stage.Seconds) stage.Seconds = seconds;
+		stage.Allocations = AllocationCounter::GetAllocations() - allocations;
+		stage.AllocatedBytes = AllocationCounter::GetAllocatedBytes() - allocatedBytes;
+		stage.PeakRSS = std::max<uint64_t>(stage.PeakRSS, peak);
+	}
+
+	bool BenchmarkModel(const std::string& path, const std::string& binaryFilename, int iterations, MeshEncoding encoding, ModelResult& result)
+	{
+		result.Path = path;
+		StageResult* stages = result.Stages;
+		memset(stages, 0, sizeof(result.Stages));
+
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			OBJData data;
+			bool parsed = false;
+			Measure(stages[Tokenize], iteration, [&]() { parsed = OBJParser::ParseFile(path, data, true); });
+			if (!parsed)
+			{
+				return false;
+			}
+
+			std::vector<XMFLOAT3> expandedVertices;
+			std::vector<XMFLOAT3> expandedNormals;
+			std::vector<XMFLOAT2> expandedTexCoords;
+			size_t filledCorners;
+			bool expanded = false;
+			Measure(stages[Expand], iteration, [&]() { expanded = OBJImporter::ExpandVertices(data, expandedVertices, expandedTexCoords, expandedNormals, filledCorners); });
+			if (!expanded)
+			{
+				return false;
+			}
+
+			//Reserved the same way Import does, so the stage allocates what it does there
+			std::vector<unsigned int> meshIndices;
+			std::vector<XMFLOAT3> meshVertices;
+			std::vector<XMFLOAT3> meshNormals;
+			std::vector<XMFLOAT2> meshTexCoords;
+			Measure(stages[Weld], iteration, [&]()
+			{
+				meshIndices.reserve(expandedVertices.size());
+				meshVertices.reserve(expandedVertices.size());
+				meshNormals.reserve(expandedNormals.size());
+				meshTexCoords.reserve(expandedTexCoords.size());
+				OBJImporter::CreateIndices(expandedVertices, expandedTexCoords, expandedNormals, meshIndices, meshVertices, meshTexCoords, meshNormals);
+			});
+
+			MappedFile file(path);
+			stages[Tokenize].Bytes = file.GetSize();
+			stages[Tokenize].Vertices = data.Vertices.size();
+			stages[Expand].Vertices = expandedVertices.size();
+			stages[Expand].Bytes = expandedVertices.size() * sizeof(SimpleVertex);
+			stages[Weld].Vertices = expandedVertices.size();
+			stages[Weld].Bytes = expandedVertices.size() * sizeof(SimpleVertex);
+		}
+
+		//The stages in between are what the cooker spends most of its time on, but aren't what's measured here
+		CookedMesh mesh;
+		MeshSourceInfo source;
+		if (!OBJImporter::Cook(path, mesh) || !MeshBinary::GetSourceInfo(path, source, true))
+		{
+			return false;
+		}
+
+		bool written = true;
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			Measure(stages[Write], iteration, [&]() { written &= MeshBinary::Write(binaryFilename, source, mesh.Contents, encoding); });
+		}
+
+		bool read = true;
+		size_t fileSize = 0;
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			Measure(stages[Read], iteration, [&]()
+			{
+				MappedFile file;
+				std::vector<char> decoded;
+				MeshBinaryView view;
+				read &= MeshBinary::Map(binaryFilename, path, mesh.Contents.Format, file, decoded, view) == MeshBinaryStatus::Valid;
+				fileSize = file.GetSize();
+			});
+		}
+
+		std::error_code error;
+		std::filesystem::remove(binaryFilename, error);
+
+		for (Stage stage : { Write, Read })
+		{
+			stages[stage].Bytes = fileSize;
+			stages[stage].Vertices = mesh.Contents.VertexCount;
+		}
+		return written && read;
+	}
+
+	double PerSecond(uint64_t amount, double seconds)
+	{
+		return seconds > 0.0 ? amount / seconds : 0.0;
+	}
+
+	//Churns a GeometryAllocator with a few fixed seeds and checks it stayed consistent throughout, see GeometryAllocator::Churn. Returns what main returns
+	int BenchmarkAllocator(uint32_t operations)
+	{
+		const uint32_t capacity = 4 * 1024 * 1024;
+		const uint32_t seeds[] = { 1, 2, 3 };
+
+		printf("%-6s %10s %8s %8s %10s %8s %8s %10s %10s %8s %10s %8s %8s\n", "seed", "operations", "allocs", "frees", "fragmented", "peak", "average",
+			"free", "blocks", "final", "moves", "after", "ns/op");
+		bool valid = true;
+		for (uint32_t seed : seeds)
+		{
+			GeometryChurnResult result = GeometryAllocator::Churn(capacity, operations, seed);
+			printf("%-6u %10u %8u %8u %10u %7.1f%% %7.1f%% %10u %10u %7.1f%% %10u %7.1f%% %8.1f  %s\n", seed, operations, result.Allocations, result.Frees,
+				result.FragmentedFailures, result.PeakFragmentation * 100.0f, result.AverageFragmentation * 100.0f, result.Churned.FreeUnits, result.Churned.FreeBlockCount,
+				result.Churned.Fragmentation * 100.0f, result.MoveCount, result.Defragmented.Fragmentation * 100.0f, result.Seconds * 1e9 / std::max<uint32_t>(operations, 1),
+				result.Valid ? "valid" : "INVALID");
+			valid &= result.Valid;
+		}
+		return valid ? 0 : 1;
+	}
+
+	//Writes a scan the way photogrammetry tools do: a grid of size x size vertices, each with its own position, texture coordinate and normal,
+	//and two materials each covering half of it
+	bool WriteScan(const std::string& path, int size)
+	{
+		FILE* file = fopen(path.c_str(), "w");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		fprintf(file, "# generated by ImportBenchmark --streaming\no scan\n");
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+			{
+				fprintf(file, "v %.6f %.6f %.6f\n", x * 0.01f, y * 0.01f, ((x * 7 + y * 13) % 17) * 0.001f);
+			}
+		}
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+			{
+				fprintf(file, "vt %.6f %.6f\n", x / (float)(size - 1), y / (float)(size - 1));
+			}
+		}
+		for (int i = 0; i < size * size; i++)
+		{
+			fputs("vn 0.000000 0.000000 1.000000\n", file);
+		}
+
+		fputs("usemtl rock\n", file);
+		for (int y = 0; y < size - 1; y++)
+		{
+			if (y == (size - 1) / 2)
+			{
+				fputs("usemtl moss\n", file);
+			}
+			for (int x = 0; x < size - 1; x++)
+			{
+				int a = y * size + x + 1;
+				int b = a + 1;
+				int c = a + size;
+				int d = c + 1;
+				fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, c, c, c, b, b, b);
+				fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", b, b, b, c, c, c, d, d, d);
+			}
+		}
+		return fclose(file) == 0;
+	}
+
+	//Imports a generated scan about three times the size of the budget with OBJStreamImporter, and checks the most memory the process had
+	//resident during the import, less what it had before, stayed within it. Returns what main returns
+	int BenchmarkStreaming(size_t budget)
+	{
+		//Each vertex of the grid takes about 200 bytes of text and its two triangles
+		const uint64_t bytesPerVertex = 200;
+		int size = (int)sqrt((double)(budget * 3 / bytesPerVertex));
+		std::filesystem::path directory = std::filesystem::temp_directory_path();
+		std::string path = (directory / "ImportBenchmarkScan.obj").string();
+		std::string binaryFilename = (directory / "ImportBenchmarkScan.objBinary").string();
+
+		printf("writing a %d x %d scan to %s\n", size, size, path.c_str());
+		fflush(stdout);
+		if (!WriteScan(path, size))
+		{
+			fprintf(stderr, "%s: couldn't be written\n", path.c_str());
+			return 1;
+		}
+
+		StreamingImportOptions options = OBJStreamImporter::GetDefaultOptions();
+		options.MemoryBudget = budget;
+		StreamingImportStats stats;
+
+		uint64_t baseline = GetCurrentRSS();
+		ResetPeakRSS();
+		Clock::time_point start = Clock::now();
+		bool imported = OBJStreamImporter::Import(path, binaryFilename, options, stats);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		uint64_t peak = GetPeakRSS();
+
+		bool valid = false;
+		if (imported)
+		{
+			MappedFile file;
+			std::vector<char> decoded;
+			MeshBinaryView view;
+			valid = MeshBinary::Map(binaryFilename, path, options.Format, file, decoded, view) == MeshBinaryStatus::Valid;
+		}
+
+		std::error_code error;
+		std::filesystem::remove(path, error);
+		std::filesystem::remove(binaryFilename, error);
+		if (!imported || !valid)
+		{
+			fprintf(stderr, "%s: %s\n", path.c_str(), imported ? "the binary mesh written isn't valid" : "couldn't be imported");
+			return 1;
+		}
+
+		uint64_t used = peak > baseline ? peak - baseline : 0;
+		printf("%.1f MB source, %u vertices, %u triangles, %u meshlets, %u windows of up to %zu faces in %.2f s (%.1f MB/s)\n",
+			stats.FileSize / (1024.0 * 1024.0), stats.VertexCount, stats.TriangleCount, stats.MeshletCount, stats.WindowCount, stats.WindowFaces,
+			seconds, PerSecond(stats.FileSize, seconds) / (1024.0 * 1024.0));
+		printf("budget %.1f MB: pools %.1f MB, buffer %.1f MB, window %.1f MB\n", budget / (1024.0 * 1024.0),
+			stats.PoolBytes / (1024.0 * 1024.0), stats.BufferBytes / (1024.0 * 1024.0), stats.WindowBytes / (1024.0 * 1024.0));
+		bool within = used <= budget;
+		printf("peak resident %.1f MB over a baseline of %.1f MB: %s\n", used / (1024.0 * 1024.0), baseline / (1024.0 * 1024.0),
+			within ? "within budget" : "OVER BUDGET");
+		return within ? 0 : 1;
+	}
+
+	void PrintRow(const char* model, const char* stage, const StageResult& result)
+	{
+		printf("%-36s %-14s %10.3f %10.1f %10.2f %10llu %10.2f %10.1f\n", model, stage, result.Seconds * 1000.0,
+			PerSecond(result.Bytes, result.Seconds) / (1024.0 * 1024.0), PerSecond(result.Vertices, result.Seconds) / 1e6,
+			(unsigned long long)result.Allocations, result.AllocatedBytes / (1024.0 * 1024.0), result.PeakRSS / (1024.0 * 1024.0));
+	}
+
+	json ToJson(const StageResult& result, const char* name)
+	{
+		json stage;
+		stage["stage"] = name;
+		stage["seconds"] = result.Seconds;
+		stage["bytes"] = result.Bytes;
+		stage["MBps"] = PerSecond(result.Bytes, result.Seconds) / (1024.0 * 1024.0);
+		stage["vertices"] = result.Vertices;
+		stage["verticesPerSecond"] = PerSecond(result.Vertices, result.Seconds);
+		stage["allocations"] = result.Allocations;
+		stage["allocatedBytes"] = result.AllocatedBytes;
+		stage["peakRSSBytes"] = result.PeakRSS;
+		return stage;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int iterations = 5;
+	std::string jsonFilename = "ImportBenchmark.json";
+	std::string directory = "Models";
+	MeshEncoding encoding = MeshEncoding::Raw;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+		{
+			iterations = std::max<int>(atoi(argv[++i]), 1);
+		}
+		else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+		{
+			jsonFilename = argv[++i];
+		}
+		else if (strcmp(argv[i], "--compress") == 0)
+		{
+			encoding = MeshEncoding::Compressed;
+		}
+		else if (strcmp(argv[i], "--streaming") == 0 && i + 1 < argc)
+		{
+			return BenchmarkStreaming((size_t)std::max<int>(atoi(argv[++i]), 1) * 1024 * 1024);
+		}
+		else if (strcmp(argv[i], "--allocator") == 0 && i + 1 < argc)
+		{
+			return BenchmarkAllocator((uint32_t)std::max<int>(atoi(argv[++i]), 1));
+		}
+		else if (argv[i][0] == '-')
+		{
+			fprintf(stderr, "usage: %s [--iterations N] [--json file] [--compress] [directory]\n       %s --streaming MB\n       %s --allocator N\n",
+				argv[0], argv[0], argv[0]);
+			return 2;
+		}
+		else
+		{
+			directory = argv[i];
+		}
+	}
+
+	//Every .obj file under the directory, in a fixed order so runs can be compared line by line
+	std::vector<std::string> models;
+	std::error_code error;
+	for (std::filesystem::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+	{
+		if (it->is_regular_file() && it->path().extension() == ".obj")
+		{
+			models.push_back(it->path().generic_string());
+		}
+	}
+	std::sort(models.begin(), models.end());
+	if (models.empty())
+	{
+		fprintf(stderr, "%s: no .obj files found\n", directory.c_str());
+		return 1;
+	}
+
+	//Written to the temporary directory rather than next to the models, so the benchmark never touches their caches
+	std::string binaryFilename = (std::filesystem::temp_directory_path() / "ImportBenchmark.objBinary").string();
+
+	printf("%-36s %-14s %10s %10s %10s %10s %10s %10s\n", "model", "stage", "ms", "MB/s", "Mverts/s", "allocs", "alloc MB", "peak MB");
+	std::vector<ModelResult> results;
+	StageResult totals[StageCount] = {};
+	for (const std::string& model : models)
+	{
+		ModelResult result;
+		if (!BenchmarkModel(model, binaryFilename, iterations, encoding, result))
+		{
+			fprintf(stderr, "%s: couldn't be imported\n", model.c_str());
+			continue;
+		}
+
+		for (int stage = 0; stage < StageCount; stage++)
+		{
+			PrintRow(model.c_str(), StageNames[stage], result.Stages[stage]);
+
+			StageResult& total = totals[stage];
+			total.Seconds += result.Stages[stage].Seconds;
+			total.Bytes += result.Stages[stage].Bytes;
+			total.Vertices += result.Stages[stage].Vertices;
+			total.Allocations += result.Stages[stage].Allocations;
+			total.AllocatedBytes += result.Stages[stage].AllocatedBytes;
+			total.PeakRSS = std::max<uint64_t>(total.PeakRSS, result.Stages[stage].PeakRSS);
+		}
+		results.push_back(result);
+	}
+	for (int stage = 0; stage < StageCount; stage++)
+	{
+		PrintRow("total", StageNames[stage], totals[stage]);
+	}
+
+	json report;
+	report["iterations"] = iterations;
+	report["threads"] = ThreadPool::GetShared().GetThreadCount();
+	report["encoding"] = encoding == MeshEncoding::Compressed ? "compressed" : "raw";
+	report["models"] = json::array();
+	for (const ModelResult& result : results)
+	{
+		json model;
+		model["path"] = result.Path;
+		model["stages"] = json::array();
+		for (int stage = 0; stage < StageCount; stage++)
+		{
+			model["stages"].push_back(ToJson(result.Stages[stage], StageNames[stage]));
+		}
+		report["models"].push_back(model);
+	}
+	report["totals"] = json::array();
+	for (int stage = 0; stage < StageCount; stage++)
+	{
+		report["totals"].push_back(ToJson(totals[stage], StageNames[stage]));
+	}
+
+	std::ofstream out(jsonFilename);
+	out << report.dump(2) << "\n";
+	if (!out.good())
+	{
+		fprintf(stderr, "%s: couldn't be written\n", jsonFilename.c_str());
+		return 1;
+	}
+	printf("%zu models, results written to %s\n", results.size(), jsonFilename.c_str());
+	return 0;
+}
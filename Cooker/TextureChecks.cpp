@@ -0,0 +1,761 @@
+//The texture checks: run the texture loading code over every .dds file under Textures/ without a GPU, and check it does what it says. Run it from
+//the directory the game runs from. Each check named runs in turn with its argument, or every check with its default if none is named, and the
+//process fails if any check does. Builds alongside the asset cooker, without Direct3D, see CMakeLists.txt.
+//	TextureChecks [dds N] [textures KB] [mips MB] [residency MB]
+//dds probes each file from its headers alone, checks the sizes found account for every byte of the file, checks mapping it and slicing it into
+//subresources points each mip at the right bytes of the mapping, and parses each header again N times with random damage to check a corrupt file
+//is always turned away cleanly.
+//textures requests every file from a TextureLoadQueue a few times over, along with one that doesn't exist, takes them back a frame at a time within
+//an upload budget of KB and checks each arrives once, in the order requested, parsed as DDSProbe parses it.
+//mips streams the mips of every file that can be loaded for a camera walking up to a row of surfaces and back, within a GPU memory budget of MB,
+//and checks the mips picked stay within it, are the ones needed when they fit, and come out the same every run.
+//residency draws every other file that can be loaded close up, then the rest, then the first half again, within a GPU memory budget of MB, reports
+//every frame a texture was evicted or drawn while evicted, and checks the least recently drawn textures gave up their mips first.
+#include "AllocationCounter.h"
+#include "DDSProbe.h"
+#include "MappedFile.h"
+#include "MipStreamer.h"
+#include "TextureLoadQueue.h"
+#include <algorithm>
+#include <chrono>		//For timing probes and reads
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	//Every .dds file under a directory, sorted by path, and what DDSProbe makes of each from its headers alone. Every check starts from one
+	struct TextureFixture
+	{
+		std::string Directory;
+		std::vector<std::string> Paths;
+		//Whether each of Paths probed, so is a texture DDSTextureLoader can load, and what was found if it did
+		std::vector<bool> Probed;
+		std::vector<DDSTextureInfo> Infos;
+		//Just the ones that probed, and their pixel data with every mip
+		std::vector<std::string> LoadablePaths;
+		std::vector<DDSTextureInfo> LoadableInfos;
+		uint64_t LoadableBytes;
+	};
+
+	//Finds and probes every .dds file under the directory. Returns false if there are none
+	bool LoadFixture(const std::string& directory, TextureFixture& fixture)
+	{
+		fixture = TextureFixture();
+		fixture.Directory = directory;
+		fixture.LoadableBytes = 0;
+		std::error_code error;
+		for (std::filesystem::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+		{
+			if (it->is_regular_file() && it->path().extension() == ".dds")
+			{
+				fixture.Paths.push_back(it->path().generic_string());
+			}
+		}
+		std::sort(fixture.Paths.begin(), fixture.Paths.end());
+
+		for (const std::string& path : fixture.Paths)
+		{
+			DDSTextureInfo info;
+			memset(&info, 0, sizeof(info));
+			bool probed = DDSProbe::Probe(path, info);
+			fixture.Probed.push_back(probed);
+			fixture.Infos.push_back(info);
+			if (probed)
+			{
+				fixture.LoadablePaths.push_back(path);
+				fixture.LoadableInfos.push_back(info);
+				fixture.LoadableBytes += info.DataBytes;
+			}
+		}
+		if (fixture.Paths.empty())
+		{
+			fprintf(stderr, "%s: no .dds files found\n", directory.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	//A header mutated at random: a few bytes changed, a field set to a value at or past a limit, or the header cut short
+	std::vector<uint8_t> Mutate(const std::vector<uint8_t>& header, uint32_t& state)
+	{
+		auto next = [&state]()
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		};
+
+		std::vector<uint8_t> mutated = header;
+		uint32_t changes = 1 + next() % 4;
+		for (uint32_t i = 0; i < changes && !mutated.empty(); i++)
+		{
+			size_t at = next() % mutated.size();
+			switch (next() % 3)
+			{
+			case 0:
+				mutated[at] ^= (uint8_t)(1 << (next() % 8));
+				break;
+			case 1:
+				mutated[at] = (uint8_t)next();
+				break;
+			default:
+			{
+				const uint32_t edges[] = { 0, 1, 6, 15, 16, 2048, 2049, 16384, 16385, 0x7fffffff, 0xffffffff };
+				uint32_t value = edges[next() % (sizeof(edges) / sizeof(edges[0]))];
+				size_t field = at & ~(size_t)3;
+				if (field + sizeof(value) <= mutated.size())
+				{
+					memcpy(mutated.data() + field, &value, sizeof(value));
+				}
+				break;
+			}
+			}
+		}
+		if (next() % 8 == 0)
+		{
+			mutated.resize(next() % (mutated.size() + 1));
+		}
+		return mutated;
+	}
+
+	//Whether what Parse found is consistent: within the hardware limits, and with sizes that add up
+	bool IsConsistent(const DDSTextureInfo& info)
+	{
+		if (info.MipCount == 0 || info.MipCount > DDSTextureInfo::MaxMipCount || info.ArraySize == 0 || info.Width == 0 || info.Height == 0 || info.Depth == 0
+			|| info.Width > 16384 || info.Height > 16384 || info.ArraySize > 2048
+			|| (info.DataOffset != DDSProbe::HeaderBytes && info.DataOffset != DDSProbe::HeaderBytes - sizeof(DDS_HEADER_DXT10)))
+		{
+			return false;
+		}
+
+		uint64_t sliceBytes = 0;
+		for (uint32_t mip = 0; mip < info.MipCount; mip++)
+		{
+			if (info.MipBytes[mip] == 0 || info.MipRowBytes[mip] == 0 || (mip > 0 && info.MipBytes[mip] > info.MipBytes[mip - 1]))
+			{
+				return false;
+			}
+			sliceBytes += info.MipBytes[mip];
+		}
+		uint32_t firstMip = DDSProbe::GetFirstMip(info, 128);
+		return info.DataBytes == sliceBytes * info.ArraySize && DDSProbe::GetBytes(info, 0) == info.DataBytes && firstMip <= info.MipCount
+			&& DDSProbe::GetBytes(info, firstMip) <= info.DataBytes;
+	}
+
+	//Maps a texture and slices it the way DDSTextureLoader's mapped path does, leaving out mips bigger than maxSize, and checks every subresource
+	//points where the headers say its mip is within the mapping, holds the bytes read from the file there, and that a file cut short is turned away
+	bool IsSlicedInPlace(const std::string& texture, const std::vector<uint8_t>& contents, size_t maxSize)
+	{
+		MappedFile file(texture);
+		if (!file.IsOpen() || file.GetSize() != contents.size())
+		{
+			return false;
+		}
+		const uint8_t* data = (const uint8_t*)file.GetData();
+
+		DDSTextureInfo info;
+		std::vector<DDSSubresource> subresources;
+		if (!DDSProbe::Slice(data, file.GetSize(), maxSize, info, subresources))
+		{
+			return false;
+		}
+		uint32_t firstMip = DDSProbe::GetFirstMip(info, maxSize);
+		if (subresources.size() != (size_t)(info.MipCount - firstMip) * info.ArraySize)
+		{
+			return false;
+		}
+
+		uint64_t sliceBytes = DDSProbe::GetBytes(info, 0) / info.ArraySize;
+		size_t index = 0;
+		for (uint32_t slice = 0; slice < info.ArraySize; slice++)
+		{
+			uint64_t offset = info.DataOffset + slice * sliceBytes;
+			for (uint32_t mip = 0; mip < info.MipCount; mip++)
+			{
+				if (mip >= firstMip)
+				{
+					const DDSSubresource& subresource = subresources[index++];
+					uint64_t bytes = (uint64_t)subresource.SysMemSlicePitch * DDSProbe::GetMipDepth(info, mip);
+					if (subresource.pSysMem != data + offset || subresource.SysMemPitch != info.MipRowBytes[mip] || bytes != info.MipBytes[mip]
+						|| offset + bytes > contents.size() || memcmp(subresource.pSysMem, contents.data() + offset, (size_t)bytes) != 0)
+					{
+						return false;
+					}
+				}
+				offset += info.MipBytes[mip];
+			}
+		}
+
+		//The last byte of the last mip missing has to be noticed
+		return !DDSProbe::Slice(data, file.GetSize() - 1, maxSize, info, subresources);
+	}
+
+	//Probes every texture again, timed against reading it whole, and checks the headers account for the whole file, checks it's sliced in place
+	//when mapped, then fuzzes each header
+	bool CheckDDS(const TextureFixture& fixture, uint32_t mutations)
+	{
+		printf("%-36s %6s %11s %5s %6s %10s %10s %10s %10s %10s %8s %8s\n", "texture", "format", "size", "mips", "array", "MB", "<=128 MB", "probe us", "read us",
+			"mapped KB", "sliced", "fuzzed");
+		bool valid = true;
+		uint64_t totalBytes = 0;
+		uint32_t accepted = 0;
+		uint32_t unsupported = 0;
+		uint32_t state = 1;
+		for (const std::string& texture : fixture.Paths)
+		{
+			Clock::time_point start = Clock::now();
+			DDSTextureInfo info;
+			bool probed = DDSProbe::Probe(texture, info);
+			double probeSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+			//What finding out the same took before: reading the whole file
+			start = Clock::now();
+			std::ifstream in(texture, std::ios::in | std::ios::binary);
+			std::vector<uint8_t> contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+			double readSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+			//A format DDSTextureLoader can't load either, such as 24 bit RGB, is turned away by the probe too
+			DDSTextureInfo parsed;
+			if (!probed && !DDSProbe::Parse(contents.data(), contents.size(), parsed))
+			{
+				printf("%-36s unsupported\n", texture.c_str());
+				unsupported++;
+				continue;
+			}
+			if (!probed || !IsConsistent(info) || info.DataOffset + info.DataBytes != contents.size())
+			{
+				fprintf(stderr, "%s: %s\n", texture.c_str(), probed ? "the headers don't account for the whole file" : "is cut short");
+				valid = false;
+				continue;
+			}
+			totalBytes += info.DataBytes;
+
+			//What the mapped path takes from the heap to get the same far, where reading it took a copy of the whole file: only the subresource list
+			uint64_t allocatedBytes = AllocationCounter::GetAllocatedBytes();
+			{
+				MappedFile file(texture);
+				DDSTextureInfo mapped;
+				std::vector<DDSSubresource> subresources;
+				DDSProbe::Slice((const uint8_t*)file.GetData(), file.GetSize(), 0, mapped, subresources);
+			}
+			allocatedBytes = AllocationCounter::GetAllocatedBytes() - allocatedBytes;
+			bool sliced = IsSlicedInPlace(texture, contents, 0) && IsSlicedInPlace(texture, contents, 128);
+			valid &= sliced;
+
+			//Whatever is done to the header, Parse either turns it away or finds something consistent
+			std::vector<uint8_t> header(contents.begin(), contents.begin() + std::min<size_t>(contents.size(), DDSProbe::HeaderBytes));
+			uint32_t inconsistent = 0;
+			for (uint32_t i = 0; i < mutations; i++)
+			{
+				std::vector<uint8_t> mutated = Mutate(header, state);
+				DDSTextureInfo fuzzed;
+				if (DDSProbe::Parse(mutated.data(), mutated.size(), fuzzed))
+				{
+					accepted++;
+					inconsistent += IsConsistent(fuzzed) ? 0 : 1;
+				}
+			}
+			valid &= inconsistent == 0;
+
+			char size[32];
+			snprintf(size, sizeof(size), "%ux%u", info.Width, info.Height);
+			printf("%-36s %6d %11s %5u %6u %10.2f %10.3f %10.1f %10.1f %10.1f %8s %8s\n", texture.c_str(), (int)info.Format, size, info.MipCount, info.ArraySize,
+				info.DataBytes / (1024.0 * 1024.0), DDSProbe::GetBytes(info, DDSProbe::GetFirstMip(info, 128)) / (1024.0 * 1024.0),
+				probeSeconds * 1e6, readSeconds * 1e6, allocatedBytes / 1024.0, sliced ? "valid" : "INVALID", inconsistent == 0 ? "valid" : "INVALID");
+		}
+		size_t probed = fixture.Paths.size() - unsupported;
+		printf("%zu textures, %u unsupported, %.2f MB of pixel data; %u of %zu damaged headers still parsed, all checked for consistency\n", fixture.Paths.size(),
+			unsupported, totalBytes / (1024.0 * 1024.0), accepted, (size_t)mutations * probed);
+		return valid;
+	}
+
+	//Requests every texture a few times over from a TextureLoadQueue, plus one that doesn't exist, and times that against reading them all up
+	//front the way levels used to. Then takes them back a frame at a time within the budget, the way TextureLoader does, and checks every one
+	//arrives exactly once, in the order requested, within the budget unless it's bigger than the budget by itself, and parsed the same as the
+	//fixture's probe
+	bool CheckTextures(const TextureFixture& fixture, uint64_t budget)
+	{
+		const uint32_t passes = 4;
+		std::vector<std::string> requests;
+		for (uint32_t pass = 0; pass < passes; pass++)
+		{
+			requests.insert(requests.end(), fixture.Paths.begin(), fixture.Paths.end());
+		}
+		requests.push_back(fixture.Directory + "/missing.dds");
+
+		//What the first frame used to wait for: every file read and parsed on the main thread
+		Clock::time_point start = Clock::now();
+		uint64_t readBytes = 0;
+		for (const std::string& texture : requests)
+		{
+			std::ifstream in(texture, std::ios::in | std::ios::binary | std::ios::ate);
+			std::vector<uint8_t> contents(in ? (size_t)in.tellg() : 0);
+			in.seekg(0);
+			in.read((char*)contents.data(), contents.size());
+			DDSTextureInfo info;
+			readBytes += DDSProbe::Parse(contents.data(), contents.size(), info) ? info.DataBytes : 0;
+		}
+		double readSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		bool valid = true;
+		double requestSeconds;
+		double waitSeconds;
+		uint32_t frames = 0;
+		uint32_t failed = 0;
+		uint64_t largestFrameBytes = 0;
+		std::vector<uint32_t> arrived(requests.size(), 0);
+		{
+			TextureLoadQueue queue;
+			start = Clock::now();
+			for (size_t i = 0; i < requests.size(); i++)
+			{
+				valid &= queue.Request(requests[i]) == (uint32_t)i;
+			}
+			requestSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+			queue.WaitForAll();
+			waitSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+			//With everything read, how many frames it takes to upload is down to the budget alone
+			while (!queue.IsIdle())
+			{
+				std::vector<std::unique_ptr<LoadedTexture>> taken;
+				uint64_t frameBytes = queue.TakeReady(budget, taken);
+				frames++;
+
+				uint64_t bytes = 0;
+				for (size_t i = 0; i < taken.size(); i++)
+				{
+					const LoadedTexture& loaded = *taken[i];
+					if (loaded.Id >= requests.size() || (i > 0 && loaded.Id <= taken[i - 1]->Id) || loaded.Path != requests[loaded.Id])
+					{
+						fprintf(stderr, "frame %u: texture %u came back out of order\n", frames, loaded.Id);
+						valid = false;
+						continue;
+					}
+					arrived[loaded.Id]++;
+					failed += loaded.Valid ? 0 : 1;
+					bytes += loaded.Valid ? loaded.Info.DataBytes : 0;
+
+					//Each pass requests the fixture's files in order, then the missing one comes last
+					size_t file = loaded.Id % fixture.Paths.size();
+					bool probed = loaded.Id < passes * fixture.Paths.size() && fixture.Probed[file];
+					const DDSTextureInfo& info = fixture.Infos[file];
+					if (loaded.Valid != probed || (loaded.Valid && (loaded.Info.DataBytes != info.DataBytes
+						|| loaded.Info.Width != info.Width || loaded.Info.Height != info.Height || loaded.Info.MipCount != info.MipCount
+						|| loaded.Info.Format != info.Format || loaded.File.GetSize() != info.DataOffset + info.DataBytes)))
+					{
+						fprintf(stderr, "%s: came back parsed differently to the probe\n", loaded.Path.c_str());
+						valid = false;
+					}
+				}
+				//Nothing left ready means TakeReady left nothing behind, and with everything read there's always something to take
+				if (taken.empty() || bytes != frameBytes || (frameBytes > budget && taken.size() != 1))
+				{
+					fprintf(stderr, "frame %u: %zu textures, %.2f MB taken against a budget of %.2f MB\n", frames, taken.size(),
+						frameBytes / (1024.0 * 1024.0), budget / (1024.0 * 1024.0));
+					valid = false;
+					break;
+				}
+				largestFrameBytes = std::max<uint64_t>(largestFrameBytes, frameBytes);
+			}
+
+			TextureLoadQueueStats stats = queue.GetStats();
+			valid &= stats.Requested == requests.size() && stats.Taken == requests.size() && stats.Ready == 0 && stats.Failed == failed
+				&& stats.TakenBytes == readBytes;
+		}
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			if (arrived[i] != 1)
+			{
+				fprintf(stderr, "%s: texture %zu came back %u times\n", requests[i].c_str(), i, arrived[i]);
+				valid = false;
+			}
+		}
+
+		//A queue destroyed with files still waiting for a worker skips them rather than reading them for nothing
+		{
+			TextureLoadQueue queue;
+			for (const std::string& texture : requests)
+			{
+				queue.Request(texture);
+			}
+		}
+
+		printf("%zu requests of %zu textures, %u missing or unsupported, %.2f MB of pixel data\n", requests.size(), fixture.Paths.size(), failed,
+			readBytes / (1024.0 * 1024.0));
+		printf("main thread blocked reading up front %.2f ms, requesting %.3f ms; read in the background in %.2f ms\n", readSeconds * 1000.0, requestSeconds * 1000.0,
+			waitSeconds * 1000.0);
+		printf("budget %.2f MB: uploaded over %u frames, at most %.2f MB in a frame\n", budget / (1024.0 * 1024.0), frames, largestFrameBytes / (1024.0 * 1024.0));
+		return valid;
+	}
+
+	//A camera walks in from far away to a row of surfaces, one per texture, then back out, waiting at each end for streaming to settle.
+	//Checks every frame that the mips on the GPU stay within the budget and the upload budget, and that every change starts from what the
+	//texture had. Once streaming settles close up, every texture has the mip it needs if they all fit. Adds each change to the hash, so two
+	//runs can be compared
+	bool RunMipWalk(const std::vector<DDSTextureInfo>& infos, uint64_t budget, uint64_t uploadBudget, std::vector<uint32_t>& nearestMips,
+		std::vector<uint32_t>& settledMips, MipStreamerStats& stats, uint64_t& hash)
+	{
+		const int walkFrames = 200;
+		const int waitFrames = 30;
+		const float farDistance = 400.0f;
+		//A 1080 pixel tall window with a 60 degree field of view, as the level's cameras have
+		const float pixelScale = 1080.0f * 0.5f / tanf(3.14159265f / 6.0f);
+
+		MipStreamer streamer(budget);
+		for (const DDSTextureInfo& info : infos)
+		{
+			streamer.Add(info);
+		}
+		nearestMips.assign(infos.size(), 0);
+		settledMips.assign(infos.size(), 0);
+
+		bool valid = true;
+		int frames = 2 * (walkFrames + waitFrames);
+		for (int frame = 0; frame < frames; frame++)
+		{
+			//In, wait close up, back out, wait far away
+			int step = frame % (walkFrames + waitFrames);
+			float travelled = std::min<float>((float)step / walkFrames, 1.0f);
+			float camera = frame < walkFrames + waitFrames ? farDistance * (1.0f - travelled) : farDistance * travelled;
+
+			//Each surface a little further back than the last, and its texture repeating every 4, 8 or 12 units
+			for (uint32_t i = 0; i < (uint32_t)infos.size(); i++)
+			{
+				float density = 1.0f / (4.0f * (1 + i % 3));
+				float distance = camera + 2.0f * i;
+				streamer.Require(i, MipStreamer::GetRequiredMip(infos[i], density, distance, pixelScale));
+			}
+
+			std::vector<uint32_t> before(infos.size());
+			for (uint32_t i = 0; i < (uint32_t)infos.size(); i++)
+			{
+				before[i] = streamer.GetResidentMip(i);
+			}
+			std::vector<MipChange> changes;
+			bool settled = streamer.Update(uploadBudget, changes);
+			const MipStreamerStats& frameStats = streamer.GetStats();
+
+			uint64_t changedBytes = 0;
+			for (const MipChange& change : changes)
+			{
+				valid &= change.FromMip == before[change.Index] && change.ToMip == streamer.GetResidentMip(change.Index) && change.FromMip != change.ToMip;
+				changedBytes += change.Bytes;
+				hash = (hash ^ ((uint64_t)frame << 40 | (uint64_t)change.Index << 16 | change.ToMip)) * 1099511628211ull;
+			}
+			uint64_t residentBytes = 0;
+			for (uint32_t i = 0; i < (uint32_t)infos.size(); i++)
+			{
+				valid &= streamer.GetResidentMip(i) <= streamer.GetTailMip(i);
+				residentBytes += DDSProbe::GetBytes(infos[i], streamer.GetResidentMip(i));
+			}
+			if (residentBytes != frameStats.ResidentBytes || residentBytes > std::max<uint64_t>(budget, frameStats.TailBytes)
+				|| (changes.size() > 1 && changedBytes > uploadBudget))
+			{
+				fprintf(stderr, "frame %d: %.2f MB resident, %.2f MB counted, budget %.2f MB, %zu changes uploading %.2f MB\n", frame,
+					residentBytes / (1024.0 * 1024.0), frameStats.ResidentBytes / (1024.0 * 1024.0), budget / (1024.0 * 1024.0), changes.size(),
+					changedBytes / (1024.0 * 1024.0));
+				valid = false;
+			}
+
+			//The last frame close up: streaming should have settled by now, on the mips needed if they fit
+			if (frame == walkFrames + waitFrames - 1)
+			{
+				for (uint32_t i = 0; i < (uint32_t)infos.size(); i++)
+				{
+					nearestMips[i] = MipStreamer::GetRequiredMip(infos[i], 1.0f / (4.0f * (1 + i % 3)), 2.0f * i, pixelScale);
+					settledMips[i] = streamer.GetResidentMip(i);
+					valid &= frameStats.RequiredBytes > budget || settledMips[i] == nearestMips[i];
+				}
+				if (!settled)
+				{
+					fprintf(stderr, "frame %d: streaming hasn't settled close up\n", frame);
+					valid = false;
+				}
+			}
+		}
+		stats = streamer.GetStats();
+		return valid;
+	}
+
+	//Streams the mips of every texture that can be loaded for a camera walking up to them and back, twice, and checks both runs stay within
+	//the budget, settle on the mips needed when they fit, and make the same changes
+	bool CheckMips(const TextureFixture& fixture, uint64_t budget)
+	{
+		const std::vector<DDSTextureInfo>& infos = fixture.LoadableInfos;
+		if (infos.empty())
+		{
+			fprintf(stderr, "%s: no .dds files that can be loaded found\n", fixture.Directory.c_str());
+			return false;
+		}
+
+		//Further away never needs more detail
+		bool valid = true;
+		for (const DDSTextureInfo& info : infos)
+		{
+			uint32_t last = 0;
+			for (float distance = 0.0f; distance < 2000.0f; distance += 0.5f)
+			{
+				uint32_t mip = MipStreamer::GetRequiredMip(info, 0.125f, distance, 935.0f);
+				valid &= mip >= last && mip < info.MipCount;
+				last = mip;
+			}
+		}
+
+		const uint64_t uploadBudget = 4 * 1024 * 1024;
+		std::vector<uint32_t> nearestMips, settledMips, repeatNearest, repeatSettled;
+		MipStreamerStats stats, repeatStats;
+		uint64_t hash = 14695981039346656037ull;
+		uint64_t repeatHash = hash;
+		valid &= RunMipWalk(infos, budget, uploadBudget, nearestMips, settledMips, stats, hash);
+		valid &= RunMipWalk(infos, budget, uploadBudget, repeatNearest, repeatSettled, repeatStats, repeatHash);
+		bool deterministic = hash == repeatHash && settledMips == repeatSettled && stats.UploadedBytes == repeatStats.UploadedBytes;
+		valid &= deterministic;
+
+		printf("%-36s %11s %5s %5s %10s %10s %8s %8s\n", "texture", "size", "mips", "tail", "tail KB", "full MB", "needed", "settled");
+		for (size_t i = 0; i < infos.size(); i++)
+		{
+			const DDSTextureInfo& info = infos[i];
+			uint32_t tailMip = MipStreamer::GetTailMip(info, MipStreamer::DefaultTailSize);
+			char size[32];
+			snprintf(size, sizeof(size), "%ux%u", info.Width, info.Height);
+			printf("%-36s %11s %5u %5u %10.1f %10.2f %8u %8u\n", fixture.LoadablePaths[i].c_str(), size, info.MipCount, tailMip,
+				DDSProbe::GetBytes(info, tailMip) / 1024.0, info.DataBytes / (1024.0 * 1024.0), nearestMips[i], settledMips[i]);
+		}
+		printf("%zu textures: %.2f MB of tails uploaded at startup instead of %.2f MB\n", infos.size(), stats.TailBytes / (1024.0 * 1024.0),
+			fixture.LoadableBytes / (1024.0 * 1024.0));
+		printf("budget %.2f MB: %u frames, mips streamed in %u times and out %u times, %u changes put off, %.2f MB uploaded, at most %.2f MB resident\n",
+			budget / (1024.0 * 1024.0), stats.Frames, stats.Upgrades, stats.Downgrades, stats.Deferred, stats.UploadedBytes / (1024.0 * 1024.0),
+			stats.PeakResidentBytes / (1024.0 * 1024.0));
+		printf("a second run made the same changes: %s\n", deterministic ? "yes" : "NO");
+		return valid;
+	}
+
+	//What the textures took up, and what was evicted and stalled, over one phase of RunResidency
+	struct ResidencyPhase
+	{
+		uint32_t Frames;
+		uint32_t Evictions;
+		uint32_t Stalls;
+		uint32_t Changes;
+		uint64_t UploadedBytes;
+		uint64_t ResidentBytes;
+		/// <summary>The frame of the phase its last change was made in, counting from 1, 0 if none was</summary>
+		uint32_t SettledFrame;
+	};
+
+	//Draws the even textures close up, then the odd ones, then the even ones again, with the ones not drawn out of sight. Checks every frame that the
+	//mips on the GPU stay within the budget, or within the tails of the textures drawn if those alone are over it, that only textures not drawn are evicted,
+	//and that by the end of each phase nothing drawn is still evicted, and everything not drawn is if what's drawn didn't get the mips it needs. Prints the
+	//frames with evictions or stalls if print is set, and adds each change to the hash so two runs can be compared
+	bool RunResidency(const std::vector<DDSTextureInfo>& infos, uint64_t budget, uint64_t uploadBudget, bool print, std::vector<ResidencyPhase>& phases,
+		uint64_t& hash)
+	{
+		const uint32_t phaseFrames = 60;
+		const float pixelScale = 1080.0f * 0.5f / tanf(3.14159265f / 6.0f);
+		const float density = 0.25f;
+
+		MipStreamer streamer(budget);
+		for (const DDSTextureInfo& info : infos)
+		{
+			streamer.Add(info);
+		}
+
+		bool valid = true;
+		phases.assign(3, ResidencyPhase());
+		for (uint32_t phase = 0; phase < 3; phase++)
+		{
+			ResidencyPhase& result = phases[phase];
+			memset(&result, 0, sizeof(result));
+			uint32_t drawn = phase % 2;
+			std::vector<uint32_t> required(infos.size(), 0);
+			for (uint32_t frame = 0; frame < phaseFrames; frame++)
+			{
+				uint64_t drawnTailBytes = 0;
+				for (uint32_t i = 0; i < (uint32_t)infos.size(); i++)
+				{
+					if (i % 2 == drawn)
+					{
+						required[i] = MipStreamer::GetRequiredMip(infos[i], density, 2.0f + i, pixelScale);
+						streamer.Require(i, required[i]);
+						drawnTailBytes += DDSProbe::GetBytes(infos[i], streamer.GetTailMip(i));
+					}
+				}
+
+				std::vector<MipChange> changes;
+				streamer.Update(uploadBudget, changes);
+				const MipStreamerFrame& frameStats = streamer.GetFrame();
+				for (const MipChange& change : changes)
+				{
+					if (change.ToMip >= infos[change.Index].MipCount && change.Index % 2 == drawn)
+					{
+						fprintf(stderr, "phase %u frame %u: texture %u was evicted while it was being drawn\n", phase + 1, frame + 1, change.Index);
+						valid = false;
+					}
+					hash = (hash ^ ((uint64_t)frameStats.Frame << 40 | (uint64_t)change.Index << 16 | change.ToMip)) * 1099511628211ull;
+				}
+
+				uint64_t residentBytes = 0;
+				for (uint32_t i = 0; i < (uint32_t)infos.size(); i++)
+				{
+					residentBytes += streamer.IsEvicted(i) ? 0 : DDSProbe::GetBytes(infos[i], streamer.GetResidentMip(i));
+				}
+				if (residentBytes != frameStats.ResidentBytes || residentBytes > std::max<uint64_t>(budget, drawnTailBytes))
+				{
+					fprintf(stderr, "phase %u frame %u: %.2f MB resident, %.2f MB counted, against a budget of %.2f MB\n", phase + 1, frame + 1,
+						residentBytes / (1024.0 * 1024.0), frameStats.ResidentBytes / (1024.0 * 1024.0), budget / (1024.0 * 1024.0));
+					valid = false;
+				}
+				if (print && (frameStats.Evictions != 0 || frameStats.Stalls != 0))
+				{
+					printf("  phase %u frame %u: %.2f MB resident, %u textures evicted, %u stalled waiting to be uploaded again, %u mips changes, %.2f MB uploaded\n",
+						phase + 1, frame + 1, frameStats.ResidentBytes / (1024.0 * 1024.0), frameStats.Evictions, frameStats.Stalls,
+						frameStats.Upgrades + frameStats.Downgrades - frameStats.Evictions, frameStats.UploadedBytes / (1024.0 * 1024.0));
+				}
+
+				result.Frames++;
+				result.Evictions += frameStats.Evictions;
+				result.Stalls += frameStats.Stalls;
+				result.Changes += (uint32_t)changes.size();
+				result.UploadedBytes += frameStats.UploadedBytes;
+				result.ResidentBytes = frameStats.ResidentBytes;
+				result.SettledFrame = changes.empty() ? result.SettledFrame : frame + 1;
+			}
+
+			//By the end of the phase, everything drawn is back, and if any of it is short of the mips it needs, nothing else is holding on to any
+			bool shortOfMips = false;
+			for (uint32_t i = 0; i < (uint32_t)infos.size(); i++)
+			{
+				if (i % 2 == drawn)
+				{
+					valid &= !streamer.IsEvicted(i);
+					shortOfMips |= streamer.GetResidentMip(i) > required[i];
+				}
+			}
+			for (uint32_t i = 0; i < (uint32_t)infos.size(); i++)
+			{
+				if (shortOfMips && i % 2 != drawn && !streamer.IsEvicted(i))
+				{
+					fprintf(stderr, "phase %u: texture %u kept its mips while the textures being drawn were short of theirs\n", phase + 1, i);
+					valid = false;
+				}
+			}
+		}
+
+		const MipStreamerStats& stats = streamer.GetStats();
+		uint32_t evictions = 0;
+		uint32_t stalls = 0;
+		for (const ResidencyPhase& phase : phases)
+		{
+			evictions += phase.Evictions;
+			stalls += phase.Stalls;
+		}
+		return valid && evictions == stats.Evictions && stalls == stats.Stalls;
+	}
+
+	//Runs RunResidency twice over every texture that can be loaded, and checks both runs are valid and make the same changes
+	bool CheckResidency(const TextureFixture& fixture, uint64_t budget)
+	{
+		const std::vector<DDSTextureInfo>& infos = fixture.LoadableInfos;
+		if (infos.size() < 2)
+		{
+			fprintf(stderr, "%s: fewer than two .dds files that can be loaded found\n", fixture.Directory.c_str());
+			return false;
+		}
+
+		const uint64_t uploadBudget = 4 * 1024 * 1024;
+		printf("%zu textures, %.2f MB with every mip, budget %.2f MB\n", infos.size(), fixture.LoadableBytes / (1024.0 * 1024.0), budget / (1024.0 * 1024.0));
+		std::vector<ResidencyPhase> phases, repeatPhases;
+		uint64_t hash = 14695981039346656037ull;
+		uint64_t repeatHash = hash;
+		bool valid = RunResidency(infos, budget, uploadBudget, true, phases, hash);
+		valid &= RunResidency(infos, budget, uploadBudget, false, repeatPhases, repeatHash);
+		bool deterministic = hash == repeatHash;
+		valid &= deterministic;
+
+		const char* names[] = { "even drawn", "odd drawn", "even again" };
+		printf("%-12s %8s %10s %10s %8s %10s %12s %8s\n", "phase", "frames", "evictions", "stalls", "changes", "MB upload", "MB resident", "settled");
+		for (size_t i = 0; i < phases.size(); i++)
+		{
+			const ResidencyPhase& phase = phases[i];
+			printf("%-12s %8u %10u %10u %8u %10.2f %12.2f %8u\n", names[i], phase.Frames, phase.Evictions, phase.Stalls, phase.Changes,
+				phase.UploadedBytes / (1024.0 * 1024.0), phase.ResidentBytes / (1024.0 * 1024.0), phase.SettledFrame);
+		}
+		printf("a second run made the same changes: %s\n", deterministic ? "yes" : "NO");
+		return valid;
+	}
+
+	struct Check
+	{
+		const char* Name;
+		const char* Argument;
+		int DefaultArgument;
+		bool (*Run)(const TextureFixture& fixture, int argument);
+	};
+
+	const Check Checks[] =
+	{
+		{ "dds", "N", 200, [](const TextureFixture& fixture, int argument) { return CheckDDS(fixture, (uint32_t)std::max<int>(argument, 0)); } },
+		{ "textures", "KB", 4096, [](const TextureFixture& fixture, int argument) { return CheckTextures(fixture, (uint64_t)std::max<int>(argument, 1) * 1024); } },
+		{ "mips", "MB", 4, [](const TextureFixture& fixture, int argument) { return CheckMips(fixture, (uint64_t)std::max<int>(argument, 1) * 1024 * 1024); } },
+		{ "residency", "MB", 2, [](const TextureFixture& fixture, int argument) { return CheckResidency(fixture, (uint64_t)std::max<int>(argument, 1) * 1024 * 1024); } },
+	};
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::pair<const Check*, int>> runs;
+	for (int i = 1; i < argc; i += 2)
+	{
+		const Check* found = nullptr;
+		for (const Check& check : Checks)
+		{
+			found = strcmp(argv[i], check.Name) == 0 ? &check : found;
+		}
+		if (found == nullptr || i + 1 >= argc)
+		{
+			fprintf(stderr, "usage: %s", argv[0]);
+			for (const Check& check : Checks)
+			{
+				fprintf(stderr, " [%s %s]", check.Name, check.Argument);
+			}
+			fprintf(stderr, "\n");
+			return 2;
+		}
+		runs.push_back({ found, atoi(argv[i + 1]) });
+	}
+	if (runs.empty())
+	{
+		for (const Check& check : Checks)
+		{
+			runs.push_back({ &check, check.DefaultArgument });
+		}
+	}
+
+	TextureFixture fixture;
+	if (!LoadFixture("Textures", fixture))
+	{
+		return 1;
+	}
+
+	//Every check runs even after one fails, so one run shows everything that's wrong
+	bool valid = true;
+	for (const auto& run : runs)
+	{
+		printf("%s %d\n", run.first->Name, run.second);
+		bool passed = run.first->Run(fixture, run.second);
+		printf("%s %d: %s\n\n", run.first->Name, run.second, passed ? "valid" : "INVALID");
+		valid &= passed;
+	}
+	return valid ? 0 : 1;
+}
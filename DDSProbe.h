@@ -0,0 +1,322 @@
+#pragma once
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DDSFormat.h"
+
+/// <summary>The kind of resource a DDS file holds. The values are D3D11_RESOURCE_DIMENSION's, so it can be cast to one</summary>
+enum class DDSDimension : uint32_t
+{
+	Unknown = 0,
+	Texture1D = 2,
+	Texture2D = 3,
+	Texture3D = 4
+};
+
+/// <summary>What a DDS file holds, as read from its headers by DDSProbe</summary>
+struct DDSTextureInfo
+{
+	/// <summary>The most mips a texture can have, D3D11_REQ_MIP_LEVELS</summary>
+	static const uint32_t MaxMipCount = 15;
+
+	DXGI_FORMAT Format;
+	DDSDimension Dimension;
+	uint32_t Width;
+	uint32_t Height;
+	/// <summary>1 unless it's a volume texture</summary>
+	uint32_t Depth;
+	/// <summary>The number of slices, six for each cube of a cube map</summary>
+	uint32_t ArraySize;
+	uint32_t MipCount;
+	bool IsCubeMap;
+	/// <summary>Where the pixel data starts in the file, after the magic number and the headers</summary>
+	uint32_t DataOffset;
+	/// <summary>The bytes of each mip of one slice, every depth slice of a volume included, largest first as they're stored. Only the first MipCount are set</summary>
+	uint64_t MipBytes[MaxMipCount];
+	/// <summary>The bytes of a row of each mip, or of a row of blocks for block compressed formats</summary>
+	uint64_t MipRowBytes[MaxMipCount];
+	/// <summary>The pixel data of every slice and mip, which is what the texture takes up once it's on the GPU</summary>
+	uint64_t DataBytes;
+};
+
+/// <summary>Where one mip of one slice is in a DDS file, laid out like D3D11_SUBRESOURCE_DATA</summary>
+struct DDSSubresource
+{
+	const void* pSysMem;
+	/// <summary>The bytes from one row, or row of blocks, to the next</summary>
+	uint32_t SysMemPitch;
+	/// <summary>The bytes of one depth slice</summary>
+	uint32_t SysMemSlicePitch;
+};
+
+/// <summary><para>Reads what a DDS file holds from its headers alone, without reading the pixel data or needing Direct3D, so loading can plan
+/// how much memory textures will take and when to upload them before any are loaded. </para>
+/// <para>Makes the same checks and applies the same limits DDSTextureLoader does before it creates a texture, with the same
+/// GetDXGIFormat and GetSurfaceInfo, so a file it accepts is one DDSTextureLoader will load and the sizes are the ones it'll upload.
+/// Anything can be passed to Parse, so it can be fuzzed.</para></summary>
+class DDSProbe
+{
+public:
+	/// <summary>The most of a file that's read: the magic number, DDS_HEADER and DDS_HEADER_DXT10, 148 bytes</summary>
+	static const size_t HeaderBytes = sizeof(uint32_t) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10);
+
+	/// <summary>Reads what a DDS file holds from the start of it</summary>
+	/// <param name="data">The start of the file, with no alignment needed</param>
+	/// <param name="size">How much of the file is at data. Nothing past HeaderBytes is looked at</param>
+	/// <returns>false if the headers aren't valid, are cut short, or describe a texture DDSTextureLoader won't load</returns>
+	static bool Parse(const uint8_t* data, size_t size, DDSTextureInfo& info)
+	{
+		memset(&info, 0, sizeof(info));
+		if (data == nullptr || size < sizeof(uint32_t) + sizeof(DDS_HEADER))
+		{
+			return false;
+		}
+
+		uint32_t magic;
+		memcpy(&magic, data, sizeof(magic));
+		DDS_HEADER header;
+		memcpy(&header, data + sizeof(uint32_t), sizeof(header));
+		if (magic != DDS_MAGIC || header.size != sizeof(DDS_HEADER) || header.ddspf.size != sizeof(DDS_PIXELFORMAT))
+		{
+			return false;
+		}
+
+		uint64_t width = header.width;
+		uint64_t height = header.height;
+		uint64_t depth = header.depth;
+		uint64_t arraySize = 1;
+		uint64_t mipCount = header.mipMapCount != 0 ? header.mipMapCount : 1;
+		info.DataOffset = sizeof(uint32_t) + sizeof(DDS_HEADER);
+
+		if ((header.ddspf.flags & DDS_FOURCC) && header.ddspf.fourCC == MAKEFOURCC('D', 'X', '1', '0'))
+		{
+			if (size < HeaderBytes)
+			{
+				return false;
+			}
+			DDS_HEADER_DXT10 extension;
+			memcpy(&extension, data + sizeof(uint32_t) + sizeof(DDS_HEADER), sizeof(extension));
+			info.DataOffset = (uint32_t)HeaderBytes;
+
+			arraySize = extension.arraySize;
+			switch (extension.dxgiFormat)
+			{
+			case DXGI_FORMAT_AI44:
+			case DXGI_FORMAT_IA44:
+			case DXGI_FORMAT_P8:
+			case DXGI_FORMAT_A8P8:
+				return false;
+			default:
+				if (BitsPerPixel(extension.dxgiFormat) == 0)
+				{
+					return false;
+				}
+			}
+			info.Format = extension.dxgiFormat;
+
+			switch ((DDSDimension)extension.resourceDimension)
+			{
+			case DDSDimension::Texture1D:
+				//D3DX writes 1D textures with a fixed height of 1
+				if ((header.flags & DDS_HEIGHT) && height != 1)
+				{
+					return false;
+				}
+				height = 1;
+				depth = 1;
+				break;
+			case DDSDimension::Texture2D:
+				//D3D11_RESOURCE_MISC_TEXTURECUBE
+				if (extension.miscFlag & 0x4)
+				{
+					arraySize *= 6;
+					info.IsCubeMap = true;
+				}
+				depth = 1;
+				break;
+			case DDSDimension::Texture3D:
+				if (!(header.flags & DDS_HEADER_FLAGS_VOLUME) || arraySize > 1)
+				{
+					return false;
+				}
+				break;
+			default:
+				return false;
+			}
+			info.Dimension = (DDSDimension)extension.resourceDimension;
+		}
+		else
+		{
+			info.Format = GetDXGIFormat(header.ddspf);
+			if (info.Format == DXGI_FORMAT_UNKNOWN || BitsPerPixel(info.Format) == 0)
+			{
+				return false;
+			}
+
+			if (header.flags & DDS_HEADER_FLAGS_VOLUME)
+			{
+				info.Dimension = DDSDimension::Texture3D;
+			}
+			else
+			{
+				//All six faces of a cube map have to be there
+				if (header.caps2 & DDS_CUBEMAP)
+				{
+					if ((header.caps2 & DDS_CUBEMAP_ALLFACES) != DDS_CUBEMAP_ALLFACES)
+					{
+						return false;
+					}
+					arraySize = 6;
+					info.IsCubeMap = true;
+				}
+				depth = 1;
+				info.Dimension = DDSDimension::Texture2D;
+			}
+		}
+
+		//The limits of Direct3D 11 hardware, which DDSTextureLoader holds the file to as well
+		uint64_t maxArraySize = 2048;
+		uint64_t maxSize = 16384;
+		if (info.Dimension == DDSDimension::Texture3D)
+		{
+			maxArraySize = 1;
+			maxSize = 2048;
+		}
+		if (mipCount > DDSTextureInfo::MaxMipCount || arraySize == 0 || arraySize > maxArraySize
+			|| width == 0 || height == 0 || depth == 0 || width > maxSize || height > maxSize || depth > maxSize)
+		{
+			return false;
+		}
+
+		//Direct3D won't create more mips than it takes to get the largest side down to 1
+		uint64_t largest = std::max<uint64_t>(width, std::max<uint64_t>(height, depth));
+		uint64_t fullMipCount = 1;
+		while ((largest >> fullMipCount) != 0)
+		{
+			fullMipCount++;
+		}
+		if (mipCount > fullMipCount)
+		{
+			return false;
+		}
+
+		info.Width = (uint32_t)width;
+		info.Height = (uint32_t)height;
+		info.Depth = (uint32_t)depth;
+		info.ArraySize = (uint32_t)arraySize;
+		info.MipCount = (uint32_t)mipCount;
+
+		//Laid out the way FillInitData walks the pixel data: each slice in turn, with its mips largest first
+		uint64_t sliceBytes = 0;
+		for (uint32_t mip = 0; mip < info.MipCount; mip++)
+		{
+			size_t numBytes = 0;
+			size_t rowBytes = 0;
+			GetSurfaceInfo(GetMipWidth(info, mip), GetMipHeight(info, mip), info.Format, &numBytes, &rowBytes, nullptr);
+			info.MipBytes[mip] = (uint64_t)numBytes * GetMipDepth(info, mip);
+			info.MipRowBytes[mip] = rowBytes;
+			sliceBytes += info.MipBytes[mip];
+		}
+		info.DataBytes = sliceBytes * info.ArraySize;
+		return true;
+	}
+
+	/// <summary>Finds the mips of every slice DDSTextureLoader would upload from a whole DDS file, pointing into the file the way FillInitData does</summary>
+	/// <param name="data">The whole file, such as a MappedFile's view of it</param>
+	/// <param name="maxSize">Leaves out the mips bigger than this on any side, as DDSTextureLoader's maxsize does. 0 for none</param>
+	/// <param name="subresources">Each slice's mips from GetFirstMip on, slice by slice</param>
+	/// <returns>false if Parse fails, the file ends before the last mip does, or every mip is bigger than maxSize</returns>
+	static bool Slice(const uint8_t* data, size_t size, size_t maxSize, DDSTextureInfo& info, std::vector<DDSSubresource>& subresources)
+	{
+		subresources.clear();
+		if (!Parse(data, size, info))
+		{
+			return false;
+		}
+
+		subresources.resize((size_t)info.MipCount * info.ArraySize);
+		size_t width, height, depth, skipMip, count;
+		bool complete = SliceSubresources(info.Width, info.Height, info.Depth, info.MipCount, info.ArraySize, info.Format, maxSize,
+			size - info.DataOffset, data + info.DataOffset, width, height, depth, skipMip, subresources.data(), count);
+		subresources.resize(count);
+		return complete && count > 0;
+	}
+
+	/// <summary>Reads the first HeaderBytes of a DDS file and parses them, without reading any of the pixel data</summary>
+	/// <returns>false if the file can't be opened, Parse fails, or the file is too short to hold the pixel data the headers describe</returns>
+	static bool Probe(const std::string& path, DDSTextureInfo& info)
+	{
+		memset(&info, 0, sizeof(info));
+		FILE* file = fopen(path.c_str(), "rb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		uint8_t header[HeaderBytes];
+		size_t read = fread(header, 1, sizeof(header), file);
+		bool parsed = Parse(header, read, info);
+
+		//The size is found by seeking to the end, so only the headers are ever read
+		bool complete = false;
+		if (parsed && fseek(file, 0, SEEK_END) == 0)
+		{
+			long size = ftell(file);
+			complete = size >= 0 && (uint64_t)size >= info.DataOffset + info.DataBytes;
+		}
+		fclose(file);
+		return parsed && complete;
+	}
+
+	static uint32_t GetMipWidth(const DDSTextureInfo& info, uint32_t mip)
+	{
+		return std::max<uint32_t>(info.Width >> mip, 1);
+	}
+
+	static uint32_t GetMipHeight(const DDSTextureInfo& info, uint32_t mip)
+	{
+		return std::max<uint32_t>(info.Height >> mip, 1);
+	}
+
+	static uint32_t GetMipDepth(const DDSTextureInfo& info, uint32_t mip)
+	{
+		return std::max<uint32_t>(info.Depth >> mip, 1);
+	}
+
+	/// <summary>The first mip DDSTextureLoader uploads when given a maxsize: the largest no bigger than maxSize on any side</summary>
+	/// <param name="maxSize">0 for no limit, in which case it's 0</param>
+	/// <returns>MipCount if every mip is too big, which DDSTextureLoader fails to load</returns>
+	static uint32_t GetFirstMip(const DDSTextureInfo& info, size_t maxSize)
+	{
+		if (info.MipCount <= 1 || maxSize == 0)
+		{
+			return 0;
+		}
+
+		uint32_t mip = 0;
+		while (mip < info.MipCount && (GetMipWidth(info, mip) > maxSize || GetMipHeight(info, mip) > maxSize || GetMipDepth(info, mip) > maxSize))
+		{
+			mip++;
+		}
+		return mip;
+	}
+
+	/// <summary>The maxsize that makes DDSTextureLoader start from a mip, so GetFirstMip gives it back: its longest side</summary>
+	static size_t GetMaxSize(const DDSTextureInfo& info, uint32_t mip)
+	{
+		return std::max<uint32_t>(GetMipWidth(info, mip), std::max<uint32_t>(GetMipHeight(info, mip), GetMipDepth(info, mip)));
+	}
+
+	/// <summary>The bytes the texture takes up on the GPU with every mip before firstMip left out</summary>
+	static uint64_t GetBytes(const DDSTextureInfo& info, uint32_t firstMip)
+	{
+		uint64_t sliceBytes = 0;
+		for (uint32_t mip = firstMip; mip < info.MipCount; mip++)
+		{
+			sliceBytes += info.MipBytes[mip];
+		}
+		return sliceBytes * info.ArraySize;
+	}
+};
@@ -1,36 +1,270 @@
-#include "Application.h"
-
-int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, int nCmdShow)
-{
-    UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
-
-	Application * theApp = new Application();
-
-	if (FAILED(theApp->Initialise(hInstance, nCmdShow)))
-	{
-		return -1;
-	}
-
-    // Main message loop
-    MSG msg = {0};
-
-    while (WM_QUIT != msg.message)
-    {
-        if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
-        {
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        }
-        else
-        {
-			theApp->Update();
-            theApp->Draw();
-        }
-    }
-
-	delete theApp;
-	theApp = nullptr;
-
-    return (int) msg.wParam;
+#include "Application.h"
+#include "OBJLoader.h"
+#include "OBJParser.h"
+#include "Meshlets.h"
+#include "Normals.h"
+#include "GeometryAllocator.h"
+#include <cfloat>
+
+//Times the stream and mapped OBJ parsers over the largest models and writes the results to the debug output
+static void BenchmarkOBJParsers()
+{
+    const char* models[] =
+    {
+        "Models/Arch/Arch.obj",
+        "Models/Blacksmith/Blacksmith.obj",
+        "Models/3dsMax/torusKnot.obj",
+    };
+
+    for (const char* model : models)
+    {
+        OBJParserBenchmark result = OBJParser::Benchmark(model);
+
+        char line[256];
+        sprintf_s(line, "%-36s %8zu bytes  stream %8.2f MB/s  mapped %8.2f MB/s  parallel (%u threads) %8.2f MB/s  %s\n",
+            model, result.FileSize, result.StreamMBps, result.MappedMBps, result.Threads, result.ParallelMBps, result.Identical ? "identical" : "MISMATCH");
+        OutputDebugStringA(line);
+    }
+}
+
+//Imports the level's models, torusKnot and the multi-material Car without a GPU, so the welding, submesh, vertex cache, overdraw and level of detail reports
+//can be compared headlessly
+static void BenchmarkMeshImport()
+{
+    const char* models[] =
+    {
+        "Models/3dsMax/cube.obj",
+        "Models/3dsMax/cylinder.obj",
+        "Models/Arch/Arch.obj",
+        "Models/Blacksmith/Blacksmith.obj",
+        "Models/Plane/Plane.obj",
+        "Models/Warehouse/Warehouse.obj",
+        "Models/Skybox.obj",
+        "Models/3dsMax/torusKnot.obj",
+        "Models/Car/Car.obj",
+    };
+
+    for (const char* model : models)
+    {
+        std::vector<SimpleVertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<Meshlet> meshlets;
+        std::vector<MeshLod> lods;
+        std::vector<Submesh> submeshes;
+        OBJImporter::Import(model, vertices, indices, meshlets, lods, submeshes);
+    }
+}
+
+//Imports the big environment meshes and torusKnot and culls their meshlets from fixed camera poses around each mesh, so the number of
+//meshlets culled can be checked without a GPU. The poses are relative to each mesh's bounds, so every mesh is seen the same way
+static void BenchmarkMeshletCulling()
+{
+    const char* models[] =
+    {
+        "Models/Arch/Arch.obj",
+        "Models/Plane/Plane.obj",
+        "Models/Warehouse/Warehouse.obj",
+        "Models/3dsMax/torusKnot.obj",
+    };
+
+    struct CameraPose
+    {
+        const char* Name;
+        //Where the eye and target are, in units of the mesh's bounding radius from its centre
+        XMFLOAT3 Eye;
+        XMFLOAT3 At;
+    };
+    const CameraPose poses[] =
+    {
+        { "front", XMFLOAT3(0.0f, 0.0f, -2.0f), XMFLOAT3(0.0f, 0.0f, 0.0f) },
+        { "above", XMFLOAT3(0.0f, 2.0f, -0.5f), XMFLOAT3(0.0f, 0.0f, 0.0f) },
+        { "close", XMFLOAT3(0.5f, 0.1f, -0.6f), XMFLOAT3(0.5f, 0.1f, 0.0f) },
+        { "inside", XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 0.0f) },
+        { "away", XMFLOAT3(0.0f, 0.0f, -2.0f), XMFLOAT3(0.0f, 0.0f, -3.0f) },
+    };
+
+    XMFLOAT4X4 world;
+    XMStoreFloat4x4(&world, XMMatrixIdentity());
+
+    for (const char* model : models)
+    {
+        std::vector<SimpleVertex> vertices;
+        std::vector<unsigned int> indices;
+        std::vector<Meshlet> meshlets;
+        std::vector<MeshLod> lods;
+        std::vector<Submesh> submeshes;
+        if (!OBJImporter::Import(model, vertices, indices, meshlets, lods, submeshes))
+        {
+            continue;
+        }
+
+        size_t fullDetailIndices = 0;
+        for (const Submesh& submesh : submeshes)
+        {
+            fullDetailIndices += submesh.IndexCount;
+        }
+
+        //The centre and size of the whole mesh, from the box around its meshlets' spheres
+        XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+        XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+        for (const Meshlet& meshlet : meshlets)
+        {
+            XMVECTOR center = XMVectorSet(meshlet.Center[0], meshlet.Center[1], meshlet.Center[2], 0.0f);
+            minimum = XMVectorMin(minimum, XMVectorSubtract(center, XMVectorReplicate(meshlet.Radius)));
+            maximum = XMVectorMax(maximum, XMVectorAdd(center, XMVectorReplicate(meshlet.Radius)));
+        }
+        XMVECTOR center = XMVectorScale(XMVectorAdd(minimum, maximum), 0.5f);
+        float radius = XMVectorGetX(XMVector3Length(XMVectorSubtract(maximum, center)));
+
+        std::vector<MeshletDrawRange> ranges;
+        for (const CameraPose& pose : poses)
+        {
+            //The far plane is scaled with the mesh, so the whole of it is always in range
+            XMVECTOR eye = XMVectorAdd(center, XMVectorScale(XMLoadFloat3(&pose.Eye), radius));
+            XMVECTOR at = XMVectorAdd(center, XMVectorScale(XMLoadFloat3(&pose.At), radius));
+            XMMATRIX view = XMMatrixLookAtLH(eye, at, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV2, 16.0f / 9.0f, radius * 0.001f, radius * 4.0f);
+
+            XMFLOAT4X4 viewProjection;
+            XMStoreFloat4x4(&viewProjection, XMMatrixMultiply(view, projection));
+            XMFLOAT3 eyePosition;
+            XMStoreFloat3(&eyePosition, eye);
+
+            MeshletCullStatistics statistics = Meshlets::Cull(meshlets, Meshlets::CreateCullingView(world, viewProjection, eyePosition, true), ranges);
+
+            size_t drawnIndices = 0;
+            for (const MeshletDrawRange& range : ranges)
+            {
+                drawnIndices += range.IndexCount;
+            }
+
+            char line[256];
+            sprintf_s(line, "%-32s %-6s %6u meshlets  %6u outside the frustum  %6u facing away  %6u drawn in %5u DrawIndexed calls  %6zu of %6zu triangles drawn\n",
+                model, pose.Name, statistics.MeshletCount, statistics.FrustumCulled, statistics.BackfaceCulled,
+                statistics.MeshletCount - statistics.FrustumCulled - statistics.BackfaceCulled, statistics.DrawRanges, drawnIndices / 3, fullDetailIndices / 3);
+            OutputDebugStringA(line);
+        }
+    }
+}
+
+//Cooks the biggest models and times loading their binary meshes raw and compressed, from a cold and a warm page cache
+static void BenchmarkMeshCache()
+{
+    const char* models[] =
+    {
+        "Models/Arch/Arch.obj",
+        "Models/Blacksmith/Blacksmith.obj",
+        "Models/Plane/Plane.obj",
+        "Models/Warehouse/Warehouse.obj",
+        "Models/3dsMax/torusKnot.obj",
+    };
+    const VertexFormat formats[] = { VertexFormat::Float, VertexFormat::Compact };
+
+    for (const char* model : models)
+    {
+        MeshSourceInfo source;
+        if (!MeshBinary::GetSourceInfo(model, source, true))
+        {
+            continue;
+        }
+
+        for (VertexFormat format : formats)
+        {
+            CookedMesh mesh;
+            if (!OBJImporter::Cook(model, mesh, true, format))
+            {
+                continue;
+            }
+
+            std::string binaryFilename = std::string(model) + "Binary.benchmark";
+            MeshBinaryBenchmark result = MeshBinary::Benchmark(binaryFilename, model, source, mesh.Contents);
+
+            char line[384];
+            sprintf_s(line, "%-36s %-7s raw %9zu bytes  compressed %9zu bytes (%5.1f%%)  cold %7.3f -> %7.3f ms  warm %7.3f -> %7.3f ms  decode %5.2f GB/s  %s\n",
+                model, VertexFormats::GetName(format), result.RawSize, result.CompressedSize, result.RawSize ? 100.0 * result.CompressedSize / result.RawSize : 0.0,
+                result.RawColdMs, result.CompressedColdMs, result.RawWarmMs, result.CompressedWarmMs, result.DecodeGBps, result.Identical ? "identical" : "MISMATCH");
+            OutputDebugStringA(line);
+        }
+    }
+}
+
+//Generates torusKnot's smooth normals with the original one triangle at a time code and the SIMD, threaded version, and reports
+//how long each takes and how far apart their normals are
+static void BenchmarkNormals()
+{
+    const char* model = "Models/3dsMax/torusKnot.obj";
+
+    std::vector<SimpleVertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshLod> lods;
+    std::vector<Submesh> submeshes;
+    OBJImporter::Import(model, vertices, indices, meshlets, lods, submeshes);
+
+    NormalsBenchmark result = Normals::Benchmark(vertices, indices);
+
+    char line[320];
+    sprintf_s(line, "%-36s %7zu vertices %7zu triangles  reference %8.3f ms  streamed (%u threads) %8.3f ms  core only %8.3f ms  max error %g  %s\n",
+        model, result.VertexCount, result.TriangleCount, result.ReferenceMs, result.Threads, result.TotalMs, result.StreamsMs, result.MaxError,
+        result.MaxError <= Normals::MatchEpsilon ? "matches" : "MISMATCH");
+    OutputDebugStringA(line);
+}
+
+//Churns the geometry pool's allocator the way levels loading and unloading meshes would, and reports how fragmented it gets, what defragmenting
+//it does, and whether it stayed consistent throughout
+static void BenchmarkGeometryAllocator()
+{
+    GeometryChurnResult result = GeometryAllocator::Churn(4 * 1024 * 1024, 100000);
+
+    char line[320];
+    sprintf_s(line, "geometry allocator  %u allocations %u frees  %u failed from fragmentation  fragmentation peak %5.1f%% average %5.1f%%  %u free blocks defragmented in %u moves  %6.1f ns per operation  %s\n",
+        result.Allocations, result.Frees, result.FragmentedFailures, result.PeakFragmentation * 100.0f, result.AverageFragmentation * 100.0f,
+        result.Churned.FreeBlockCount, result.MoveCount, result.Seconds * 1e9 / 100000, result.Valid ? "valid" : "INVALID");
+    OutputDebugStringA(line);
+}
+
+int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLine, int nCmdShow)
+{
+    UNREFERENCED_PARAMETER(hPrevInstance);
+
+    //Run with -benchmark to time the model parsers and binary mesh loads, and report what the import optimizations and meshlet culling save, compare the smooth normal generators, and churn the geometry allocator, instead of starting the game
+    if (wcsstr(lpCmdLine, L"-benchmark") != nullptr)
+    {
+        BenchmarkOBJParsers();
+        BenchmarkMeshImport();
+        BenchmarkMeshletCulling();
+        BenchmarkMeshCache();
+        BenchmarkNormals();
+        BenchmarkGeometryAllocator();
+        return 0;
+    }
+
+	Application * theApp = new Application();
+
+	if (FAILED(theApp->Initialise(hInstance, nCmdShow)))
+	{
+		return -1;
+	}
+
+    // Main message loop
+    MSG msg = {0};
+
+    while (WM_QUIT != msg.message)
+    {
+        if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+        {
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+        else
+        {
+			theApp->Update();
+            theApp->Draw();
+        }
+    }
+
+	delete theApp;
+	theApp = nullptr;
+
+    return (int) msg.wParam;
 }
\ No newline at end of file
@@ -0,0 +1,562 @@
+#include "GeometryAllocator.h"
+#include <algorithm>
+#include <chrono>		//For timing Churn
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+GeometryAllocator::GeometryAllocator(uint32_t capacity)
+{
+	m_firstBlock = NoBlock;
+	m_lastBlock = NoBlock;
+	m_firstLevelBitmap = 0;
+	for (uint32_t first = 0; first < FirstLevelCount; first++)
+	{
+		m_secondLevelBitmaps[first] = 0;
+		for (uint32_t second = 0; second < SecondLevelCount; second++)
+		{
+			m_freeLists[first][second] = NoBlock;
+		}
+	}
+	m_capacity = 0;
+	m_usedUnits = 0;
+	m_allocationCount = 0;
+	m_freeBlockCount = 0;
+
+	Grow(capacity);
+}
+
+uint32_t GeometryAllocator::FindLowestBit(uint32_t value)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return index;
+#else
+	return (uint32_t)__builtin_ctz(value);
+#endif
+}
+
+uint32_t GeometryAllocator::FindHighestBit(uint32_t value)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse(&index, value);
+	return index;
+#else
+	return 31 - (uint32_t)__builtin_clz(value);
+#endif
+}
+
+void GeometryAllocator::GetBin(uint32_t size, uint32_t& firstLevel, uint32_t& secondLevel)
+{
+	//Small sizes each get a bin of their own, bigger ones are split into SecondLevelCount bins per power of 2
+	if (size < SecondLevelCount)
+	{
+		firstLevel = 0;
+		secondLevel = size;
+		return;
+	}
+
+	uint32_t highest = FindHighestBit(size);
+	secondLevel = (size >> (highest - SecondLevelBits)) ^ SecondLevelCount;
+	firstLevel = highest - SecondLevelBits + 1;
+}
+
+uint32_t GeometryAllocator::CreateBlock(uint32_t offset, uint32_t size)
+{
+	uint32_t block;
+	if (!m_unusedBlocks.empty())
+	{
+		block = m_unusedBlocks.back();
+		m_unusedBlocks.pop_back();
+	}
+	else
+	{
+		block = (uint32_t)m_blocks.size();
+		m_blocks.push_back(Block());
+	}
+
+	Block& created = m_blocks[block];
+	created.Offset = offset;
+	created.Size = size;
+	created.PreviousPhysical = NoBlock;
+	created.NextPhysical = NoBlock;
+	created.PreviousFree = NoBlock;
+	created.NextFree = NoBlock;
+	created.Free = false;
+	return block;
+}
+
+void GeometryAllocator::DestroyBlock(uint32_t block)
+{
+	//A size of 0 marks it unused, so a stale handle passed to Free is ignored
+	m_blocks[block].Size = 0;
+	m_blocks[block].Free = false;
+	m_unusedBlocks.push_back(block);
+}
+
+void GeometryAllocator::LinkAfter(uint32_t previous, uint32_t block)
+{
+	uint32_t next = previous != NoBlock ? m_blocks[previous].NextPhysical : m_firstBlock;
+	m_blocks[block].PreviousPhysical = previous;
+	m_blocks[block].NextPhysical = next;
+
+	if (previous != NoBlock) m_blocks[previous].NextPhysical = block;
+	else m_firstBlock = block;
+
+	if (next != NoBlock) m_blocks[next].PreviousPhysical = block;
+	else m_lastBlock = block;
+}
+
+void GeometryAllocator::Merge(uint32_t block, uint32_t next)
+{
+	uint32_t after = m_blocks[next].NextPhysical;
+	m_blocks[block].Size += m_blocks[next].Size;
+	m_blocks[block].NextPhysical = after;
+
+	if (after != NoBlock) m_blocks[after].PreviousPhysical = block;
+	else m_lastBlock = block;
+
+	DestroyBlock(next);
+}
+
+void GeometryAllocator::InsertFree(uint32_t block)
+{
+	uint32_t first, second;
+	GetBin(m_blocks[block].Size, first, second);
+
+	uint32_t head = m_freeLists[first][second];
+	m_blocks[block].Free = true;
+	m_blocks[block].PreviousFree = NoBlock;
+	m_blocks[block].NextFree = head;
+	if (head != NoBlock)
+	{
+		m_blocks[head].PreviousFree = block;
+	}
+	m_freeLists[first][second] = block;
+
+	m_firstLevelBitmap |= 1u << first;
+	m_secondLevelBitmaps[first] |= 1u << second;
+	m_freeBlockCount++;
+}
+
+void GeometryAllocator::RemoveFree(uint32_t block)
+{
+	uint32_t first, second;
+	GetBin(m_blocks[block].Size, first, second);
+
+	Block& removed = m_blocks[block];
+	if (removed.PreviousFree != NoBlock) m_blocks[removed.PreviousFree].NextFree = removed.NextFree;
+	else m_freeLists[first][second] = removed.NextFree;
+	if (removed.NextFree != NoBlock) m_blocks[removed.NextFree].PreviousFree = removed.PreviousFree;
+
+	//The bin's bit goes when its list empties, and the first level's when every bin in it has
+	if (m_freeLists[first][second] == NoBlock)
+	{
+		m_secondLevelBitmaps[first] &= ~(1u << second);
+		if (m_secondLevelBitmaps[first] == 0)
+		{
+			m_firstLevelBitmap &= ~(1u << first);
+		}
+	}
+
+	removed.Free = false;
+	removed.PreviousFree = NoBlock;
+	removed.NextFree = NoBlock;
+	m_freeBlockCount--;
+}
+
+uint32_t GeometryAllocator::FindFree(uint32_t size) const
+{
+	uint32_t first, second;
+
+	//Rounded up to the start of the next bin, so any block in that bin or above is big enough without looking at its size
+	uint64_t rounded = size;
+	if (size >= SecondLevelCount)
+	{
+		rounded += (1ull << (FindHighestBit(size) - SecondLevelBits)) - 1;
+	}
+	if (rounded <= 0xFFFFFFFF)
+	{
+		GetBin((uint32_t)rounded, first, second);
+		uint32_t secondMap = m_secondLevelBitmaps[first] & (~0u << second);
+		if (secondMap == 0)
+		{
+			uint32_t firstMap = m_firstLevelBitmap & (~0u << (first + 1));
+			if (firstMap != 0)
+			{
+				first = FindLowestBit(firstMap);
+				secondMap = m_secondLevelBitmaps[first];
+			}
+		}
+		if (secondMap != 0)
+		{
+			return m_freeLists[first][FindLowestBit(secondMap)];
+		}
+	}
+
+	//Nothing in the bins above, but a block in size's own bin may still be big enough, which matters most when the buffer is nearly full
+	GetBin(size, first, second);
+	for (uint32_t block = m_freeLists[first][second]; block != NoBlock; block = m_blocks[block].NextFree)
+	{
+		if (m_blocks[block].Size >= size)
+		{
+			return block;
+		}
+	}
+	return NoBlock;
+}
+
+uint32_t GeometryAllocator::Allocate(uint32_t size)
+{
+	if (size == 0)
+	{
+		return InvalidAllocation;
+	}
+
+	uint32_t block = FindFree(size);
+	if (block == NoBlock)
+	{
+		return InvalidAllocation;
+	}
+	RemoveFree(block);
+
+	//Whatever's left over goes back as a free block of its own
+	uint32_t remaining = m_blocks[block].Size - size;
+	if (remaining != 0)
+	{
+		uint32_t rest = CreateBlock(m_blocks[block].Offset + size, remaining);
+		m_blocks[block].Size = size;
+		LinkAfter(block, rest);
+		InsertFree(rest);
+	}
+
+	m_usedUnits += size;
+	m_allocationCount++;
+	return block;
+}
+
+void GeometryAllocator::Free(uint32_t allocation)
+{
+	if (allocation >= m_blocks.size() || m_blocks[allocation].Free || m_blocks[allocation].Size == 0)
+	{
+		return;
+	}
+
+	m_usedUnits -= m_blocks[allocation].Size;
+	m_allocationCount--;
+
+	//Free blocks never sit next to each other, so there's at most one on each side to merge with
+	uint32_t block = allocation;
+	uint32_t previous = m_blocks[block].PreviousPhysical;
+	if (previous != NoBlock && m_blocks[previous].Free)
+	{
+		RemoveFree(previous);
+		Merge(previous, block);
+		block = previous;
+	}
+	uint32_t next = m_blocks[block].NextPhysical;
+	if (next != NoBlock && m_blocks[next].Free)
+	{
+		RemoveFree(next);
+		Merge(block, next);
+	}
+	InsertFree(block);
+}
+
+uint32_t GeometryAllocator::GetOffset(uint32_t allocation) const
+{
+	return m_blocks[allocation].Offset;
+}
+
+uint32_t GeometryAllocator::GetSize(uint32_t allocation) const
+{
+	return m_blocks[allocation].Size;
+}
+
+void GeometryAllocator::Grow(uint32_t newCapacity)
+{
+	if (newCapacity <= m_capacity)
+	{
+		return;
+	}
+
+	uint32_t added = newCapacity - m_capacity;
+	if (m_lastBlock != NoBlock && m_blocks[m_lastBlock].Free)
+	{
+		//Rebinned, as it's bigger now
+		uint32_t last = m_lastBlock;
+		RemoveFree(last);
+		m_blocks[last].Size += added;
+		InsertFree(last);
+	}
+	else
+	{
+		uint32_t block = CreateBlock(m_capacity, added);
+		LinkAfter(m_lastBlock, block);
+		InsertFree(block);
+	}
+	m_capacity = newCapacity;
+}
+
+void GeometryAllocator::Defragment(std::vector<GeometryMove>& moves)
+{
+	moves.clear();
+
+	//Rebuilds the offset ordered list from the allocated blocks alone, packing each down against the one before
+	uint32_t offset = 0;
+	uint32_t previous = NoBlock;
+	uint32_t block = m_firstBlock;
+	m_firstBlock = NoBlock;
+	while (block != NoBlock)
+	{
+		uint32_t next = m_blocks[block].NextPhysical;
+		if (m_blocks[block].Free)
+		{
+			RemoveFree(block);
+			DestroyBlock(block);
+			block = next;
+			continue;
+		}
+
+		Block& moved = m_blocks[block];
+		if (moved.Offset != offset)
+		{
+			//Allocations that were next to each other stay next to each other, so they can be copied in one go
+			if (!moves.empty() && moves.back().From + moves.back().Size == moved.Offset && moves.back().To + moves.back().Size == offset)
+			{
+				moves.back().Size += moved.Size;
+			}
+			else
+			{
+				moves.push_back({ moved.Offset, offset, moved.Size });
+			}
+			moved.Offset = offset;
+		}
+
+		moved.PreviousPhysical = previous;
+		moved.NextPhysical = NoBlock;
+		if (previous != NoBlock) m_blocks[previous].NextPhysical = block;
+		else m_firstBlock = block;
+
+		offset += moved.Size;
+		previous = block;
+		block = next;
+	}
+	m_lastBlock = previous;
+
+	if (offset < m_capacity)
+	{
+		uint32_t free = CreateBlock(offset, m_capacity - offset);
+		LinkAfter(m_lastBlock, free);
+		InsertFree(free);
+	}
+}
+
+GeometryAllocatorStats GeometryAllocator::GetStats() const
+{
+	GeometryAllocatorStats stats;
+	stats.Capacity = m_capacity;
+	stats.UsedUnits = m_usedUnits;
+	stats.FreeUnits = m_capacity - m_usedUnits;
+	stats.AllocationCount = m_allocationCount;
+	stats.FreeBlockCount = m_freeBlockCount;
+
+	//The largest free block is in the highest bin with anything in, though not necessarily first in its list
+	stats.LargestFreeBlock = 0;
+	if (m_firstLevelBitmap != 0)
+	{
+		uint32_t first = FindHighestBit(m_firstLevelBitmap);
+		uint32_t second = FindHighestBit(m_secondLevelBitmaps[first]);
+		for (uint32_t block = m_freeLists[first][second]; block != NoBlock; block = m_blocks[block].NextFree)
+		{
+			stats.LargestFreeBlock = std::max<uint32_t>(stats.LargestFreeBlock, m_blocks[block].Size);
+		}
+	}
+	stats.Fragmentation = stats.FreeUnits != 0 ? 1.0f - (float)stats.LargestFreeBlock / stats.FreeUnits : 0.0f;
+	return stats;
+}
+
+uint32_t GeometryAllocator::GetCapacity() const
+{
+	return m_capacity;
+}
+
+bool GeometryAllocator::Validate() const
+{
+	//The blocks in offset order cover the whole range with no gaps, and no two free blocks are neighbours
+	uint32_t offset = 0;
+	uint32_t used = 0;
+	uint32_t allocations = 0;
+	uint32_t freeBlocks = 0;
+	uint32_t previous = NoBlock;
+	for (uint32_t block = m_firstBlock; block != NoBlock; block = m_blocks[block].NextPhysical)
+	{
+		const Block& checked = m_blocks[block];
+		if (checked.PreviousPhysical != previous || checked.Offset != offset || checked.Size == 0)
+		{
+			return false;
+		}
+		if (checked.Free)
+		{
+			if (previous != NoBlock && m_blocks[previous].Free)
+			{
+				return false;
+			}
+			freeBlocks++;
+		}
+		else
+		{
+			used += checked.Size;
+			allocations++;
+		}
+		offset += checked.Size;
+		previous = block;
+	}
+	if (previous != m_lastBlock || offset != m_capacity || used != m_usedUnits || allocations != m_allocationCount || freeBlocks != m_freeBlockCount)
+	{
+		return false;
+	}
+
+	//Every free block is in the list of the bin its size maps to, and the bitmaps say which lists have anything in
+	uint32_t listed = 0;
+	for (uint32_t first = 0; first < FirstLevelCount; first++)
+	{
+		for (uint32_t second = 0; second < SecondLevelCount; second++)
+		{
+			uint32_t head = m_freeLists[first][second];
+			if ((head != NoBlock) != ((m_secondLevelBitmaps[first] >> second) & 1))
+			{
+				return false;
+			}
+
+			uint32_t previousFree = NoBlock;
+			for (uint32_t block = head; block != NoBlock; block = m_blocks[block].NextFree)
+			{
+				uint32_t blockFirst, blockSecond;
+				GetBin(m_blocks[block].Size, blockFirst, blockSecond);
+				if (!m_blocks[block].Free || m_blocks[block].PreviousFree != previousFree || blockFirst != first || blockSecond != second)
+				{
+					return false;
+				}
+				previousFree = block;
+				listed++;
+			}
+		}
+		if ((m_secondLevelBitmaps[first] != 0) != ((m_firstLevelBitmap >> first) & 1))
+		{
+			return false;
+		}
+	}
+	return listed == m_freeBlockCount;
+}
+
+GeometryChurnResult GeometryAllocator::Churn(uint32_t capacity, uint32_t operations, uint32_t seed)
+{
+	GeometryChurnResult result;
+	memset(&result, 0, sizeof(result));
+	result.Valid = true;
+
+	GeometryAllocator allocator(capacity);
+	//Stands in for the buffer: each allocation's units hold its handle, so overlapping allocations and bad moves show up as the wrong value
+	std::vector<uint32_t> memory(capacity, NoBlock);
+	std::vector<uint32_t> live;
+
+	//xorshift, so every run and platform churns the same way
+	uint32_t state = seed != 0 ? seed : 1;
+	auto random = [&state]()
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	};
+
+	//Sizes from 64 units up to a 32nd of the capacity, spread evenly over each power of 2 so there are as many small meshes as big ones
+	uint32_t smallest = 64;
+	uint32_t sizeShifts = 1;
+	while ((smallest << sizeShifts) < capacity / 32)
+	{
+		sizeShifts++;
+	}
+
+	double fragmentation = 0.0;
+	double seconds = 0.0;
+	for (uint32_t operation = 0; operation < operations; operation++)
+	{
+		//Slightly more allocations than frees, so the allocator fills up and then stays nearly full
+		if (live.empty() || random() % 100 < 55)
+		{
+			uint32_t size = smallest << (random() % sizeShifts);
+			size += random() % size;
+
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			uint32_t allocation = allocator.Allocate(size);
+			seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+			if (allocation == InvalidAllocation)
+			{
+				if (allocator.GetStats().FreeUnits >= size)
+				{
+					result.FragmentedFailures++;
+				}
+			}
+			else
+			{
+				uint32_t* units = memory.data() + allocator.GetOffset(allocation);
+				result.Valid &= allocator.GetSize(allocation) == size && std::count(units, units + size, NoBlock) == size;
+				std::fill(units, units + size, allocation);
+				live.push_back(allocation);
+				result.Allocations++;
+			}
+		}
+		else
+		{
+			size_t index = random() % live.size();
+			uint32_t allocation = live[index];
+			live[index] = live.back();
+			live.pop_back();
+
+			uint32_t* units = memory.data() + allocator.GetOffset(allocation);
+			uint32_t size = allocator.GetSize(allocation);
+			result.Valid &= std::count(units, units + size, allocation) == size;
+			std::fill(units, units + size, NoBlock);
+
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			allocator.Free(allocation);
+			seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+			result.Frees++;
+		}
+
+		result.Valid &= allocator.Validate();
+		float current = allocator.GetStats().Fragmentation;
+		result.PeakFragmentation = std::max<float>(result.PeakFragmentation, current);
+		fragmentation += current;
+	}
+	result.AverageFragmentation = operations != 0 ? (float)(fragmentation / operations) : 0.0f;
+	result.Churned = allocator.GetStats();
+
+	//Copies the moves the way GeometryPool would, then checks every allocation still finds its own contents where it now is
+	std::vector<GeometryMove> moves;
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	allocator.Defragment(moves);
+	seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	for (const GeometryMove& move : moves)
+	{
+		memmove(memory.data() + move.To, memory.data() + move.From, move.Size * sizeof(uint32_t));
+	}
+	for (uint32_t allocation : live)
+	{
+		const uint32_t* units = memory.data() + allocator.GetOffset(allocation);
+		uint32_t size = allocator.GetSize(allocation);
+		result.Valid &= std::count(units, units + size, allocation) == size;
+	}
+
+	result.Defragmented = allocator.GetStats();
+	result.Valid &= allocator.Validate() && result.Defragmented.FreeBlockCount <= 1 && result.Defragmented.UsedUnits == result.Churned.UsedUnits;
+	result.MoveCount = (uint32_t)moves.size();
+	result.Seconds = seconds;
+	return result;
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/// <summary>How full a GeometryAllocator is, and how broken up its free space is</summary>
+struct GeometryAllocatorStats
+{
+	/// <summary>Everything in the allocator's range, in units, whatever a unit is to its owner: a vertex or an index in GeometryPool</summary>
+	uint32_t Capacity;
+	uint32_t UsedUnits;
+	uint32_t FreeUnits;
+	uint32_t AllocationCount;
+	/// <summary>How many separate runs the free units are split into</summary>
+	uint32_t FreeBlockCount;
+	uint32_t LargestFreeBlock;
+	/// <summary>1 - LargestFreeBlock / FreeUnits: 0 when the free space is all one block, near 1 when most of it is in pieces too small to use</summary>
+	float Fragmentation;
+};
+
+/// <summary>One allocation moved by GeometryAllocator::Defragment, which its owner has to copy the contents of</summary>
+struct GeometryMove
+{
+	uint32_t From;
+	uint32_t To;
+	uint32_t Size;
+};
+
+/// <summary>What GeometryAllocator::Churn found</summary>
+struct GeometryChurnResult
+{
+	uint32_t Allocations;
+	uint32_t Frees;
+	/// <summary>Allocations that failed even though there were enough free units in total, which only fragmentation causes</summary>
+	uint32_t FragmentedFailures;
+	/// <summary>The most fragmented the allocator was after any operation, and on average over every operation</summary>
+	float PeakFragmentation;
+	float AverageFragmentation;
+	/// <summary>The allocator at the end of the churn, then after defragmenting it</summary>
+	GeometryAllocatorStats Churned;
+	GeometryAllocatorStats Defragmented;
+	/// <summary>How many copies Defragment asked for, after merging neighbouring ones</summary>
+	uint32_t MoveCount;
+	double Seconds;
+	/// <summary>Whether the allocator's blocks and free lists were consistent after every operation, no two allocations ever overlapped, and
+	/// every allocation's contents were where it said after the moves were copied</summary>
+	bool Valid;
+};
+
+/// <summary><para>Hands out ranges of one big buffer, so many meshes can share it. Knows nothing about the buffer itself: it works in units
+/// within 0 to its capacity, and its owner turns them into bytes, see GeometryPool. </para>
+/// <para>It's a two-level segregated fit (TLSF) allocator. Free blocks are kept in lists binned by the highest bit of their size and the four bits below it,
+/// with a bitmap of which bins have anything in, so finding a block big enough, splitting it and merging freed blocks with their neighbours are all
+/// constant time however many blocks there are. </para>
+/// <para>Meshes come and go in any order, so free space ends up scattered between them. Defragment slides every allocation down to the start of the range,
+/// leaving the free space in one block at the end, and lists what moved so the owner can copy it. Allocations keep their handles when they move.</para></summary>
+class GeometryAllocator
+{
+public:
+	/// <summary>Returned by Allocate when nothing was allocated</summary>
+	static const uint32_t InvalidAllocation = 0xFFFFFFFF;
+
+private:
+	static const uint32_t SecondLevelBits = 4;
+	static const uint32_t SecondLevelCount = 1 << SecondLevelBits;
+	/// <summary>Sizes under SecondLevelCount share the first bin list, then one per bit up to the 32nd</summary>
+	static const uint32_t FirstLevelCount = 32 - SecondLevelBits + 1;
+	static const uint32_t NoBlock = 0xFFFFFFFF;
+
+	/// <summary>A run of units, either allocated or free. Every block is in one list in offset order, and free blocks are also in their bin's list</summary>
+	struct Block
+	{
+		uint32_t Offset;
+		uint32_t Size;
+		uint32_t PreviousPhysical;
+		uint32_t NextPhysical;
+		uint32_t PreviousFree;
+		uint32_t NextFree;
+		bool Free;
+	};
+
+	/// <summary>Every block, indexed by handle. Blocks merged away are put on m_unusedBlocks to be reused</summary>
+	std::vector<Block> m_blocks;
+	std::vector<uint32_t> m_unusedBlocks;
+	uint32_t m_firstBlock;
+	uint32_t m_lastBlock;
+
+	/// <summary>Bit f is set if any bin in first level f has a free block, and bit s of m_secondLevelBitmaps[f] if bin (f, s) does</summary>
+	uint32_t m_firstLevelBitmap;
+	uint32_t m_secondLevelBitmaps[FirstLevelCount];
+	uint32_t m_freeLists[FirstLevelCount][SecondLevelCount];
+
+	uint32_t m_capacity;
+	uint32_t m_usedUnits;
+	uint32_t m_allocationCount;
+	uint32_t m_freeBlockCount;
+
+public:
+	/// <param name="capacity">How many units there are to hand out</param>
+	GeometryAllocator(uint32_t capacity = 0);
+
+	/// <summary>Finds size units in a row</summary>
+	/// <returns>A handle to the allocation, or InvalidAllocation if there isn't a free block big enough, or size is 0</returns>
+	uint32_t Allocate(uint32_t size);
+	/// <summary>Gives an allocation's units back, merging them with any free neighbours</summary>
+	void Free(uint32_t allocation);
+
+	/// <summary>Where an allocation starts, which changes if Defragment moves it</summary>
+	uint32_t GetOffset(uint32_t allocation) const;
+	uint32_t GetSize(uint32_t allocation) const;
+
+	/// <summary>Extends the range to newCapacity units, adding the new ones to the free block at the end if there is one. Nothing moves</summary>
+	void Grow(uint32_t newCapacity);
+
+	/// <summary>Moves every allocation down to the start of the range in the order they're in, so the free space is one block at the end</summary>
+	/// <param name="moves">Set to what to copy where, in offset order. Moves only ever go down and neighbouring ones are merged, so copying
+	/// them in order within one buffer with memmove is safe</param>
+	void Defragment(std::vector<GeometryMove>& moves);
+
+	GeometryAllocatorStats GetStats() const;
+	uint32_t GetCapacity() const;
+
+	/// <summary>Walks every block and free list to check they agree with each other and the counts kept</summary>
+	bool Validate() const;
+
+	/// <summary>Allocates and frees operations times, a fixed random mix of sizes from small props to large meshes, the way levels loading and unloading
+	/// meshes would, checking the allocator after each one and measuring how fragmented it gets. Then defragments it and checks every allocation's
+	/// contents survived the moves. Builds without Direct3D, so ImportBenchmark --allocator runs it on Linux too</summary>
+	static GeometryChurnResult Churn(uint32_t capacity, uint32_t operations, uint32_t seed = 1);
+
+private:
+	uint32_t CreateBlock(uint32_t offset, uint32_t size);
+	void DestroyBlock(uint32_t block);
+
+	/// <summary>Adds next's units onto the end of block, its neighbour below, and destroys next</summary>
+	void Merge(uint32_t block, uint32_t next);
+	/// <summary>Links block into the offset ordered list straight after previous, or first if previous is NoBlock</summary>
+	void LinkAfter(uint32_t previous, uint32_t block);
+
+	void InsertFree(uint32_t block);
+	void RemoveFree(uint32_t block);
+	uint32_t FindFree(uint32_t size) const;
+
+	static void GetBin(uint32_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+	static uint32_t FindLowestBit(uint32_t value);
+	static uint32_t FindHighestBit(uint32_t value);
+};
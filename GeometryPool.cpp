@@ -0,0 +1,331 @@
+#include "GeometryPool.h"
+#include <algorithm>
+#include <cstdio>
+
+GeometryPool::GeometryPool(ID3D11Device* d3dDevice, ID3D11DeviceContext* immediateContext)
+{
+	m_d3dDevice = d3dDevice;
+	m_immediateContext = immediateContext;
+
+	//Each buffer is created when the first mesh that needs it is added, so formats no mesh uses cost nothing
+	for (UINT format = 0; format < VertexFormatCount; format++)
+	{
+		m_vertexBuffers[format].Buffer = nullptr;
+		m_vertexBuffers[format].ElementSize = VertexFormats::GetLayout((VertexFormat)format).Stride;
+		m_vertexBuffers[format].BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	}
+	for (UINT i = 0; i < 2; i++)
+	{
+		m_indexBuffers[i].Buffer = nullptr;
+		m_indexBuffers[i].ElementSize = i == 0 ? sizeof(WORD) : sizeof(UINT);
+		m_indexBuffers[i].BindFlags = D3D11_BIND_INDEX_BUFFER;
+	}
+
+	m_boundVertexBuffer = nullptr;
+	m_boundIndexBuffer = nullptr;
+	ZeroMemory(&m_stats, sizeof(m_stats));
+}
+
+GeometryPool::~GeometryPool()
+{
+	for (PooledBuffer& pooled : m_vertexBuffers)
+	{
+		if (pooled.Buffer) pooled.Buffer->Release();
+	}
+	for (PooledBuffer& pooled : m_indexBuffers)
+	{
+		if (pooled.Buffer) pooled.Buffer->Release();
+	}
+}
+
+GeometryPool::PooledBuffer& GeometryPool::GetIndexBuffer(DXGI_FORMAT indexFormat)
+{
+	return m_indexBuffers[indexFormat == DXGI_FORMAT_R32_UINT ? 1 : 0];
+}
+
+const GeometryPool::PooledBuffer& GeometryPool::GetIndexBuffer(DXGI_FORMAT indexFormat) const
+{
+	return m_indexBuffers[indexFormat == DXGI_FORMAT_R32_UINT ? 1 : 0];
+}
+
+ID3D11Buffer* GeometryPool::CreateBuffer(const PooledBuffer& pooled, uint32_t capacity)
+{
+	//Too big to be a buffer, which D3D11 caps well under 4GB anyway
+	if ((uint64_t)capacity * pooled.ElementSize > 0xFFFFFFFF)
+	{
+		return nullptr;
+	}
+
+	D3D11_BUFFER_DESC bd;
+	ZeroMemory(&bd, sizeof(bd));
+	bd.Usage = D3D11_USAGE_DEFAULT;
+	bd.ByteWidth = capacity * pooled.ElementSize;
+	bd.BindFlags = pooled.BindFlags;
+	bd.CPUAccessFlags = 0;
+
+	ID3D11Buffer* buffer = nullptr;
+	if (FAILED(m_d3dDevice->CreateBuffer(&bd, nullptr, &buffer)))
+	{
+		return nullptr;
+	}
+	return buffer;
+}
+
+void GeometryPool::Copy(const PooledBuffer& pooled, ID3D11Buffer* destination, uint32_t to, ID3D11Buffer* source, uint32_t from, uint32_t count)
+{
+	D3D11_BOX box;
+	box.left = from * pooled.ElementSize;
+	box.right = (from + count) * pooled.ElementSize;
+	box.top = 0;
+	box.bottom = 1;
+	box.front = 0;
+	box.back = 1;
+	m_immediateContext->CopySubresourceRegion(destination, 0, to * pooled.ElementSize, 0, 0, source, 0, &box);
+}
+
+void GeometryPool::Replace(PooledBuffer& pooled, ID3D11Buffer* replacement)
+{
+	//The old buffer may still be bound, and a new one could be created at the same address, so Bind mustn't think it's already bound
+	if (m_boundVertexBuffer == pooled.Buffer) m_boundVertexBuffer = nullptr;
+	if (m_boundIndexBuffer == pooled.Buffer) m_boundIndexBuffer = nullptr;
+
+	if (pooled.Buffer) pooled.Buffer->Release();
+	pooled.Buffer = replacement;
+}
+
+bool GeometryPool::Grow(PooledBuffer& pooled, uint32_t capacity)
+{
+	ID3D11Buffer* grown = CreateBuffer(pooled, capacity);
+	if (grown == nullptr)
+	{
+		return false;
+	}
+
+	//Everything keeps its offset, so the whole of the old buffer is copied to the start of the new one
+	uint32_t oldCapacity = pooled.Allocator.GetCapacity();
+	if (pooled.Buffer != nullptr && oldCapacity != 0)
+	{
+		Copy(pooled, grown, 0, pooled.Buffer, 0, oldCapacity);
+	}
+	Replace(pooled, grown);
+	pooled.Allocator.Grow(capacity);
+	m_stats.Grows++;
+	return true;
+}
+
+bool GeometryPool::Defragment(PooledBuffer& pooled)
+{
+	//Nothing to close up: the free space is already one block, or there's none
+	if (pooled.Buffer == nullptr || pooled.Allocator.GetStats().FreeBlockCount <= 1)
+	{
+		return false;
+	}
+
+	//Copying within one buffer isn't allowed where the source and destination overlap, which moving meshes down can, so they're copied into a new one
+	ID3D11Buffer* packed = CreateBuffer(pooled, pooled.Allocator.GetCapacity());
+	if (packed == nullptr)
+	{
+		return false;
+	}
+
+	pooled.Allocator.Defragment(m_moves);
+	if (m_moves.empty())
+	{
+		packed->Release();
+		return false;
+	}
+
+	//Everything below the first move was already packed and stays where it is
+	if (m_moves.front().To != 0)
+	{
+		Copy(pooled, packed, 0, pooled.Buffer, 0, m_moves.front().To);
+	}
+	for (const GeometryMove& move : m_moves)
+	{
+		Copy(pooled, packed, move.To, pooled.Buffer, move.From, move.Size);
+	}
+	Replace(pooled, packed);
+	m_stats.Defragmentations++;
+	return true;
+}
+
+uint32_t GeometryPool::Allocate(PooledBuffer& pooled, uint32_t count)
+{
+	uint32_t allocation = pooled.Allocator.Allocate(count);
+	if (allocation != GeometryAllocator::InvalidAllocation || count == 0)
+	{
+		return allocation;
+	}
+
+	//There's room, just not in one piece
+	if (pooled.Allocator.GetStats().FreeUnits >= count && Defragment(pooled))
+	{
+		allocation = pooled.Allocator.Allocate(count);
+		if (allocation != GeometryAllocator::InvalidAllocation)
+		{
+			return allocation;
+		}
+	}
+
+	//Doubled, so growing costs a constant amount per element on average, and by at least count so the new space alone fits it
+	uint64_t capacity = pooled.Allocator.GetCapacity();
+	capacity = std::max<uint64_t>(std::max<uint64_t>(capacity * 2, capacity + count), pooled.BindFlags == D3D11_BIND_VERTEX_BUFFER ? InitialVertexCapacity : InitialIndexCapacity);
+	if (capacity > 0xFFFFFFFF || !Grow(pooled, (uint32_t)capacity))
+	{
+		return GeometryAllocator::InvalidAllocation;
+	}
+	return pooled.Allocator.Allocate(count);
+}
+
+void GeometryPool::Upload(PooledBuffer& pooled, uint32_t allocation, const void* data)
+{
+	uint32_t offset = pooled.Allocator.GetOffset(allocation);
+	uint32_t count = pooled.Allocator.GetSize(allocation);
+
+	D3D11_BOX box;
+	box.left = offset * pooled.ElementSize;
+	box.right = (offset + count) * pooled.ElementSize;
+	box.top = 0;
+	box.bottom = 1;
+	box.front = 0;
+	box.back = 1;
+	m_immediateContext->UpdateSubresource(pooled.Buffer, 0, &box, data, 0, 0);
+}
+
+bool GeometryPool::Add(VertexFormat format, const void* vertices, UINT vertexCount, DXGI_FORMAT indexFormat, const void* indices, UINT indexCount, GeometryRange& range)
+{
+	if (vertexCount == 0 || indexCount == 0)
+	{
+		return false;
+	}
+
+	PooledBuffer& vertexBuffer = m_vertexBuffers[(UINT)format];
+	PooledBuffer& indexBuffer = GetIndexBuffer(indexFormat);
+
+	uint32_t vertexAllocation = Allocate(vertexBuffer, vertexCount);
+	if (vertexAllocation == GeometryAllocator::InvalidAllocation)
+	{
+		return false;
+	}
+	uint32_t indexAllocation = Allocate(indexBuffer, indexCount);
+	if (indexAllocation == GeometryAllocator::InvalidAllocation)
+	{
+		vertexBuffer.Allocator.Free(vertexAllocation);
+		return false;
+	}
+
+	Upload(vertexBuffer, vertexAllocation, vertices);
+	Upload(indexBuffer, indexAllocation, indices);
+
+	range.Format = format;
+	range.IndexFormat = indexFormat;
+	range.VertexAllocation = vertexAllocation;
+	range.IndexAllocation = indexAllocation;
+	return true;
+}
+
+void GeometryPool::Remove(const GeometryRange& range)
+{
+	m_vertexBuffers[(UINT)range.Format].Allocator.Free(range.VertexAllocation);
+	GetIndexBuffer(range.IndexFormat).Allocator.Free(range.IndexAllocation);
+}
+
+void GeometryPool::Bind(ID3D11DeviceContext* immediateContext, const GeometryRange& range)
+{
+	const PooledBuffer& vertexBuffer = m_vertexBuffers[(UINT)range.Format];
+	if (vertexBuffer.Buffer != m_boundVertexBuffer)
+	{
+		UINT stride = vertexBuffer.ElementSize;
+		UINT offset = 0;
+		immediateContext->IASetVertexBuffers(0, 1, &vertexBuffer.Buffer, &stride, &offset);
+		m_boundVertexBuffer = vertexBuffer.Buffer;
+		m_stats.Binds++;
+	}
+	else
+	{
+		m_stats.SkippedBinds++;
+	}
+
+	//Each index size has a buffer of its own, so the buffer being bound means its format is too
+	const PooledBuffer& indexBuffer = GetIndexBuffer(range.IndexFormat);
+	if (indexBuffer.Buffer != m_boundIndexBuffer)
+	{
+		immediateContext->IASetIndexBuffer(indexBuffer.Buffer, range.IndexFormat, 0);
+		m_boundIndexBuffer = indexBuffer.Buffer;
+		m_stats.Binds++;
+	}
+	else
+	{
+		m_stats.SkippedBinds++;
+	}
+}
+
+void GeometryPool::ResetBindings()
+{
+	m_boundVertexBuffer = nullptr;
+	m_boundIndexBuffer = nullptr;
+	m_stats.Binds = 0;
+	m_stats.SkippedBinds = 0;
+}
+
+INT GeometryPool::GetBaseVertex(const GeometryRange& range) const
+{
+	return (INT)m_vertexBuffers[(UINT)range.Format].Allocator.GetOffset(range.VertexAllocation);
+}
+
+UINT GeometryPool::GetStartIndex(const GeometryRange& range) const
+{
+	return GetIndexBuffer(range.IndexFormat).Allocator.GetOffset(range.IndexAllocation);
+}
+
+void GeometryPool::Defragment()
+{
+	for (PooledBuffer& pooled : m_vertexBuffers)
+	{
+		Defragment(pooled);
+	}
+	for (PooledBuffer& pooled : m_indexBuffers)
+	{
+		Defragment(pooled);
+	}
+}
+
+GeometryPoolStats GeometryPool::GetStats() const
+{
+	GeometryPoolStats stats = m_stats;
+	for (UINT format = 0; format < VertexFormatCount; format++)
+	{
+		stats.VertexBuffers[format] = m_vertexBuffers[format].Allocator.GetStats();
+	}
+	for (UINT i = 0; i < 2; i++)
+	{
+		stats.IndexBuffers[i] = m_indexBuffers[i].Allocator.GetStats();
+	}
+	return stats;
+}
+
+void GeometryPool::Report(const char* name) const
+{
+	GeometryPoolStats stats = GetStats();
+	char line[512];
+	for (UINT format = 0; format < VertexFormatCount; format++)
+	{
+		const GeometryAllocatorStats& buffer = stats.VertexBuffers[format];
+		if (buffer.Capacity == 0) continue;
+		sprintf_s(line, "%s: %-7s vertex buffer %9u of %9u vertices (%7.2f MB) in %4u meshes, %4u free blocks, largest %9u, %5.1f%% fragmented\n",
+			name, VertexFormats::GetName((VertexFormat)format), buffer.UsedUnits, buffer.Capacity, (double)buffer.Capacity * m_vertexBuffers[format].ElementSize / (1024.0 * 1024.0),
+			buffer.AllocationCount, buffer.FreeBlockCount, buffer.LargestFreeBlock, buffer.Fragmentation * 100.0f);
+		OutputDebugStringA(line);
+	}
+	for (UINT i = 0; i < 2; i++)
+	{
+		const GeometryAllocatorStats& buffer = stats.IndexBuffers[i];
+		if (buffer.Capacity == 0) continue;
+		sprintf_s(line, "%s: %u bit  index buffer  %9u of %9u indices  (%7.2f MB) in %4u meshes, %4u free blocks, largest %9u, %5.1f%% fragmented\n",
+			name, m_indexBuffers[i].ElementSize * 8, buffer.UsedUnits, buffer.Capacity, (double)buffer.Capacity * m_indexBuffers[i].ElementSize / (1024.0 * 1024.0),
+			buffer.AllocationCount, buffer.FreeBlockCount, buffer.LargestFreeBlock, buffer.Fragmentation * 100.0f);
+		OutputDebugStringA(line);
+	}
+	sprintf_s(line, "%s: %u grows, %u defragmentations\n", name, stats.Grows, stats.Defragmentations);
+	OutputDebugStringA(line);
+}
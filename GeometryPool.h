@@ -0,0 +1,116 @@
+#pragma once
+#include <d3d11_1.h>
+#include <vector>
+
+#include "GeometryAllocator.h"
+#include "VertexFormat.h"
+
+/// <summary>Where a mesh's vertices and indices are within a GeometryPool</summary>
+struct GeometryRange
+{
+	VertexFormat Format;
+	/// <summary>DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT, which decides which of the pool's index buffers the indices are in</summary>
+	DXGI_FORMAT IndexFormat;
+	uint32_t VertexAllocation;
+	uint32_t IndexAllocation;
+};
+
+/// <summary>How full each of a GeometryPool's buffers is, and how often it's had to bind, grow and defragment them</summary>
+struct GeometryPoolStats
+{
+	/// <summary>In vertices, indexed by VertexFormat</summary>
+	GeometryAllocatorStats VertexBuffers[VertexFormatCount];
+	/// <summary>In indices, 16 bit then 32 bit</summary>
+	GeometryAllocatorStats IndexBuffers[2];
+	/// <summary>The vertex and index buffer binds made since the last ResetBindings, and the ones skipped as the buffer was already bound</summary>
+	uint32_t Binds;
+	uint32_t SkippedBinds;
+	uint32_t Grows;
+	uint32_t Defragmentations;
+};
+
+/// <summary><para>Holds every static mesh's vertices and indices in a few big buffers: one vertex buffer per vertex format, and one index buffer per index size. </para>
+/// <para>Each mesh gets a range of each from a GeometryAllocator and is drawn with DrawIndexed's start index and base vertex pointing into it, so actors whose
+/// meshes share a format draw one after another without binding anything in between. </para>
+/// <para>A buffer that runs out of room is grown by copying it into one twice the size on the GPU. If it has enough free space but it's too broken up,
+/// it's defragmented instead, by copying every mesh down into a fresh buffer. Either way, meshes keep their GeometryRange and just find themselves
+/// somewhere else the next time they're drawn.</para></summary>
+class GeometryPool
+{
+public:
+	/// <summary>The size each buffer starts at, unless the first mesh put in it is bigger</summary>
+	static const uint32_t InitialVertexCapacity = 256 * 1024;
+	static const uint32_t InitialIndexCapacity = 1024 * 1024;
+
+private:
+	/// <summary>One of the pool's buffers and the allocator handing out its ranges</summary>
+	struct PooledBuffer
+	{
+		ID3D11Buffer* Buffer;
+		GeometryAllocator Allocator;
+		/// <summary>The size of one vertex or index, in bytes</summary>
+		UINT ElementSize;
+		UINT BindFlags;
+	};
+
+	ID3D11Device* m_d3dDevice;
+	ID3D11DeviceContext* m_immediateContext;
+
+	PooledBuffer m_vertexBuffers[VertexFormatCount];
+	PooledBuffer m_indexBuffers[2];
+
+	/// <summary>What Bind last bound, so it can skip binding it again</summary>
+	ID3D11Buffer* m_boundVertexBuffer;
+	ID3D11Buffer* m_boundIndexBuffer;
+
+	GeometryPoolStats m_stats;
+	/// <summary>Kept so defragmenting doesn't allocate every time</summary>
+	std::vector<GeometryMove> m_moves;
+
+public:
+	GeometryPool(ID3D11Device* d3dDevice, ID3D11DeviceContext* immediateContext);
+	~GeometryPool();
+
+	/// <summary>Copies a mesh's vertices and indices into the pool</summary>
+	/// <param name="vertices">vertexCount vertices in format</param>
+	/// <param name="indices">indexCount indices in indexFormat, numbered from the mesh's first vertex</param>
+	/// <returns>false if a buffer couldn't be grown to fit it, in which case nothing was added</returns>
+	bool Add(VertexFormat format, const void* vertices, UINT vertexCount, DXGI_FORMAT indexFormat, const void* indices, UINT indexCount, GeometryRange& range);
+	/// <summary>Frees a mesh's ranges for another mesh to use</summary>
+	void Remove(const GeometryRange& range);
+
+	/// <summary>Binds the buffers range is in, unless they're what was bound last</summary>
+	void Bind(ID3D11DeviceContext* immediateContext, const GeometryRange& range);
+	/// <summary>Forgets what was bound, so the next Bind binds. Call once a frame before drawing, as anything else drawn may have bound its own buffers,
+	/// and again after anything binds vertex or index buffers outside the pool, such as a mesh that didn't fit in it</summary>
+	void ResetBindings();
+
+	/// <summary>DrawIndexed's BaseVertexLocation for the mesh</summary>
+	INT GetBaseVertex(const GeometryRange& range) const;
+	/// <summary>Added to each of the mesh's index ranges to give DrawIndexed's StartIndexLocation</summary>
+	UINT GetStartIndex(const GeometryRange& range) const;
+
+	/// <summary>Packs every mesh in every buffer down to the start of it, so all the free space is in one piece. Worth calling after unloading many meshes</summary>
+	void Defragment();
+
+	GeometryPoolStats GetStats() const;
+	/// <summary>Writes each buffer's use and fragmentation to the debug output</summary>
+	void Report(const char* name) const;
+
+private:
+	PooledBuffer& GetIndexBuffer(DXGI_FORMAT indexFormat);
+	const PooledBuffer& GetIndexBuffer(DXGI_FORMAT indexFormat) const;
+
+	/// <summary>Allocates count elements of a buffer, creating, defragmenting or growing it to make room</summary>
+	/// <returns>GeometryAllocator::InvalidAllocation if it couldn't be made big enough</returns>
+	uint32_t Allocate(PooledBuffer& pooled, uint32_t count);
+	/// <summary>Creates an empty buffer the size of capacity of pooled's elements</summary>
+	ID3D11Buffer* CreateBuffer(const PooledBuffer& pooled, uint32_t capacity);
+	/// <summary>Copies count elements between two buffers on the GPU</summary>
+	void Copy(const PooledBuffer& pooled, ID3D11Buffer* destination, uint32_t to, ID3D11Buffer* source, uint32_t from, uint32_t count);
+	/// <summary>Swaps pooled's buffer for replacement, releasing the old one</summary>
+	void Replace(PooledBuffer& pooled, ID3D11Buffer* replacement);
+	bool Grow(PooledBuffer& pooled, uint32_t capacity);
+	bool Defragment(PooledBuffer& pooled);
+	void Upload(PooledBuffer& pooled, uint32_t allocation, const void* data);
+};
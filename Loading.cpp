@@ -1,29 +1,9 @@
-#include "Loading.h"
-
-Mesh* LoadOBJ(ID3D11Device* d3dDevice, std::string path)
-{
-    Mesh* mesh = new Mesh;
-    *mesh = OBJLoader::Load(path, d3dDevice, true);
-
-    return mesh;
-}
-
-Texture* LoadDDS(ID3D11Device* d3dDevice, std::string path)
-{
-    Texture* texture;
-
-    //Convert the path to a wChar
-    const char* c = path.c_str();
-    const size_t cSize = strlen(c) + 1;
-    wchar_t* wPath = new wchar_t[cSize];
-    mbstowcs(wPath, c, cSize);
-
-    HRESULT hr;
-    hr = CreateDDSTextureFromFile(d3dDevice, wPath, nullptr, &texture);
-
-    if (texture == nullptr)
-    {
-        throw(hr);
-    }
-    return texture;
-}
+#include "Loading.h"
+
+Mesh* LoadOBJ(ID3D11Device* d3dDevice, std::string path, VertexFormat format, GeometryPool* pool)
+{
+    Mesh* mesh = new Mesh;
+    *mesh = OBJLoader::Load(path, d3dDevice, true, format, MeshEncoding::Raw, pool);
+
+    return mesh;
+}
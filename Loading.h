@@ -1,13 +1,25 @@
-#include <DirectXMath.h>
-#include <d3d11_1.h>
-
-#include "OBJLoader.h"
-#include "DDSTextureLoader.h"
-
-using namespace DirectX;
-
-typedef MeshData Mesh;
-typedef ID3D11ShaderResourceView Texture;
-
-Mesh* LoadOBJ(ID3D11Device* d3dDevice, std::string path);
-Texture* LoadDDS(ID3D11Device* d3dDevice, std::string path);
\ No newline at end of file
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <d3d11_1.h>
+
+#include "OBJLoader.h"
+#include "DDSTextureLoader.h"
+
+using namespace DirectX;
+
+typedef MeshData Mesh;
+/// <summary>A texture as actors draw it. Its view can be swapped under them, so one still loading is drawn with a placeholder until it's ready, see TextureLoader</summary>
+struct Texture
+{
+	/// <summary>A texture still loading, or whose file couldn't be loaded</summary>
+	static const uint32_t NotStreamed = UINT32_MAX;
+
+	/// <summary>Holds a reference of its own, released by whoever owns the texture</summary>
+	ID3D11ShaderResourceView* View;
+	/// <summary>Its index in the MipStreamer of the TextureLoader that loaded it, once its tail is uploaded</summary>
+	uint32_t StreamIndex;
+};
+
+//Given a pool, the mesh's vertices and indices go in it rather than in buffers of their own, see GeometryPool
+Mesh* LoadOBJ(ID3D11Device* d3dDevice, std::string path, VertexFormat format = VertexFormat::Compact, GeometryPool* pool = nullptr);
\ No newline at end of file
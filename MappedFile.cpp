@@ -0,0 +1,169 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+#ifdef _WIN32
+	m_file = nullptr;
+	m_mapping = nullptr;
+#else
+	m_file = -1;
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
+
+MappedFile::MappedFile(const std::string& filename) : MappedFile()
+{
+	Open(filename);
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::string& filename)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	m_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		Close();
+		return false;
+	}
+	m_size = (size_t)size.QuadPart;
+
+	//An empty file can't be mapped, but it is still a valid (empty) file
+	if (m_size == 0)
+	{
+		return true;
+	}
+
+	m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	m_file = open(filename.c_str(), O_RDONLY);
+	if (m_file < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(m_file, &info) != 0)
+	{
+		Close();
+		return false;
+	}
+	m_size = (size_t)info.st_size;
+
+	//An empty file can't be mapped, but it is still a valid (empty) file
+	if (m_size == 0)
+	{
+		return true;
+	}
+
+	void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+	if (view != MAP_FAILED)
+	{
+		//We read front to back exactly once, so let the kernel read ahead aggressively
+		madvise(view, m_size, MADV_SEQUENTIAL);
+		m_data = (const char*)view;
+	}
+#endif
+
+	if (m_data == nullptr)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_data) UnmapViewOfFile(m_data);
+	if (m_mapping) CloseHandle(m_mapping);
+	if (m_file) CloseHandle(m_file);
+	m_mapping = nullptr;
+	m_file = nullptr;
+#else
+	if (m_data) munmap((void*)m_data, m_size);
+	if (m_file >= 0) close(m_file);
+	m_file = -1;
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool MappedFile::Evict(const std::string& filename)
+{
+#ifdef _WIN32
+	//The cache manager flushes and purges a file's cached pages when it's opened without buffering, so opening and closing it is enough
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	CloseHandle(file);
+#else
+	int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	//Dirty pages can't be dropped, and a file that's just been written is all dirty pages
+	fdatasync(file);
+	posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+	close(file);
+#endif
+	return true;
+}
+
+bool MappedFile::IsOpen() const
+{
+#ifdef _WIN32
+	return m_file != nullptr;
+#else
+	return m_file >= 0;
+#endif
+}
+
+const char* MappedFile::GetData() const
+{
+	return m_data;
+}
+
+const char* MappedFile::GetEnd() const
+{
+	return m_data + m_size;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return m_size;
+}
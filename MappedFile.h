@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+/// <summary><para>A read-only view of a whole file mapped into memory. </para>
+/// <para>The contents can be scanned in place, so loaders that only need to read a file once don't have to copy it into a heap buffer first.
+/// Uses CreateFileMapping on Windows and mmap everywhere else.</para></summary>
+class MappedFile
+{
+private:
+#ifdef _WIN32
+	/// <summary>The HANDLE of the open file</summary>
+	void* m_file;
+	/// <summary>The HANDLE of the file mapping object</summary>
+	void* m_mapping;
+#else
+	/// <summary>The file descriptor of the open file</summary>
+	int m_file;
+#endif
+	/// <summary>The first byte of the mapped view, nullptr if nothing is mapped</summary>
+	const char* m_data;
+	/// <summary>The size of the file, in bytes</summary>
+	size_t m_size;
+
+public:
+	MappedFile();
+	/// <param name="filename">The file to map. Check IsOpen() to see if this succeeded</param>
+	MappedFile(const std::string& filename);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/// <summary>Maps the whole of a file, closing whatever was mapped before</summary>
+	/// <param name="filename">The path of the file to map</param>
+	/// <returns>false if the file could not be opened or mapped</returns>
+	bool Open(const std::string& filename);
+	/// <summary>Unmaps the view and closes the file. Any pointers from GetData() are invalid afterwards</summary>
+	void Close();
+
+	/// <summary><para>Drops a file's pages from the operating system's page cache, so the next read of it comes from the disk. Used to time cold loads. </para>
+	/// <para>Opening a file unbuffered does this on Windows, as long as nothing else has it open. Elsewhere its pages are flushed then dropped with posix_fadvise.</para></summary>
+	/// <returns>false if the file couldn't be opened</returns>
+	static bool Evict(const std::string& filename);
+
+	bool IsOpen() const;
+	const char* GetData() const;
+	const char* GetEnd() const;
+	size_t GetSize() const;
+};
@@ -0,0 +1,632 @@
+#include "MeshBinary.h"
+#include "MeshCodec.h"
+#include <algorithm>
+#include <chrono>		//For timing the benchmark
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	//A compressed payload starts with the size of each of its streams: the vertices, the indices, then everything after the indices
+	const size_t StreamCount = 3;
+
+	//Where the meshlets start in the payload. 16 bit indices can leave the end of the index buffer 2 bytes off 4 byte alignment
+	uint64_t GetMeshletOffset(uint64_t vertexAndIndexBytes)
+	{
+		return (vertexAndIndexBytes + 3) & ~(uint64_t)3;
+	}
+
+	//Everything in the header but the payload's hash, which is only known once the payload is
+	MeshBinaryHeader CreateHeader(const MeshSourceInfo& source, const MeshBinaryContents& contents, MeshEncoding encoding, uint64_t storedSize)
+	{
+		MeshBinaryHeader header = {};
+		header.Magic = MeshBinary::Magic;
+		header.Version = MeshBinary::Version;
+		header.HeaderSize = sizeof(MeshBinaryHeader);
+		header.IndexSize = contents.IndexSize;
+		header.VertexCount = contents.VertexCount;
+		header.IndexCount = contents.IndexCount;
+		header.Format = contents.Format;
+		header.MeshletCount = contents.MeshletCount;
+		header.LodCount = contents.LodCount;
+		header.SubmeshCount = contents.SubmeshCount;
+		header.Encoding = encoding;
+		header.Layout = VertexFormats::GetLayout(contents.Format);
+		header.Quantization = contents.Quantization;
+		header.Bounds = contents.Bounds;
+		header.Source = source;
+		header.PayloadSize = storedSize;
+		return header;
+	}
+
+	//Compresses a payload laid out as it is in memory. The meshlets, levels of detail and submeshes are only a few percent of it, so they're one stream
+	void EncodePayload(const char* payload, size_t payloadSize, size_t stride, size_t vertexCount, size_t indexSize, size_t indexCount, std::vector<unsigned char>& out)
+	{
+		size_t vertexBytes = stride * vertexCount;
+		size_t indexBytes = indexSize * indexCount;
+		uint64_t streamSizes[StreamCount];
+		out.assign(sizeof(streamSizes), 0);
+
+		size_t start = out.size();
+		MeshCodec::EncodeVertices(payload, vertexCount, stride, out);
+		streamSizes[0] = out.size() - start;
+
+		start = out.size();
+		MeshCodec::EncodeIndices(payload + vertexBytes, indexCount, indexSize, out);
+		streamSizes[1] = out.size() - start;
+
+		start = out.size();
+		MeshCodec::Compress((const unsigned char*)payload + vertexBytes + indexBytes, payloadSize - vertexBytes - indexBytes, out);
+		streamSizes[2] = out.size() - start;
+
+		memcpy(out.data(), streamSizes, sizeof(streamSizes));
+	}
+
+	//Decodes a payload written by EncodePayload back to exactly decodedSize bytes. false if it's corrupt
+	bool DecodePayload(const char* data, size_t size, size_t stride, size_t vertexCount, size_t indexSize, size_t indexCount, char* decoded, size_t decodedSize,
+		std::vector<unsigned char>& scratch)
+	{
+		uint64_t streamSizes[StreamCount];
+		if (size < sizeof(streamSizes))
+		{
+			return false;
+		}
+		memcpy(streamSizes, data, sizeof(streamSizes));
+		const unsigned char* stream = (const unsigned char*)data + sizeof(streamSizes);
+		uint64_t remaining = size - sizeof(streamSizes);
+		if (streamSizes[0] > remaining || streamSizes[1] > remaining - streamSizes[0] || streamSizes[2] != remaining - streamSizes[0] - streamSizes[1])
+		{
+			return false;
+		}
+
+		size_t vertexBytes = stride * vertexCount;
+		size_t indexBytes = indexSize * indexCount;
+		if (!MeshCodec::DecodeVertices(stream, (size_t)streamSizes[0], decoded, vertexCount, stride, scratch))
+		{
+			return false;
+		}
+		stream += streamSizes[0];
+		if (!MeshCodec::DecodeIndices(stream, (size_t)streamSizes[1], decoded + vertexBytes, indexCount, indexSize, scratch))
+		{
+			return false;
+		}
+		stream += streamSizes[1];
+		return MeshCodec::Decompress(stream, (size_t)streamSizes[2], (unsigned char*)decoded + vertexBytes + indexBytes, decodedSize - vertexBytes - indexBytes);
+	}
+}
+
+namespace
+{
+	//MurmurHash64A's constants
+	const uint64_t HashMultiplier = 0xc6a4a7935bd1e995ull;
+	const int HashShift = 47;
+}
+
+MeshHasher::MeshHasher(uint64_t size)
+{
+	m_hash = 0x8445d61a4e774912ull ^ (size * HashMultiplier);
+	m_pendingSize = 0;
+}
+
+void MeshHasher::Add(const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+
+	//Finish the word the last block started
+	if (m_pendingSize != 0)
+	{
+		size_t count = std::min<size_t>(sizeof(m_pending) - m_pendingSize, size);
+		memcpy(m_pending + m_pendingSize, bytes, count);
+		m_pendingSize += count;
+		bytes += count;
+		size -= count;
+		if (m_pendingSize < sizeof(m_pending))
+		{
+			return;
+		}
+		m_pendingSize = 0;
+		Add(m_pending, sizeof(m_pending));
+	}
+
+	//MurmurHash64A, 8 bytes at a time
+	size_t words = size / 8;
+	for (size_t i = 0; i < words; i++)
+	{
+		uint64_t k;
+		memcpy(&k, bytes + i * 8, sizeof(k));
+		k *= HashMultiplier;
+		k ^= k >> HashShift;
+		k *= HashMultiplier;
+
+		m_hash ^= k;
+		m_hash *= HashMultiplier;
+	}
+
+	m_pendingSize = size & 7;
+	memcpy(m_pending, bytes + words * 8, m_pendingSize);
+}
+
+uint64_t MeshHasher::Finish()
+{
+	uint64_t h = m_hash;
+
+	//The last 0 to 7 bytes
+	if (m_pendingSize != 0)
+	{
+		uint64_t k = 0;
+		memcpy(&k, m_pending, m_pendingSize);
+		h ^= k;
+		h *= HashMultiplier;
+	}
+
+	h ^= h >> HashShift;
+	h *= HashMultiplier;
+	h ^= h >> HashShift;
+	return h;
+}
+
+uint64_t MeshBinary::Hash(const void* data, size_t size)
+{
+	MeshHasher hasher(size);
+	hasher.Add(data, size);
+	return hasher.Finish();
+}
+
+bool MeshBinary::GetSourceInfo(const std::string& sourceFilename, MeshSourceInfo& info, bool hashContents)
+{
+	std::error_code error;
+	std::filesystem::path path(sourceFilename);
+
+	uintmax_t size = std::filesystem::file_size(path, error);
+	if (error)
+	{
+		return false;
+	}
+	std::filesystem::file_time_type modifiedTime = std::filesystem::last_write_time(path, error);
+	if (error)
+	{
+		return false;
+	}
+
+	info.Size = size;
+	info.ModifiedTime = (uint64_t)modifiedTime.time_since_epoch().count();
+	info.Hash = 0;
+
+	if (hashContents)
+	{
+		MappedFile file(sourceFilename);
+		if (!file.IsOpen())
+		{
+			return false;
+		}
+		info.Hash = Hash(file.GetData(), file.GetSize());
+	}
+	return true;
+}
+
+bool MeshBinary::ReadSourceInfo(const std::string& binaryFilename, MeshSourceInfo& info)
+{
+	std::ifstream file(binaryFilename, std::ios::binary);
+	MeshBinaryHeader header;
+	if (!file.read((char*)&header, sizeof(header)))
+	{
+		return false;
+	}
+	if (header.Magic != Magic || header.Version != Version || header.HeaderSize != sizeof(MeshBinaryHeader))
+	{
+		return false;
+	}
+
+	info = header.Source;
+	return true;
+}
+
+bool MeshBinary::Write(const std::string& binaryFilename, const MeshSourceInfo& source, const MeshBinaryContents& contents, MeshEncoding encoding)
+{
+	VertexLayoutDesc layout = VertexFormats::GetLayout(contents.Format);
+	size_t vertexBytes = (size_t)layout.Stride * contents.VertexCount;
+	size_t indexBytes = (size_t)contents.IndexSize * contents.IndexCount;
+	size_t meshletOffset = (size_t)GetMeshletOffset(vertexBytes + indexBytes);
+	size_t lodOffset = meshletOffset + sizeof(Meshlet) * contents.MeshletCount;
+	size_t submeshOffset = lodOffset + sizeof(MeshLod) * contents.LodCount;
+	size_t payloadSize = submeshOffset + sizeof(Submesh) * contents.SubmeshCount;
+
+	//Lay the payload out as it will be in memory, which is how a raw file stores it and what a compressed one decodes back to
+	std::vector<char> payload(payloadSize);
+	if (vertexBytes != 0) memcpy(payload.data(), contents.Vertices, vertexBytes);
+	if (indexBytes != 0) memcpy(payload.data() + vertexBytes, contents.Indices, indexBytes);
+	if (contents.MeshletCount != 0) memcpy(payload.data() + meshletOffset, contents.Meshlets, sizeof(Meshlet) * contents.MeshletCount);
+	if (contents.LodCount != 0) memcpy(payload.data() + lodOffset, contents.Lods, sizeof(MeshLod) * contents.LodCount);
+	if (contents.SubmeshCount != 0) memcpy(payload.data() + submeshOffset, contents.Submeshes, sizeof(Submesh) * contents.SubmeshCount);
+
+	const char* stored = payload.data();
+	size_t storedSize = payloadSize;
+	std::vector<unsigned char> encoded;
+	if (encoding == MeshEncoding::Compressed)
+	{
+		EncodePayload(payload.data(), payloadSize, layout.Stride, contents.VertexCount, contents.IndexSize, contents.IndexCount, encoded);
+		stored = (const char*)encoded.data();
+		storedSize = encoded.size();
+	}
+
+	//Build the whole file in memory so it goes out in one write, and the stored payload can be hashed for the header
+	std::vector<char> file(sizeof(MeshBinaryHeader) + storedSize);
+	if (storedSize != 0) memcpy(file.data() + sizeof(MeshBinaryHeader), stored, storedSize);
+
+	MeshBinaryHeader header = CreateHeader(source, contents, encoding, storedSize);
+	header.PayloadHash = Hash(stored, storedSize);
+	memcpy(file.data(), &header, sizeof(header));
+
+	//Write next to the real file then swap it in, so anything reading the cache only ever sees the old file or the complete new one
+	std::string tempFilename = binaryFilename + ".tmp";
+	{
+		std::ofstream out(tempFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+		out.write(file.data(), file.size());
+		out.close();
+		if (out.fail())
+		{
+			std::error_code error;
+			std::filesystem::remove(tempFilename, error);
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempFilename, binaryFilename, error);
+	if (error)
+	{
+		std::filesystem::remove(tempFilename, error);
+		return false;
+	}
+	return true;
+}
+
+MeshBinaryWriter::MeshBinaryWriter() : m_header(), m_contents(), m_hasher(0), m_written(0), m_meshletOffset(0)
+{
+}
+
+MeshBinaryWriter::~MeshBinaryWriter()
+{
+	Abandon();
+}
+
+bool MeshBinaryWriter::Open(const std::string& binaryFilename, const MeshSourceInfo& source, const MeshBinaryContents& contents)
+{
+	Abandon();
+
+	VertexLayoutDesc layout = VertexFormats::GetLayout(contents.Format);
+	uint64_t vertexAndIndexBytes = (uint64_t)layout.Stride * contents.VertexCount + (uint64_t)contents.IndexSize * contents.IndexCount;
+	m_meshletOffset = GetMeshletOffset(vertexAndIndexBytes);
+	uint64_t payloadSize = m_meshletOffset + sizeof(Meshlet) * (uint64_t)contents.MeshletCount + sizeof(MeshLod) * (uint64_t)contents.LodCount +
+		sizeof(Submesh) * (uint64_t)contents.SubmeshCount;
+
+	m_binaryFilename = binaryFilename;
+	m_tempFilename = binaryFilename + ".tmp";
+	m_contents = contents;
+	m_header = CreateHeader(source, contents, MeshEncoding::Raw, payloadSize);
+	m_hasher = MeshHasher(payloadSize);
+	m_written = 0;
+
+	//The header goes in now to hold its place, and again with the payload's hash by Finish
+	m_out.open(m_tempFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+	m_out.write((const char*)&m_header, sizeof(m_header));
+	if (!m_out.good())
+	{
+		Abandon();
+		return false;
+	}
+	return true;
+}
+
+bool MeshBinaryWriter::Write(const void* data, size_t size)
+{
+	if (!m_out.is_open() || m_written + size > m_header.PayloadSize)
+	{
+		return false;
+	}
+	m_out.write((const char*)data, size);
+	m_hasher.Add(data, size);
+	m_written += size;
+	return m_out.good();
+}
+
+bool MeshBinaryWriter::Pad()
+{
+	uint64_t vertexAndIndexBytes = (uint64_t)m_header.Layout.Stride * m_header.VertexCount + (uint64_t)m_header.IndexSize * m_header.IndexCount;
+	if (m_written == vertexAndIndexBytes && m_meshletOffset > m_written)
+	{
+		const char zeros[4] = {};
+		return Write(zeros, (size_t)(m_meshletOffset - m_written));
+	}
+	return m_written >= m_meshletOffset;
+}
+
+bool MeshBinaryWriter::Append(const void* data, size_t size)
+{
+	uint64_t vertexAndIndexBytes = (uint64_t)m_header.Layout.Stride * m_header.VertexCount + (uint64_t)m_header.IndexSize * m_header.IndexCount;
+	return m_written + size <= vertexAndIndexBytes && Write(data, size);
+}
+
+bool MeshBinaryWriter::AppendMeshlets(const Meshlet* meshlets, size_t count)
+{
+	return Pad() && m_written + sizeof(Meshlet) * count <= m_meshletOffset + sizeof(Meshlet) * (uint64_t)m_header.MeshletCount && Write(meshlets, sizeof(Meshlet) * count);
+}
+
+bool MeshBinaryWriter::Finish()
+{
+	if (!Pad() || m_written != m_meshletOffset + sizeof(Meshlet) * (uint64_t)m_header.MeshletCount ||
+		(m_contents.LodCount != 0 && !Write(m_contents.Lods, sizeof(MeshLod) * m_contents.LodCount)) ||
+		(m_contents.SubmeshCount != 0 && !Write(m_contents.Submeshes, sizeof(Submesh) * m_contents.SubmeshCount)) ||
+		m_written != m_header.PayloadSize)
+	{
+		Abandon();
+		return false;
+	}
+
+	m_header.PayloadHash = m_hasher.Finish();
+	m_out.seekp(0);
+	m_out.write((const char*)&m_header, sizeof(m_header));
+	m_out.close();
+	if (m_out.fail())
+	{
+		Abandon();
+		return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(m_tempFilename, m_binaryFilename, error);
+	if (error)
+	{
+		std::filesystem::remove(m_tempFilename, error);
+		return false;
+	}
+	m_tempFilename.clear();
+	return true;
+}
+
+void MeshBinaryWriter::Abandon()
+{
+	if (m_out.is_open())
+	{
+		m_out.close();
+	}
+	if (!m_tempFilename.empty())
+	{
+		std::error_code error;
+		std::filesystem::remove(m_tempFilename, error);
+		m_tempFilename.clear();
+	}
+}
+
+MeshBinaryStatus MeshBinary::Read(const std::string& binaryFilename, const std::string& sourceFilename, VertexFormat format, std::vector<char>& buffer, std::vector<char>& decoded, MeshBinaryView& view)
+{
+	std::ifstream in(binaryFilename, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!in.good())
+	{
+		return MeshBinaryStatus::Missing;
+	}
+
+	std::streamoff fileSize = in.tellg();
+	in.seekg(0);
+
+	//The only read of the file, everything after this works on the buffer
+	buffer.resize((size_t)fileSize);
+	in.read(buffer.data(), fileSize);
+	if (!in.good())
+	{
+		return MeshBinaryStatus::Corrupt;
+	}
+
+	return Validate(buffer.data(), buffer.size(), sourceFilename, format, decoded, view);
+}
+
+MeshBinaryStatus MeshBinary::Map(const std::string& binaryFilename, const std::string& sourceFilename, VertexFormat format, MappedFile& file, std::vector<char>& decoded, MeshBinaryView& view)
+{
+	if (!file.Open(binaryFilename))
+	{
+		return MeshBinaryStatus::Missing;
+	}
+
+	return Validate(file.GetData(), file.GetSize(), sourceFilename, format, decoded, view);
+}
+
+MeshBinaryStatus MeshBinary::Validate(const char* data, size_t size, const std::string& sourceFilename, VertexFormat format, std::vector<char>& decoded, MeshBinaryView& view)
+{
+	if (size < 3 * sizeof(uint32_t))
+	{
+		return MeshBinaryStatus::Corrupt;
+	}
+
+	//Check the magic and version before trusting anything else in the header
+	uint32_t start[3];
+	memcpy(start, data, sizeof(start));
+	if (start[0] != Magic)
+	{
+		return MeshBinaryStatus::Corrupt;
+	}
+	if (start[1] != Version || start[2] != sizeof(MeshBinaryHeader))
+	{
+		return MeshBinaryStatus::WrongVersion;
+	}
+	if (size < sizeof(MeshBinaryHeader))
+	{
+		return MeshBinaryStatus::Corrupt;
+	}
+
+	//Both a heap buffer and a mapped view start suitably aligned, and the header's size keeps the vertices aligned after it
+	const MeshBinaryHeader* header = (const MeshBinaryHeader*)data;
+	if (header->Format != format)
+	{
+		return MeshBinaryStatus::WrongFormat;
+	}
+	VertexLayoutDesc layout = VertexFormats::GetLayout(format);
+	if (memcmp(&header->Layout, &layout, sizeof(layout)) != 0)
+	{
+		return MeshBinaryStatus::WrongVersion;
+	}
+
+	//A compressed payload can be any size, but decodes to exactly the size a raw one would be
+	uint64_t payloadSize = (uint64_t)size - sizeof(MeshBinaryHeader);
+	uint64_t meshletOffset = GetMeshletOffset((uint64_t)layout.Stride * header->VertexCount + (uint64_t)header->IndexSize * header->IndexCount);
+	uint64_t lodOffset = meshletOffset + (uint64_t)sizeof(Meshlet) * header->MeshletCount;
+	uint64_t submeshOffset = lodOffset + (uint64_t)sizeof(MeshLod) * header->LodCount;
+	uint64_t expectedSize = submeshOffset + (uint64_t)sizeof(Submesh) * header->SubmeshCount;
+	bool compressed = header->Encoding == MeshEncoding::Compressed;
+	if ((header->IndexSize != 2 && header->IndexSize != 4) || (!compressed && header->Encoding != MeshEncoding::Raw) || header->PayloadSize != payloadSize ||
+		(!compressed && expectedSize != payloadSize))
+	{
+		return MeshBinaryStatus::Corrupt;
+	}
+
+	//Check the source last, as it may mean hashing it
+	MeshSourceInfo source;
+	if (GetSourceInfo(sourceFilename, source, false))
+	{
+		if (source.Size != header->Source.Size)
+		{
+			return MeshBinaryStatus::Stale;
+		}
+		//Copying or checking out a file changes its write time without changing it, so only the contents decide
+		if (source.ModifiedTime != header->Source.ModifiedTime)
+		{
+			if (!GetSourceInfo(sourceFilename, source, true) || source.Hash != header->Source.Hash)
+			{
+				return MeshBinaryStatus::Stale;
+			}
+		}
+	}
+
+	const char* payload = data + sizeof(MeshBinaryHeader);
+	if (Hash(payload, (size_t)payloadSize) != header->PayloadHash)
+	{
+		return MeshBinaryStatus::Corrupt;
+	}
+
+	//The hash only covers what was stored, so the decoder still checks every stream fits as it goes
+	if (compressed)
+	{
+		std::vector<unsigned char> scratch;
+		decoded.resize((size_t)expectedSize);
+		if (!DecodePayload(payload, (size_t)payloadSize, layout.Stride, header->VertexCount, header->IndexSize, header->IndexCount, decoded.data(), decoded.size(), scratch))
+		{
+			return MeshBinaryStatus::Corrupt;
+		}
+		payload = decoded.data();
+	}
+
+	view.Header = header;
+	view.Vertices = payload;
+	view.Indices = payload + (size_t)layout.Stride * header->VertexCount;
+	view.Meshlets = (const Meshlet*)(payload + meshletOffset);
+	view.Lods = (const MeshLod*)(payload + lodOffset);
+	view.Submeshes = (const Submesh*)(payload + submeshOffset);
+	return MeshBinaryStatus::Valid;
+}
+
+MeshBinaryBenchmark MeshBinary::Benchmark(const std::string& binaryFilename, const std::string& sourceFilename, const MeshSourceInfo& source, const MeshBinaryContents& contents, int iterations)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	MeshBinaryBenchmark result = {};
+	const MeshEncoding encodings[2] = { MeshEncoding::Raw, MeshEncoding::Compressed };
+	const std::string filenames[2] = { binaryFilename + ".raw", binaryFilename + ".compressed" };
+	std::vector<char> payloads[2];
+	bool loaded = true;
+
+	for (int e = 0; e < 2; e++)
+	{
+		if (!Write(filenames[e], source, contents, encodings[e]))
+		{
+			return result;
+		}
+
+		double bestCold = 0.0;
+		double bestWarm = 0.0;
+		for (int i = 0; i < iterations * 2; i++)
+		{
+			//Alternate cold and warm loads, so the warm ones always follow a load of the same file
+			bool cold = i % 2 == 0;
+			if (cold)
+			{
+				MappedFile::Evict(filenames[e]);
+			}
+
+			Clock::time_point start = Clock::now();
+			MappedFile file;
+			std::vector<char> decoded;
+			MeshBinaryView view;
+			MeshBinaryStatus status = Map(filenames[e], sourceFilename, contents.Format, file, decoded, view);
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+			double& best = cold ? bestCold : bestWarm;
+			if (i < 2 || seconds < best) best = seconds;
+			if (status != MeshBinaryStatus::Valid)
+			{
+				loaded = false;
+			}
+			else if (i == 0)
+			{
+				//Keep what the first load decoded to, so both encodings can be compared
+				const char* payload = (const char*)view.Vertices;
+				size_t payloadSize = encodings[e] == MeshEncoding::Compressed ? decoded.size() : file.GetSize() - sizeof(MeshBinaryHeader);
+				payloads[e].assign(payload, payload + payloadSize);
+			}
+		}
+
+		MappedFile file(filenames[e]);
+		if (encodings[e] == MeshEncoding::Raw)
+		{
+			result.RawSize = file.GetSize();
+			result.RawColdMs = bestCold * 1000.0;
+			result.RawWarmMs = bestWarm * 1000.0;
+		}
+		else
+		{
+			result.CompressedSize = file.GetSize();
+			result.CompressedColdMs = bestCold * 1000.0;
+			result.CompressedWarmMs = bestWarm * 1000.0;
+		}
+
+		//Time decoding on its own, from a file that's already mapped and paged in
+		if (encodings[e] == MeshEncoding::Compressed && file.GetSize() > sizeof(MeshBinaryHeader))
+		{
+			const MeshBinaryHeader* header = (const MeshBinaryHeader*)file.GetData();
+			std::vector<char> decoded(payloads[0].size());
+			std::vector<unsigned char> scratch;
+			double bestDecode = 0.0;
+			for (int i = 0; i < iterations; i++)
+			{
+				Clock::time_point start = Clock::now();
+				DecodePayload(file.GetData() + sizeof(MeshBinaryHeader), file.GetSize() - sizeof(MeshBinaryHeader), header->Layout.Stride, header->VertexCount,
+					header->IndexSize, header->IndexCount, decoded.data(), decoded.size(), scratch);
+				double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+				if (i == 0 || seconds < bestDecode) bestDecode = seconds;
+			}
+			result.DecodeGBps = bestDecode > 0.0 ? decoded.size() / (bestDecode * 1024.0 * 1024.0 * 1024.0) : 0.0;
+		}
+	}
+
+	for (const std::string& filename : filenames)
+	{
+		std::error_code error;
+		std::filesystem::remove(filename, error);
+	}
+
+	result.Identical = loaded && payloads[0] == payloads[1];
+	return result;
+}
+
+const char* MeshBinary::GetStatusName(MeshBinaryStatus status)
+{
+	switch (status)
+	{
+	case MeshBinaryStatus::Valid: return "valid";
+	case MeshBinaryStatus::Missing: return "missing";
+	case MeshBinaryStatus::Corrupt: return "corrupt";
+	case MeshBinaryStatus::WrongVersion: return "wrong version";
+	case MeshBinaryStatus::WrongFormat: return "in a different vertex format";
+	case MeshBinaryStatus::Stale: return "stale";
+	}
+	return "unknown";
+}
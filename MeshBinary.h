@@ -0,0 +1,281 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Bounds.h"
+#include "MappedFile.h"
+#include "Meshlets.h"
+#include "Simplifier.h"
+#include "Submesh.h"
+#include "VertexFormat.h"
+
+/// <summary>Identifies the source file a binary mesh was built from, so it can tell when it is out of date</summary>
+struct MeshSourceInfo
+{
+	uint64_t Size;
+	/// <summary>The file's last write time, in the file system's own units</summary>
+	uint64_t ModifiedTime;
+	/// <summary>MeshBinary::Hash of the whole file. 0 if it hasn't been calculated</summary>
+	uint64_t Hash;
+};
+
+/// <summary>How the payload of a binary mesh is stored</summary>
+enum class MeshEncoding : uint32_t
+{
+	/// <summary>Exactly as it's laid out in memory, so it can be used straight from the file</summary>
+	Raw,
+	/// <summary><para>Compressed with MeshCodec: the vertices, the indices and everything after them are three separate streams, after a table of their sizes. </para>
+	/// <para>Usually 45 to 75% of the size of Raw, so quicker to load from a slow disk, but has to be decoded into memory before it can be used.</para></summary>
+	Compressed,
+};
+
+/// <summary><para>The fixed size header at the start of every binary mesh. The vertices follow straight after it, then the indices. </para>
+/// <para>The meshlets come next, after enough padding to align them to 4 bytes, then the levels of detail, then the submeshes. That is the decoded layout,
+/// which is also how a Raw payload is stored. </para>
+/// <para>All fields are little-endian and fixed width so the file means the same thing to every build.</para></summary>
+struct MeshBinaryHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	/// <summary>sizeof(MeshBinaryHeader) when the file was written</summary>
+	uint32_t HeaderSize;
+	/// <summary>2 or 4 bytes</summary>
+	uint32_t IndexSize;
+	uint32_t VertexCount;
+	uint32_t IndexCount;
+	VertexFormat Format;
+	uint32_t MeshletCount;
+	/// <summary>How many levels of detail there are, including the full detail one. Each is a range of the indices</summary>
+	uint32_t LodCount;
+	/// <summary>How many submeshes there are. Each has its own range of the indices, meshlets and levels of detail</summary>
+	uint32_t SubmeshCount;
+	MeshEncoding Encoding;
+	/// <summary>The layout of Format when the file was written</summary>
+	VertexLayoutDesc Layout;
+	/// <summary>Turns quantized positions back into model space</summary>
+	VertexQuantization Quantization;
+	/// <summary>The box and sphere around the vertices, in model space</summary>
+	MeshBounds Bounds;
+	MeshSourceInfo Source;
+	/// <summary>How many bytes follow the header, as stored rather than decoded</summary>
+	uint64_t PayloadSize;
+	/// <summary>MeshBinary::Hash of everything after the header, so a truncated or corrupt file is caught</summary>
+	uint64_t PayloadHash;
+};
+static_assert(sizeof(MeshBinaryHeader) % 8 == 0, "The vertices follow the header directly, so its size has to keep them aligned");
+
+/// <summary>Why a binary mesh could or couldn't be used</summary>
+enum class MeshBinaryStatus
+{
+	Valid,
+	/// <summary>There is no binary file</summary>
+	Missing,
+	/// <summary>The file is too short, has the wrong magic, or its payload doesn't match its header</summary>
+	Corrupt,
+	/// <summary>Written by an older (or newer) version of the format, or with a different layout for its vertex format</summary>
+	WrongVersion,
+	/// <summary>Written with a different vertex format than the one asked for</summary>
+	WrongFormat,
+	/// <summary>The source file has changed since the binary was written</summary>
+	Stale,
+};
+
+/// <summary>Everything that goes into a binary mesh. The arrays are owned by the caller</summary>
+struct MeshBinaryContents
+{
+	VertexFormat Format;
+	VertexQuantization Quantization;
+	/// <summary>The box and sphere around the vertices, in model space</summary>
+	MeshBounds Bounds;
+	/// <summary>VertexCount vertices in Format</summary>
+	const void* Vertices;
+	uint32_t VertexCount;
+	/// <summary>IndexCount indices, each IndexSize bytes</summary>
+	const void* Indices;
+	uint32_t IndexCount;
+	/// <summary>2 or 4 bytes</summary>
+	uint32_t IndexSize;
+	/// <summary>MeshletCount meshlets that cover the indices</summary>
+	const Meshlet* Meshlets;
+	uint32_t MeshletCount;
+	/// <summary>LodCount levels of detail, each a range of the indices</summary>
+	const MeshLod* Lods;
+	uint32_t LodCount;
+	/// <summary>SubmeshCount submeshes that split the indices, meshlets and levels of detail between them</summary>
+	const Submesh* Submeshes;
+	uint32_t SubmeshCount;
+};
+
+/// <summary>Points into a binary mesh that has been read or mapped into memory. Only valid while the buffer or MappedFile it came from is alive,
+/// and for a compressed mesh the buffer it was decoded into too</summary>
+struct MeshBinaryView
+{
+	const MeshBinaryHeader* Header;
+	/// <summary>Header->VertexCount vertices in Header->Format</summary>
+	const void* Vertices;
+	const void* Indices;
+	/// <summary>Header->MeshletCount meshlets</summary>
+	const Meshlet* Meshlets;
+	/// <summary>Header->LodCount levels of detail</summary>
+	const MeshLod* Lods;
+	/// <summary>Header->SubmeshCount submeshes</summary>
+	const Submesh* Submeshes;
+};
+
+/// <summary>The results of MeshBinary::Benchmark. Times are the fastest of every iteration</summary>
+struct MeshBinaryBenchmark
+{
+	/// <summary>The size of each file, header included</summary>
+	size_t RawSize;
+	size_t CompressedSize;
+	/// <summary>How long Map took with the file not in the page cache, so read from disk, in milliseconds</summary>
+	double RawColdMs;
+	double CompressedColdMs;
+	/// <summary>How long Map took with the file already in the page cache, in milliseconds</summary>
+	double RawWarmMs;
+	double CompressedWarmMs;
+	/// <summary>How fast the compressed payload decodes from memory, in decoded GB/s</summary>
+	double DecodeGBps;
+	/// <summary>Whether both files loaded, and the compressed payload decoded to exactly the raw one</summary>
+	bool Identical;
+};
+
+/// <summary>Works out MeshBinary::Hash of data that arrives a block at a time, e.g. a file too big to hold in memory. The hash depends on the total size,
+/// so that has to be known before the first block</summary>
+class MeshHasher
+{
+private:
+	uint64_t m_hash;
+	/// <summary>The hash takes 8 bytes at a time, so the end of a block that doesn't fill a word waits here for the next one</summary>
+	unsigned char m_pending[8];
+	size_t m_pendingSize;
+
+public:
+	/// <param name="size">How many bytes will be added altogether</param>
+	MeshHasher(uint64_t size);
+
+	void Add(const void* data, size_t size);
+	/// <summary>The hash of everything added. Only call this once, after the last block</summary>
+	uint64_t Finish();
+};
+
+/// <summary><para>Writes a raw binary mesh a piece at a time, for meshes too big to build in memory first, see OBJStreamImporter. </para>
+/// <para>The vertices are appended first, then the indices, then the meshlets, in as many pieces as suit the caller. Finish writes the levels of detail
+/// and submeshes, checks everything the header promised arrived, and renames the file over the old one the same way Write does.
+/// Nothing replaces the old file unless Finish succeeds.</para></summary>
+class MeshBinaryWriter
+{
+private:
+	std::ofstream m_out;
+	std::string m_binaryFilename;
+	std::string m_tempFilename;
+	MeshBinaryHeader m_header;
+	/// <summary>Only the levels of detail and submeshes are used, by Finish</summary>
+	MeshBinaryContents m_contents;
+	MeshHasher m_hasher;
+	/// <summary>How much of the payload has been written so far</summary>
+	uint64_t m_written;
+	uint64_t m_meshletOffset;
+
+	bool Write(const void* data, size_t size);
+	/// <summary>Fills the gap between the indices and the meshlets, once every vertex and index has been written</summary>
+	bool Pad();
+	void Abandon();
+
+public:
+	MeshBinaryWriter();
+	~MeshBinaryWriter();
+
+	MeshBinaryWriter(const MeshBinaryWriter&) = delete;
+	MeshBinaryWriter& operator=(const MeshBinaryWriter&) = delete;
+
+	/// <summary>Starts writing a binary mesh to a temporary file next to binaryFilename</summary>
+	/// <param name="contents">The counts, format, quantization, bounds, levels of detail and submeshes. Vertices, Indices and Meshlets are ignored,
+	/// as they're appended instead. The levels of detail and submeshes have to stay alive until Finish</param>
+	/// <returns>false if the temporary file couldn't be created</returns>
+	bool Open(const std::string& binaryFilename, const MeshSourceInfo& source, const MeshBinaryContents& contents);
+
+	/// <summary>Appends the next part of the vertices, or once they're all written, of the indices</summary>
+	/// <returns>false if it couldn't be written, or is more than the header has room for</returns>
+	bool Append(const void* data, size_t size);
+
+	/// <summary>Appends the next meshlets, after every vertex and index</summary>
+	bool AppendMeshlets(const Meshlet* meshlets, size_t count);
+
+	/// <summary>Writes the levels of detail and submeshes and the finished header, then swaps the file in</summary>
+	/// <returns>false if anything was missing or couldn't be written, in which case any existing file is left untouched</returns>
+	bool Finish();
+};
+
+/// <summary><para>Reads and writes the .objBinary cache that OBJLoader keeps next to each model. </para>
+/// <para>Files are written to a temporary file and renamed over the old one, so a crash mid-write never leaves a half-written cache,
+/// and are checked against their source's size, write time and content hash when read, so editing a model rebuilds its cache.</para></summary>
+namespace MeshBinary
+{
+	/// <summary>"OBJB" read as a little-endian uint32_t</summary>
+	const uint32_t Magic = 'O' | ('B' << 8) | ('J' << 16) | ('B' << 24);
+	/// <summary><para>Version 1 was the original headerless dump. Bump this whenever the layout of the file, or how its contents are produced, changes. </para>
+	/// <para>3: triangles are in vertex cache optimized order and vertices in first-use order. </para>
+	/// <para>4: triangle clusters are sorted to reduce overdraw. </para>
+	/// <para>5: the vertex format and position quantization are stored, vertices may be compact. </para>
+	/// <para>6: meshlets with bounding spheres and normal cones follow the indices. </para>
+	/// <para>7: simplified levels of detail are appended to the indices, and their ranges follow the meshlets. </para>
+	/// <para>8: the mesh's bounding box and sphere are stored in the header. </para>
+	/// <para>9: the payload may be compressed, see MeshEncoding. </para>
+	/// <para>10: faces are grouped into submeshes by material, and the submeshes follow the levels of detail. </para>
+	/// <para>11: each submesh stores its model and texture coordinate area, so texture mips can be picked for it</para></summary>
+	const uint32_t Version = 11;
+
+	/// <summary>A fast 64 bit hash of a block of memory</summary>
+	uint64_t Hash(const void* data, size_t size);
+
+	/// <summary>Gets a file's size and write time, and optionally hashes its contents</summary>
+	/// <returns>false if the file doesn't exist or couldn't be read</returns>
+	bool GetSourceInfo(const std::string& sourceFilename, MeshSourceInfo& info, bool hashContents);
+
+	/// <summary>Reads the source file a binary mesh says it was built from, from its header alone. Nothing else in the file is checked</summary>
+	/// <returns>false if the file is missing, or isn't a binary mesh of this version</returns>
+	bool ReadSourceInfo(const std::string& binaryFilename, MeshSourceInfo& info);
+
+	/// <summary>Writes a binary mesh to a temporary file, then renames it over binaryFilename</summary>
+	/// <param name="source">Identifies the source file this mesh was built from</param>
+	/// <param name="encoding">How to store the payload. Either is read back the same way</param>
+	/// <returns>false if the file couldn't be written, in which case any existing file is left untouched</returns>
+	bool Write(const std::string& binaryFilename, const MeshSourceInfo& source, const MeshBinaryContents& contents, MeshEncoding encoding = MeshEncoding::Raw);
+
+	/// <summary><para>Reads a whole binary mesh into buffer in a single read and checks it is complete and up to date. </para>
+	/// <para>The source is only hashed when its write time has changed but its size hasn't, which is when a touched file may still be the same.
+	/// If the source file is missing, the binary is trusted.</para></summary>
+	/// <param name="sourceFilename">The file the binary mesh was built from</param>
+	/// <param name="format">The vertex format the binary mesh should be in</param>
+	/// <param name="buffer">Holds the file's contents. view points into this</param>
+	/// <param name="decoded">Holds the payload if it was compressed, in which case view points into this instead</param>
+	/// <returns>Valid if view can be used</returns>
+	MeshBinaryStatus Read(const std::string& binaryFilename, const std::string& sourceFilename, VertexFormat format, std::vector<char>& buffer, std::vector<char>& decoded, MeshBinaryView& view);
+
+	/// <summary><para>Maps a binary mesh into memory and checks it the same way Read does. </para>
+	/// <para>A raw mesh's view points straight into the mapping, so the vertices and indices can be handed to the GPU without being copied onto the heap first.
+	/// A compressed mesh is decoded from the mapping into decoded instead.</para></summary>
+	/// <param name="file">Holds the mapping. view points into this</param>
+	/// <param name="decoded">Holds the payload if it was compressed, in which case view points into this instead</param>
+	/// <returns>Valid if view can be used</returns>
+	MeshBinaryStatus Map(const std::string& binaryFilename, const std::string& sourceFilename, VertexFormat format, MappedFile& file, std::vector<char>& decoded, MeshBinaryView& view);
+
+	/// <summary>Checks a whole binary mesh that is already in memory, decodes it if it's compressed, and points view into it if it's complete and up to date</summary>
+	/// <param name="data">The start of the file's contents. Must be at least 8 byte aligned</param>
+	/// <param name="size">The size of the file in bytes</param>
+	/// <param name="decoded">Holds the payload if it was compressed. Resized to fit, so keeping it between meshes saves reallocating it</param>
+	MeshBinaryStatus Validate(const char* data, size_t size, const std::string& sourceFilename, VertexFormat format, std::vector<char>& decoded, MeshBinaryView& view);
+
+	/// <summary><para>Writes contents both raw and compressed next to binaryFilename, then times loading each of them with Map, from a cold and a warm page cache. </para>
+	/// <para>The page cache is emptied of each file with MappedFile::Evict before every cold load. Both files are deleted afterwards.</para></summary>
+	/// <param name="binaryFilename">Where to write the files, with .raw and .compressed appended</param>
+	/// <param name="sourceFilename">The file contents was built from, which Map checks the files against</param>
+	/// <param name="iterations">How many times each load is timed. The fastest time is reported</param>
+	MeshBinaryBenchmark Benchmark(const std::string& binaryFilename, const std::string& sourceFilename, const MeshSourceInfo& source, const MeshBinaryContents& contents, int iterations = 5);
+
+	/// <summary>A readable name for a status, for debug output</summary>
+	const char* GetStatusName(MeshBinaryStatus status);
+};
@@ -0,0 +1,162 @@
+#include "MeshCache.h"
+#include <cstdio>
+#include <tuple>
+
+bool MeshCache::Key::operator<(const Key& other) const
+{
+	return std::tie(Hash, Size, Format) < std::tie(other.Hash, other.Size, other.Format);
+}
+
+MeshCache::MeshCache()
+{
+	m_geometryPool = nullptr;
+	m_hits = 0;
+	m_misses = 0;
+	m_evictions = 0;
+}
+
+MeshCache::~MeshCache()
+{
+	for (auto& entry : m_entries)
+	{
+		Destroy(entry.second.Loaded);
+	}
+	delete m_geometryPool;
+}
+
+MeshCache& MeshCache::GetShared()
+{
+	static MeshCache cache;
+	return cache;
+}
+
+GeometryPool* MeshCache::GetGeometryPool(ID3D11Device* d3dDevice, ID3D11DeviceContext* immediateContext)
+{
+	if (m_geometryPool == nullptr)
+	{
+		m_geometryPool = new GeometryPool(d3dDevice, immediateContext);
+	}
+	return m_geometryPool;
+}
+
+Mesh* MeshCache::Acquire(ID3D11Device* d3dDevice, ID3D11DeviceContext* immediateContext, const std::string& path, VertexFormat format)
+{
+	GeometryPool* pool = GetGeometryPool(d3dDevice, immediateContext);
+
+	//A missing file can't be hashed, so it's loaded uncached and fails the way it always has
+	MeshSourceInfo source;
+	if (!MeshBinary::GetSourceInfo(path, source, false))
+	{
+		m_misses++;
+		return LoadOBJ(d3dDevice, path, format, pool);
+	}
+
+	//Only files that have changed since they were last hashed are read through again, and not even those if their binary mesh was built from
+	//them as they are now, as it has the hash already
+	HashedFile& hashed = m_hashedFiles[path];
+	if (hashed.Hash == 0 || hashed.Size != source.Size || hashed.ModifiedTime != source.ModifiedTime)
+	{
+		MeshSourceInfo cooked;
+		if (MeshBinary::ReadSourceInfo(OBJImporter::GetBinaryFilename(path), cooked) && cooked.Hash != 0 && cooked.Size == source.Size &&
+			cooked.ModifiedTime == source.ModifiedTime)
+		{
+			source.Hash = cooked.Hash;
+		}
+		else
+		{
+			MeshBinary::GetSourceInfo(path, source, true);
+		}
+		hashed.Size = source.Size;
+		hashed.ModifiedTime = source.ModifiedTime;
+		hashed.Hash = source.Hash;
+	}
+
+	Key key = { hashed.Hash, hashed.Size, format };
+	auto found = m_entries.find(key);
+	if (found != m_entries.end())
+	{
+		m_hits++;
+		Entry& entry = found->second;
+		entry.References++;
+		return entry.Loaded;
+	}
+
+	m_misses++;
+	Mesh* mesh = LoadOBJ(d3dDevice, path, format, pool);
+	if (mesh->Lods.empty())
+	{
+		return mesh;
+	}
+
+	Entry entry;
+	entry.Loaded = mesh;
+	entry.References = 1;
+	entry.GpuBytes = (uint64_t)mesh->VertexCount * mesh->VBStride + (uint64_t)mesh->IndexCount * OBJLoader::GetIndexSize(mesh->IndexFormat);
+	entry.CpuBytes = sizeof(Mesh) + mesh->Meshlets.size() * sizeof(Meshlet) + mesh->Lods.size() * sizeof(MeshLod) + mesh->Submeshes.size() * sizeof(Submesh);
+	m_entries.insert({ key, entry });
+	m_keys.insert({ mesh, key });
+	return mesh;
+}
+
+void MeshCache::Release(Mesh* mesh)
+{
+	auto key = m_keys.find(mesh);
+	if (key == m_keys.end())
+	{
+		//Only meshes that failed to load are handed out uncached, and nothing else holds them
+		Destroy(mesh);
+		return;
+	}
+
+	auto found = m_entries.find(key->second);
+	if (--found->second.References == 0)
+	{
+		Destroy(mesh);
+		m_entries.erase(found);
+		m_keys.erase(key);
+		m_evictions++;
+	}
+}
+
+void MeshCache::Destroy(Mesh* mesh)
+{
+	if (mesh->Pool)
+	{
+		mesh->Pool->Remove(mesh->Geometry);
+	}
+	else
+	{
+		if (mesh->VertexBuffer) mesh->VertexBuffer->Release();
+		if (mesh->IndexBuffer) mesh->IndexBuffer->Release();
+	}
+	delete mesh;
+}
+
+MeshCacheStats MeshCache::GetStats() const
+{
+	MeshCacheStats stats;
+	stats.Hits = m_hits;
+	stats.Misses = m_misses;
+	stats.Evictions = m_evictions;
+	stats.MeshCount = (uint32_t)m_entries.size();
+	stats.ReferenceCount = 0;
+	stats.ResidentGpuBytes = 0;
+	stats.ResidentCpuBytes = 0;
+	for (const auto& entry : m_entries)
+	{
+		stats.ReferenceCount += entry.second.References;
+		stats.ResidentGpuBytes += entry.second.GpuBytes;
+		stats.ResidentCpuBytes += entry.second.CpuBytes;
+	}
+	return stats;
+}
+
+void MeshCache::Report(const char* name) const
+{
+	MeshCacheStats stats = GetStats();
+	char line[320];
+	sprintf_s(line, "%s: mesh cache %u meshes, %u references, %llu hits, %llu misses, %llu evicted, %.2f MB on the GPU, %.2f MB on the CPU\n",
+		name, stats.MeshCount, stats.ReferenceCount, (unsigned long long)stats.Hits, (unsigned long long)stats.Misses, (unsigned long long)stats.Evictions,
+		stats.ResidentGpuBytes / (1024.0 * 1024.0), stats.ResidentCpuBytes / (1024.0 * 1024.0));
+	OutputDebugStringA(line);
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <map>
+#include <string>
+
+#include "Loading.h"
+
+/// <summary>How often a MeshCache has saved a load, and what it's holding</summary>
+struct MeshCacheStats
+{
+	/// <summary>Acquires answered with a mesh already loaded, from the same file or another with identical contents</summary>
+	uint64_t Hits;
+	/// <summary>Acquires that had to load the mesh</summary>
+	uint64_t Misses;
+	/// <summary>Meshes freed as the last reference to them was released</summary>
+	uint64_t Evictions;
+	uint32_t MeshCount;
+	/// <summary>References held across every mesh, so more than MeshCount when meshes are shared</summary>
+	uint32_t ReferenceCount;
+	/// <summary>The vertices and indices of every mesh held, on the GPU</summary>
+	uint64_t ResidentGpuBytes;
+	/// <summary>The meshlets, levels of detail and submeshes of every mesh held, on the CPU</summary>
+	uint64_t ResidentCpuBytes;
+};
+
+/// <summary><para>Loads each mesh once for the whole process, however many level entries or levels use it. </para>
+/// <para>Meshes are keyed by the hash of their .obj file's contents and their vertex format, so two entries pointing at the same
+/// file, copies of a file under different names, and a level being loaded again while the old one is still alive all share one set of buffers. Each
+/// Acquire is a reference, and the mesh is freed when the last is released. </para>
+/// <para>A file's hash is taken from its binary mesh when that was built from the file at its current size and write time, so loading a level that's
+/// been cooked doesn't read any .obj file through. Otherwise it's hashed, and only hashed again if its size or write time changes. Every mesh goes in
+/// one GeometryPool the cache owns. Only used from the thread that owns the immediate context.</para></summary>
+class MeshCache
+{
+private:
+	struct Key
+	{
+		uint64_t Hash;
+		uint64_t Size;
+		VertexFormat Format;
+
+		bool operator<(const Key& other) const;
+	};
+
+	struct Entry
+	{
+		Mesh* Loaded;
+		uint32_t References;
+		uint64_t GpuBytes;
+		uint64_t CpuBytes;
+	};
+
+	/// <summary>A file as it was when it was last hashed</summary>
+	struct HashedFile
+	{
+		uint64_t Size;
+		uint64_t ModifiedTime;
+		uint64_t Hash;
+	};
+
+	std::map<Key, Entry> m_entries;
+	/// <summary>The key each mesh handed out is under, so Release can find its entry</summary>
+	std::map<Mesh*, Key> m_keys;
+	std::map<std::string, HashedFile> m_hashedFiles;
+
+	GeometryPool* m_geometryPool;
+
+	uint64_t m_hits;
+	uint64_t m_misses;
+	uint64_t m_evictions;
+
+public:
+	MeshCache();
+	/// <summary>Frees every mesh still held, then the pool</summary>
+	~MeshCache();
+
+	MeshCache(const MeshCache&) = delete;
+	MeshCache& operator=(const MeshCache&) = delete;
+
+	/// <summary>The cache every level loads its meshes through</summary>
+	static MeshCache& GetShared();
+
+	/// <summary>Finds the mesh in the cache, or loads it into the cache's pool if it isn't there. Every call needs a matching Release</summary>
+	/// <returns>Never null. A mesh that failed to load has no levels of detail, and isn't cached so a fixed file loads next time</returns>
+	Mesh* Acquire(ID3D11Device* d3dDevice, ID3D11DeviceContext* immediateContext, const std::string& path, VertexFormat format);
+	/// <summary>Gives back a reference from Acquire, freeing the mesh if it was the last</summary>
+	void Release(Mesh* mesh);
+
+	/// <summary>The pool every cached mesh is in, created on first use</summary>
+	GeometryPool* GetGeometryPool(ID3D11Device* d3dDevice, ID3D11DeviceContext* immediateContext);
+
+	MeshCacheStats GetStats() const;
+	/// <summary>Writes the hits, misses and bytes held to the debug output</summary>
+	void Report(const char* name) const;
+
+private:
+	/// <summary>Frees a mesh's range of the pool, or its own buffers, then the mesh</summary>
+	static void Destroy(Mesh* mesh);
+};
@@ -0,0 +1,531 @@
+#include "MeshCodec.h"
+#include <algorithm>
+#include <cstring>
+
+//Every x86 and x64 build has SSE2, which DecodeVertices uses to put 16 vertices back together at once. Anything else decodes one byte at a time
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MESHCODEC_SSE2
+#endif
+
+namespace
+{
+	//The hash table holds the last position each 4 byte sequence was seen at. 2^16 entries covers the whole window
+	const int HashBits = 16;
+	//The last bytes of a block are always literals, and matches end before them, so the decoder can copy in 8 byte steps without checking each one
+	const size_t LastLiterals = 8;
+	//The first byte of an encoded vertex stream says how the vertices were filtered before being compressed
+	enum VertexFilter : unsigned char
+	{
+		//Compressed as they are. Meshes with flat shading or repeated texture coordinates often have whole vertices that repeat,
+		//which the matcher finds more of before filtering than after
+		Unfiltered = 0,
+		//The difference of each 16 bit lane from the vertex before, zigzag coded, split into byte planes
+		Delta = 1,
+	};
+
+	uint32_t Load32(const unsigned char* data)
+	{
+		uint32_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	uint32_t HashSequence(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - HashBits);
+	}
+
+	//Counts of 15 or more spill into following bytes, each adding up to 255
+	void WriteLength(std::vector<unsigned char>& out, size_t length)
+	{
+		while (length >= 255)
+		{
+			out.push_back(255);
+			length -= 255;
+		}
+		out.push_back((unsigned char)length);
+	}
+
+	bool ReadLength(const unsigned char*& in, const unsigned char* end, size_t& length)
+	{
+		unsigned char next;
+		do
+		{
+			if (in >= end)
+			{
+				return false;
+			}
+			next = *in++;
+			length += next;
+		} while (next == 255);
+		return true;
+	}
+
+	void WriteSequence(std::vector<unsigned char>& out, const unsigned char* literals, size_t literalCount, size_t offset, size_t matchLength)
+	{
+		size_t matchCode = matchLength - MeshCodec::MinMatch;
+		out.push_back((unsigned char)((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+		if (literalCount >= 15) WriteLength(out, literalCount - 15);
+		out.insert(out.end(), literals, literals + literalCount);
+		out.push_back((unsigned char)(offset & 0xFF));
+		out.push_back((unsigned char)(offset >> 8));
+		if (matchCode >= 15) WriteLength(out, matchCode - 15);
+	}
+
+	void WriteLastLiterals(std::vector<unsigned char>& out, const unsigned char* literals, size_t literalCount)
+	{
+		out.push_back((unsigned char)(std::min<size_t>(literalCount, 15) << 4));
+		if (literalCount >= 15) WriteLength(out, literalCount - 15);
+		out.insert(out.end(), literals, literals + literalCount);
+	}
+
+	//Zigzag coding maps 0, -1, 1, -2, 2... to 0, 1, 2, 3, 4..., so small steps either way only need the low bits
+	uint32_t Zigzag(uint32_t delta, unsigned int bits)
+	{
+		uint32_t sign = (delta >> (bits - 1)) & 1;
+		uint32_t mask = bits == 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+		return ((delta << 1) ^ (0u - sign)) & mask;
+	}
+
+	uint32_t Unzigzag(uint32_t value)
+	{
+		return (value >> 1) ^ (0u - (value & 1));
+	}
+
+	uint16_t Unzigzag16(uint16_t value)
+	{
+		return (uint16_t)((value >> 1) ^ (0u - (value & 1)));
+	}
+
+	//Puts vertices [first, last) back together from their planes, one 16 bit lane at a time. previous holds the last vertex decoded
+	void UnfilterVertices(const unsigned char* planes, size_t count, size_t stride, size_t first, size_t last, unsigned char* vertices, uint16_t* previous)
+	{
+		for (size_t v = first; v < last; v++)
+		{
+			for (size_t lane = 0; lane < stride / 2; lane++)
+			{
+				uint16_t value = (uint16_t)(planes[2 * lane * count + v] | (planes[(2 * lane + 1) * count + v] << 8));
+				previous[lane] = (uint16_t)(previous[lane] + Unzigzag16(value));
+				memcpy(vertices + v * stride + lane * 2, &previous[lane], sizeof(uint16_t));
+			}
+		}
+	}
+
+#ifdef MESHCODEC_SSE2
+	//Turns 16 rows of 16 bytes into 16 columns, so 16 bytes from each of 16 planes become the 16 bytes of each of 16 vertices.
+	//Each round interleaves pairs of rows at twice the width of the last, the usual 4 step byte transpose
+	void Transpose16x16(__m128i rows[16])
+	{
+		__m128i pairs[16];
+		for (int i = 0; i < 8; i++)
+		{
+			pairs[i] = _mm_unpacklo_epi8(rows[2 * i], rows[2 * i + 1]);
+			pairs[i + 8] = _mm_unpackhi_epi8(rows[2 * i], rows[2 * i + 1]);
+		}
+
+		__m128i quads[16];
+		for (int half = 0; half < 16; half += 8)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				quads[half + j] = _mm_unpacklo_epi16(pairs[half + 2 * j], pairs[half + 2 * j + 1]);
+				quads[half + 4 + j] = _mm_unpackhi_epi16(pairs[half + 2 * j], pairs[half + 2 * j + 1]);
+			}
+		}
+
+		for (int group = 0; group < 16; group += 4)
+		{
+			__m128i low01 = _mm_unpacklo_epi32(quads[group], quads[group + 1]);
+			__m128i low23 = _mm_unpackhi_epi32(quads[group], quads[group + 1]);
+			__m128i high01 = _mm_unpacklo_epi32(quads[group + 2], quads[group + 3]);
+			__m128i high23 = _mm_unpackhi_epi32(quads[group + 2], quads[group + 3]);
+			rows[group] = _mm_unpacklo_epi64(low01, high01);
+			rows[group + 1] = _mm_unpackhi_epi64(low01, high01);
+			rows[group + 2] = _mm_unpacklo_epi64(low23, high23);
+			rows[group + 3] = _mm_unpackhi_epi64(low23, high23);
+		}
+	}
+
+	//The same as UnfilterVertices for vertices whose stride is a multiple of 16, 16 vertices at a time. Returns the first vertex it didn't decode
+	size_t UnfilterVerticesSSE2(const unsigned char* planes, size_t count, size_t stride, unsigned char* vertices, uint16_t* previous)
+	{
+		size_t groups = stride / 16;
+		size_t whole = count - count % 16;
+		const __m128i one = _mm_set1_epi16(1);
+		const __m128i zero = _mm_setzero_si128();
+		for (size_t group = 0; group < groups; group++)
+		{
+			__m128i running = _mm_loadu_si128((const __m128i*)(previous + group * 8));
+			for (size_t first = 0; first < whole; first += 16)
+			{
+				__m128i rows[16];
+				for (int b = 0; b < 16; b++)
+				{
+					rows[b] = _mm_loadu_si128((const __m128i*)(planes + (group * 16 + b) * count + first));
+				}
+				Transpose16x16(rows);
+
+				for (int v = 0; v < 16; v++)
+				{
+					__m128i delta = _mm_xor_si128(_mm_srli_epi16(rows[v], 1), _mm_sub_epi16(zero, _mm_and_si128(rows[v], one)));
+					running = _mm_add_epi16(running, delta);
+					_mm_storeu_si128((__m128i*)(vertices + (first + v) * stride + group * 16), running);
+				}
+			}
+			_mm_storeu_si128((__m128i*)(previous + group * 8), running);
+		}
+		return whole;
+	}
+
+	//Puts 16 bit indices back together 8 at a time: the two planes are interleaved into 8 differences, which are summed in 3 steps of shifting
+	//and adding, then offset by the last index of the 8 before. Returns the first index it didn't decode
+	size_t UnfilterIndices16SSE2(const unsigned char* planes, size_t count, uint16_t* indices, uint16_t& previous)
+	{
+		size_t whole = count - count % 8;
+		const __m128i one = _mm_set1_epi16(1);
+		const __m128i zero = _mm_setzero_si128();
+		__m128i running = _mm_set1_epi16((short)previous);
+		for (size_t first = 0; first < whole; first += 8)
+		{
+			__m128i low = _mm_loadl_epi64((const __m128i*)(planes + first));
+			__m128i high = _mm_loadl_epi64((const __m128i*)(planes + count + first));
+			__m128i value = _mm_unpacklo_epi8(low, high);
+			__m128i delta = _mm_xor_si128(_mm_srli_epi16(value, 1), _mm_sub_epi16(zero, _mm_and_si128(value, one)));
+			delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 2));
+			delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 4));
+			delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 8));
+			__m128i sums = _mm_add_epi16(running, delta);
+			_mm_storeu_si128((__m128i*)(indices + first), sums);
+			__m128i last = _mm_shufflehi_epi16(sums, 0xFF);
+			running = _mm_unpackhi_epi64(last, last);
+		}
+		if (whole != 0)
+		{
+			previous = indices[whole - 1];
+		}
+		return whole;
+	}
+
+	//The same for 32 bit indices, 4 at a time from 4 planes
+	size_t UnfilterIndices32SSE2(const unsigned char* planes, size_t count, uint32_t* indices, uint32_t& previous)
+	{
+		size_t whole = count - count % 4;
+		const __m128i one = _mm_set1_epi32(1);
+		const __m128i zero = _mm_setzero_si128();
+		__m128i running = _mm_set1_epi32((int)previous);
+		for (size_t first = 0; first < whole; first += 4)
+		{
+			__m128i bytes[4];
+			for (int b = 0; b < 4; b++)
+			{
+				int plane;
+				memcpy(&plane, planes + b * count + first, sizeof(plane));
+				bytes[b] = _mm_cvtsi32_si128(plane);
+			}
+			__m128i value = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes[0], bytes[1]), _mm_unpacklo_epi8(bytes[2], bytes[3]));
+			__m128i delta = _mm_xor_si128(_mm_srli_epi32(value, 1), _mm_sub_epi32(zero, _mm_and_si128(value, one)));
+			delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 4));
+			delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 8));
+			__m128i sums = _mm_add_epi32(running, delta);
+			_mm_storeu_si128((__m128i*)(indices + first), sums);
+			running = _mm_shuffle_epi32(sums, 0xFF);
+		}
+		if (whole != 0)
+		{
+			previous = indices[whole - 1];
+		}
+		return whole;
+	}
+#endif
+}
+
+size_t MeshCodec::GetMaxCompressedSize(size_t size)
+{
+	//One token and the length bytes for a single run of literals
+	return size + size / 255 + 16;
+}
+
+void MeshCodec::Compress(const unsigned char* data, size_t size, std::vector<unsigned char>& out)
+{
+	out.reserve(out.size() + GetMaxCompressedSize(size));
+
+	size_t anchor = 0;
+	if (size > LastLiterals + MinMatch)
+	{
+		std::vector<uint32_t> table((size_t)1 << HashBits, 0);
+		size_t matchLimit = size - LastLiterals;
+		size_t position = 0;
+		while (position + MinMatch <= matchLimit)
+		{
+			uint32_t sequence = Load32(data + position);
+			uint32_t& entry = table[HashSequence(sequence)];
+			size_t candidate = entry;
+			entry = (uint32_t)position;
+
+			if (candidate >= position || position - candidate > MaxOffset || Load32(data + candidate) != sequence)
+			{
+				//Step further each miss through data that doesn't repeat, so incompressible blocks don't take long to give up on
+				position += 1 + ((position - anchor) >> 6);
+				continue;
+			}
+
+			//Only 4 bytes have been compared, and the match may have started before the bytes that hashed the same
+			size_t length = 4;
+			while (position + length < matchLimit && data[candidate + length] == data[position + length])
+			{
+				length++;
+			}
+			size_t back = 0;
+			while (position - back > anchor && candidate - back > 0 && data[position - back - 1] == data[candidate - back - 1])
+			{
+				back++;
+			}
+			if (length + back < MinMatch)
+			{
+				position++;
+				continue;
+			}
+			position -= back;
+			candidate -= back;
+			length += back;
+
+			WriteSequence(out, data + anchor, position - anchor, position - candidate, length);
+			position += length;
+			anchor = position;
+
+			//Remember a position inside the match too, as the next match often starts just behind where this one ended
+			if (position - 2 + MinMatch <= size)
+			{
+				table[HashSequence(Load32(data + position - 2))] = (uint32_t)(position - 2);
+			}
+		}
+	}
+
+	WriteLastLiterals(out, data + anchor, size - anchor);
+}
+
+bool MeshCodec::Decompress(const unsigned char* data, size_t size, unsigned char* out, size_t outSize)
+{
+	const unsigned char* in = data;
+	const unsigned char* end = data + size;
+	unsigned char* write = out;
+	unsigned char* outEnd = out + outSize;
+
+	while (in < end)
+	{
+		unsigned int token = *in++;
+
+		size_t literalCount = token >> 4;
+		if (literalCount == 15 && !ReadLength(in, end, literalCount))
+		{
+			return false;
+		}
+		if (literalCount > (size_t)(end - in) || literalCount > (size_t)(outEnd - write))
+		{
+			return false;
+		}
+		//Most runs of literals are short, and one 16 byte copy is quicker than an exact one when there's room either side for it
+		if (literalCount <= 16 && end - in >= 16 && outEnd - write >= 16)
+		{
+			memcpy(write, in, 16);
+		}
+		else
+		{
+			memcpy(write, in, literalCount);
+		}
+		in += literalCount;
+		write += literalCount;
+
+		//The last sequence is only literals
+		if (in == end)
+		{
+			break;
+		}
+
+		if (end - in < 2)
+		{
+			return false;
+		}
+		size_t offset = in[0] | ((size_t)in[1] << 8);
+		in += 2;
+		size_t length = token & 15;
+		if (length == 15 && !ReadLength(in, end, length))
+		{
+			return false;
+		}
+		length += MinMatch;
+		if (offset == 0 || offset > (size_t)(write - out) || length > (size_t)(outEnd - write))
+		{
+			return false;
+		}
+
+		const unsigned char* match = write - offset;
+		if ((size_t)(outEnd - write) >= length + 32)
+		{
+			//Copy whole blocks from far enough back that they've all been written already, running past the end of the match rather than
+			//checking its exact length, as later sequences overwrite whatever is copied past it
+			if (offset >= 16)
+			{
+				for (size_t copied = 0; copied < length; copied += 16)
+				{
+					memcpy(write + copied, match + copied, 16);
+				}
+			}
+			else
+			{
+				//A closer match repeats every offset bytes, so its first repeats go a byte at a time and the rest is copied from a whole number
+				//of repeats back. Most matches are under 16 bytes, so the first two copies are made whatever the length, which with the byte copies
+				//can run up to 30 bytes ahead, hence the room checked for above
+				size_t step = offset;
+				size_t copied = 0;
+				if (offset < 8)
+				{
+					step = offset * ((8 + offset - 1) / offset);
+					for (; copied < step; copied++)
+					{
+						write[copied] = match[copied];
+					}
+				}
+				memcpy(write + copied, write + copied - step, 8);
+				memcpy(write + copied + 8, write + copied + 8 - step, 8);
+				for (copied += 16; copied < length; copied += 8)
+				{
+					memcpy(write + copied, write + copied - step, 8);
+				}
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < length; i++)
+			{
+				write[i] = match[i];
+			}
+		}
+		write += length;
+	}
+
+	return write == outEnd;
+}
+
+void MeshCodec::EncodeVertices(const void* vertices, size_t count, size_t stride, std::vector<unsigned char>& out)
+{
+	const unsigned char* bytes = (const unsigned char*)vertices;
+	std::vector<unsigned char> planes(count * stride);
+	for (size_t v = 0; v < count; v++)
+	{
+		for (size_t lane = 0; lane < stride / 2; lane++)
+		{
+			uint16_t value, previous = 0;
+			memcpy(&value, bytes + v * stride + lane * 2, sizeof(value));
+			if (v != 0) memcpy(&previous, bytes + (v - 1) * stride + lane * 2, sizeof(previous));
+			uint32_t zigzag = Zigzag((uint16_t)(value - previous), 16);
+			planes[2 * lane * count + v] = (unsigned char)zigzag;
+			planes[(2 * lane + 1) * count + v] = (unsigned char)(zigzag >> 8);
+		}
+	}
+
+	//Keep whichever is smaller, filtered or not
+	std::vector<unsigned char> filtered(1, Delta);
+	Compress(planes.data(), planes.size(), filtered);
+	std::vector<unsigned char> unfiltered(1, Unfiltered);
+	Compress(bytes, count * stride, unfiltered);
+	const std::vector<unsigned char>& smaller = filtered.size() <= unfiltered.size() ? filtered : unfiltered;
+	out.insert(out.end(), smaller.begin(), smaller.end());
+}
+
+bool MeshCodec::DecodeVertices(const unsigned char* data, size_t size, void* vertices, size_t count, size_t stride, std::vector<unsigned char>& scratch)
+{
+	if (size == 0 || stride % 2 != 0)
+	{
+		return false;
+	}
+	if (data[0] == Unfiltered)
+	{
+		return Decompress(data + 1, size - 1, (unsigned char*)vertices, count * stride);
+	}
+	if (data[0] != Delta)
+	{
+		return false;
+	}
+
+	scratch.resize(count * stride);
+	if (!Decompress(data + 1, size - 1, scratch.data(), scratch.size()))
+	{
+		return false;
+	}
+
+	unsigned char* bytes = (unsigned char*)vertices;
+	std::vector<uint16_t> previous(stride / 2, 0);
+	size_t first = 0;
+#ifdef MESHCODEC_SSE2
+	if (stride % 16 == 0)
+	{
+		first = UnfilterVerticesSSE2(scratch.data(), count, stride, bytes, previous.data());
+	}
+#endif
+	UnfilterVertices(scratch.data(), count, stride, first, count, bytes, previous.data());
+	return true;
+}
+
+void MeshCodec::EncodeIndices(const void* indices, size_t count, size_t indexSize, std::vector<unsigned char>& out)
+{
+	unsigned int bits = (unsigned int)indexSize * 8;
+	std::vector<unsigned char> planes(count * indexSize);
+	uint32_t previous = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t index = 0;
+		memcpy(&index, (const unsigned char*)indices + i * indexSize, indexSize);
+		uint32_t value = Zigzag(index - previous, bits);
+		previous = index;
+		for (size_t b = 0; b < indexSize; b++)
+		{
+			planes[b * count + i] = (unsigned char)(value >> (b * 8));
+		}
+	}
+
+	Compress(planes.data(), planes.size(), out);
+}
+
+bool MeshCodec::DecodeIndices(const unsigned char* data, size_t size, void* indices, size_t count, size_t indexSize, std::vector<unsigned char>& scratch)
+{
+	scratch.resize(count * indexSize);
+	if (!Decompress(data, size, scratch.data(), scratch.size()))
+	{
+		return false;
+	}
+
+	//Sums wrap at the index size, the same way the differences did
+	const unsigned char* planes = scratch.data();
+	if (indexSize == 2)
+	{
+		uint16_t* out = (uint16_t*)indices;
+		uint16_t previous = 0;
+		size_t first = 0;
+#ifdef MESHCODEC_SSE2
+		first = UnfilterIndices16SSE2(planes, count, out, previous);
+#endif
+		for (size_t i = first; i < count; i++)
+		{
+			previous = (uint16_t)(previous + Unzigzag16((uint16_t)(planes[i] | (planes[count + i] << 8))));
+			out[i] = previous;
+		}
+	}
+	else
+	{
+		uint32_t* out = (uint32_t*)indices;
+		uint32_t previous = 0;
+		size_t first = 0;
+#ifdef MESHCODEC_SSE2
+		first = UnfilterIndices32SSE2(planes, count, out, previous);
+#endif
+		for (size_t i = first; i < count; i++)
+		{
+			uint32_t value = planes[i] | ((uint32_t)planes[count + i] << 8) | ((uint32_t)planes[2 * count + i] << 16) | ((uint32_t)planes[3 * count + i] << 24);
+			previous += Unzigzag(value);
+			out[i] = previous;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary><para>Compresses the vertex and index buffers of binary meshes so they take less time to read from slow disks. </para>
+/// <para>Each buffer is first filtered so that similar bytes line up, then compressed with a small LZ77 coder in the style of LZ4, which only
+/// ever copies bytes while decoding so decodes at GB/s. There is no entropy coding: the filters leave runs of zeros and repeats for the
+/// matcher to find instead.</para></summary>
+namespace MeshCodec
+{
+	/// <summary>The shortest repeat the LZ stage will encode as a match, rather than as literals. Shorter matches barely save anything once their
+	/// token and offset are paid for, but split up runs of literals and cost the decoder a sequence each</summary>
+	const size_t MinMatch = 6;
+	/// <summary>How far back a match can reach, which is as far as its 16 bit offset can count</summary>
+	const size_t MaxOffset = 65535;
+
+	/// <summary>The most bytes Compress can write for size bytes of input, when nothing at all repeats</summary>
+	size_t GetMaxCompressedSize(size_t size);
+
+	/// <summary><para>Compresses a block of memory with greedy LZ77 matching, appending the result to out. </para>
+	/// <para>Each sequence is a token byte holding 4 bits of literal count and 4 bits of match length, longer counts in following bytes,
+	/// the literals themselves, then the match's 16 bit offset. The last sequence is only literals.</para></summary>
+	void Compress(const unsigned char* data, size_t size, std::vector<unsigned char>& out);
+
+	/// <summary>Decompresses a block written by Compress</summary>
+	/// <param name="out">Where to write the decompressed bytes, at least outSize long</param>
+	/// <param name="outSize">How many bytes the block holds when decompressed</param>
+	/// <returns>false if the block is corrupt or doesn't decompress to exactly outSize bytes. Never reads or writes out of bounds either way</returns>
+	bool Decompress(const unsigned char* data, size_t size, unsigned char* out, size_t outSize);
+
+	/// <summary><para>Compresses vertices of any format with an even stride, appending the result to out. </para>
+	/// <para>Each 16 bit lane of a vertex is replaced by its difference from the same lane of the vertex before, zigzag coded, and the bytes are
+	/// then split into planes, so all the first bytes come first, then all the second bytes, and so on. Vertices in fetch order are close together,
+	/// so the planes holding the high bytes end up mostly zero. Meshes whose vertices repeat exactly compress better as they are, so whichever
+	/// is smaller is kept.</para></summary>
+	/// <param name="stride">The size of one vertex in bytes</param>
+	void EncodeVertices(const void* vertices, size_t count, size_t stride, std::vector<unsigned char>& out);
+
+	/// <summary>Decodes vertices written by EncodeVertices</summary>
+	/// <param name="vertices">Where to write the vertices, at least count * stride bytes</param>
+	/// <param name="scratch">Holds the planes while they're put back together. Kept by the caller so it can be reused between meshes</param>
+	/// <returns>false if the data is corrupt</returns>
+	bool DecodeVertices(const unsigned char* data, size_t size, void* vertices, size_t count, size_t stride, std::vector<unsigned char>& scratch);
+
+	/// <summary><para>Compresses 16 or 32 bit indices, appending the result to out. </para>
+	/// <para>Each index is replaced by its difference from the index before, zigzag coded so small steps back are small numbers too, then split
+	/// into byte planes like vertices. Cache optimized triangles mostly step a short way from the last index, so the high planes are mostly zero.</para></summary>
+	/// <param name="indexSize">2 or 4 bytes</param>
+	void EncodeIndices(const void* indices, size_t count, size_t indexSize, std::vector<unsigned char>& out);
+
+	/// <summary>Decodes indices written by EncodeIndices</summary>
+	/// <param name="indices">Where to write the indices, at least count * indexSize bytes</param>
+	/// <param name="scratch">Holds the planes while they're put back together. Kept by the caller so it can be reused between meshes</param>
+	/// <returns>false if the data is corrupt</returns>
+	bool DecodeIndices(const unsigned char* data, size_t size, void* indices, size_t count, size_t indexSize, std::vector<unsigned char>& scratch);
+};
@@ -0,0 +1,527 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+	//The tuning constants from Forsyth's paper
+	const float CacheDecayPower = 1.5f;
+	const float LastTriangleScore = 0.75f;
+	const float ValenceBoostScale = 2.0f;
+	const float ValenceBoostPower = 0.5f;
+
+	const unsigned int NoTriangle = 0xFFFFFFFF;
+
+	//The directions AnalyzeOverdraw looks along: the axes, then the cube diagonals
+	const XMFLOAT3 OverdrawDirections[MeshOptimizer::DefaultOverdrawDirections] =
+	{
+		{ 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 },
+		{ 1, 1, 1 }, { 1, 1, -1 }, { 1, -1, 1 }, { 1, -1, -1 }, { -1, 1, 1 }, { -1, 1, -1 }, { -1, -1, 1 }, { -1, -1, -1 },
+	};
+
+	//A FIFO vertex cache, the same model as AnalyzeVertexCache uses. Reset() empties it without clearing every vertex's time
+	struct CacheSimulator
+	{
+		std::vector<unsigned int> Entered;
+		unsigned int Time;
+		unsigned int Size;
+
+		CacheSimulator(size_t vertexCount, unsigned int size) : Entered(vertexCount, 0), Time(size + 1), Size(size) {}
+
+		unsigned int Misses(const unsigned int* triangle)
+		{
+			unsigned int misses = 0;
+			for (int k = 0; k < 3; k++)
+			{
+				if (Time - Entered[triangle[k]] > Size)
+				{
+					Entered[triangle[k]] = Time++;
+					misses++;
+				}
+			}
+			return misses;
+		}
+
+		void Reset()
+		{
+			Time += Size + 1;
+		}
+	};
+
+	XMVECTOR TriangleCross(const std::vector<SimpleVertex>& vertices, const unsigned int* triangle)
+	{
+		XMVECTOR a = XMLoadFloat3(&vertices[triangle[0]].Pos);
+		XMVECTOR b = XMLoadFloat3(&vertices[triangle[1]].Pos);
+		XMVECTOR c = XMLoadFloat3(&vertices[triangle[2]].Pos);
+		return XMVector3Cross(XMVectorSubtract(b, a), XMVectorSubtract(c, a));
+	}
+
+	XMVECTOR TriangleCentre(const std::vector<SimpleVertex>& vertices, const unsigned int* triangle)
+	{
+		XMVECTOR a = XMLoadFloat3(&vertices[triangle[0]].Pos);
+		XMVECTOR b = XMLoadFloat3(&vertices[triangle[1]].Pos);
+		XMVECTOR c = XMLoadFloat3(&vertices[triangle[2]].Pos);
+		return XMVectorScale(XMVectorAdd(XMVectorAdd(a, b), c), 1.0f / 3.0f);
+	}
+
+	float ScoreVertex(int cachePosition, unsigned int remainingTriangles)
+	{
+		//Nothing left to draw with this vertex, so it shouldn't attract any triangles
+		if (remainingTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				//Used by the triangle that was just drawn. Scored a little lower so the next triangle doesn't just reuse the same edge and strip along
+				score = LastTriangleScore;
+			}
+			else
+			{
+				//Decays towards 0 as it gets closer to falling out of the cache
+				const float scaler = 1.0f / (MeshOptimizer::OptimizeCacheSize - 3);
+				score = powf(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+			}
+		}
+
+		//Boost vertices with few triangles left, so they get finished off rather than leaving lone triangles to pick up later
+		score += ValenceBoostScale * powf((float)remainingTriangles, -ValenceBoostPower);
+		return score;
+	}
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	//Build each vertex's list of triangles. The first remaining[v] entries of a list are the triangles that haven't been emitted yet
+	std::vector<unsigned int> remaining(vertexCount, 0);
+	for (unsigned int index : indices)
+	{
+		remaining[index]++;
+	}
+
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		vertexScores[v] = ScoreVertex(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	unsigned int bestTriangle = 0;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+		if (triangleScores[t] > triangleScores[bestTriangle])
+		{
+			bestTriangle = (unsigned int)t;
+		}
+	}
+
+	//The modelled LRU cache, most recently used first. It has room for a whole triangle more while it's being updated
+	unsigned int cache[OptimizeCacheSize + 3];
+	size_t cacheCount = 0;
+
+	std::vector<unsigned int> result;
+	result.reserve(triangleCount * 3);
+	size_t nextUnemitted = 0;
+
+	while (result.size() < triangleCount * 3)
+	{
+		//None of the triangles around the cache are left, so carry on from the next one in the original order
+		if (bestTriangle == NoTriangle)
+		{
+			while (emitted[nextUnemitted])
+			{
+				nextUnemitted++;
+			}
+			bestTriangle = (unsigned int)nextUnemitted;
+		}
+
+		const unsigned int* triangle = &indices[bestTriangle * 3];
+		emitted[bestTriangle] = true;
+		result.insert(result.end(), triangle, triangle + 3);
+
+		//Take the triangle off each of its vertices' lists
+		for (int k = 0; k < 3; k++)
+		{
+			unsigned int* triangles = &adjacency[offsets[triangle[k]]];
+			unsigned int& count = remaining[triangle[k]];
+			for (unsigned int i = 0; i < count; i++)
+			{
+				if (triangles[i] == bestTriangle)
+				{
+					triangles[i] = triangles[count - 1];
+					count--;
+					break;
+				}
+			}
+		}
+
+		//Move the triangle's vertices to the front of the cache, pushing the rest back
+		unsigned int newCache[OptimizeCacheSize + 3];
+		size_t newCount = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			if (newCount == 0 || (newCache[0] != triangle[k] && (newCount == 1 || newCache[1] != triangle[k])))
+			{
+				newCache[newCount++] = triangle[k];
+			}
+		}
+		for (size_t i = 0; i < cacheCount; i++)
+		{
+			unsigned int v = cache[i];
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+			{
+				newCache[newCount++] = v;
+			}
+		}
+
+		//Rescore everything that moved, including the vertices that just fell out, and pass the change on to their triangles
+		for (size_t i = 0; i < newCount; i++)
+		{
+			unsigned int v = newCache[i];
+			cachePosition[v] = i < OptimizeCacheSize ? (int)i : -1;
+
+			float score = ScoreVertex(cachePosition[v], remaining[v]);
+			float change = score - vertexScores[v];
+			vertexScores[v] = score;
+
+			const unsigned int* triangles = &adjacency[offsets[v]];
+			for (unsigned int j = 0; j < remaining[v]; j++)
+			{
+				triangleScores[triangles[j]] += change;
+			}
+		}
+
+		cacheCount = newCount < OptimizeCacheSize ? newCount : OptimizeCacheSize;
+		for (size_t i = 0; i < cacheCount; i++)
+		{
+			cache[i] = newCache[i];
+		}
+
+		//The best next triangle almost always uses a cached vertex, so only those are searched
+		bestTriangle = NoTriangle;
+		float bestScore = -1.0f;
+		for (size_t i = 0; i < cacheCount; i++)
+		{
+			unsigned int v = cache[i];
+			const unsigned int* triangles = &adjacency[offsets[v]];
+			for (unsigned int j = 0; j < remaining[v]; j++)
+			{
+				if (triangleScores[triangles[j]] > bestScore)
+				{
+					bestScore = triangleScores[triangles[j]];
+					bestTriangle = triangles[j];
+				}
+			}
+		}
+	}
+
+	indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(const std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices, float threshold)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	//Hard boundaries: triangles that miss the cache on all 3 vertices start a new patch of the mesh, so splitting there costs nothing
+	CacheSimulator cache(vertices.size(), SimulatedCacheSize);
+	std::vector<size_t> hardBoundaries;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		if (cache.Misses(&indices[t * 3]) == 3)
+		{
+			hardBoundaries.push_back(t);
+		}
+	}
+	hardBoundaries.push_back(triangleCount);
+
+	//Soft boundaries: within each patch, split wherever the ACMR so far has dropped to within threshold of the whole patch's.
+	//The cache is emptied at each split, as it would be when the clusters are drawn apart, so the cost of splitting is counted
+	std::vector<size_t> clusters;
+	for (size_t h = 0; h + 1 < hardBoundaries.size(); h++)
+	{
+		size_t start = hardBoundaries[h];
+		size_t end = hardBoundaries[h + 1];
+
+		cache.Reset();
+		unsigned int patchMisses = 0;
+		for (size_t t = start; t < end; t++)
+		{
+			patchMisses += cache.Misses(&indices[t * 3]);
+		}
+		float clusterThreshold = threshold * patchMisses / (end - start);
+
+		cache.Reset();
+		clusters.push_back(start);
+		size_t clusterStart = start;
+		unsigned int clusterMisses = 0;
+		for (size_t t = start; t < end; t++)
+		{
+			clusterMisses += cache.Misses(&indices[t * 3]);
+			if (t + 1 < end && (float)clusterMisses / (t + 1 - clusterStart) <= clusterThreshold)
+			{
+				clusterStart = t + 1;
+				clusters.push_back(clusterStart);
+				clusterMisses = 0;
+				cache.Reset();
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+	std::vector<size_t> order = SortClustersByOcclusion(vertices, indices, clusters);
+
+	std::vector<unsigned int> result;
+	result.reserve(triangleCount * 3);
+	for (size_t c : order)
+	{
+		result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+	}
+	indices.swap(result);
+}
+
+std::vector<size_t> MeshOptimizer::SortClustersByOcclusion(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<size_t>& clusters)
+{
+	size_t triangleCount = indices.size() / 3;
+	size_t clusterCount = clusters.size() - 1;
+
+	//The area weighted centre of the whole mesh
+	XMVECTOR meshCentre = XMVectorZero();
+	float meshArea = 0.0f;
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		float area = XMVectorGetX(XMVector3Length(TriangleCross(vertices, &indices[t * 3])));
+		meshCentre = XMVectorAdd(meshCentre, XMVectorScale(TriangleCentre(vertices, &indices[t * 3]), area));
+		meshArea += area;
+	}
+	if (meshArea > 0.0f)
+	{
+		meshCentre = XMVectorScale(meshCentre, 1.0f / meshArea);
+	}
+
+	//Occlusion potential: how far out from the centre a cluster faces. Clusters on the outside facing away from the middle are the
+	//ones most likely to hide the rest of the mesh, so they're drawn first
+	std::vector<float> potential(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		XMVECTOR centre = XMVectorZero();
+		XMVECTOR normal = XMVectorZero();
+		float area = 0.0f;
+		for (size_t t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			//The cross product's length is twice the triangle's area, so summing them weights each normal by its area
+			XMVECTOR cross = TriangleCross(vertices, &indices[t * 3]);
+			float triangleArea = XMVectorGetX(XMVector3Length(cross));
+			centre = XMVectorAdd(centre, XMVectorScale(TriangleCentre(vertices, &indices[t * 3]), triangleArea));
+			normal = XMVectorAdd(normal, cross);
+			area += triangleArea;
+		}
+
+		if (area > 0.0f)
+		{
+			centre = XMVectorScale(centre, 1.0f / area);
+		}
+		normal = XMVector3Normalize(normal);
+		potential[c] = XMVectorGetX(XMVector3Dot(XMVectorSubtract(centre, meshCentre), normal));
+	}
+
+	std::vector<size_t> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++)
+	{
+		order[c] = c;
+	}
+	std::stable_sort(order.begin(), order.end(), [&potential](size_t a, size_t b) { return potential[a] > potential[b]; });
+	return order;
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices)
+{
+	const unsigned int Unused = 0xFFFFFFFF;
+	std::vector<unsigned int> remap(vertices.size(), Unused);
+	std::vector<SimpleVertex> reordered;
+	reordered.reserve(vertices.size());
+
+	for (unsigned int& index : indices)
+	{
+		if (remap[index] == Unused)
+		{
+			remap[index] = (unsigned int)reordered.size();
+			reordered.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	vertices.swap(reordered);
+}
+
+VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize)
+{
+	VertexCacheStatistics statistics = {};
+	if (indices.size() < 3)
+	{
+		return statistics;
+	}
+
+	//Each vertex remembers when it entered the FIFO. It's still cached if fewer than cacheSize other vertices have entered since
+	std::vector<unsigned int> entered(vertexCount, 0);
+	std::vector<bool> used(vertexCount, false);
+	unsigned int time = cacheSize + 1;
+	size_t misses = 0;
+	size_t usedVertices = 0;
+
+	for (unsigned int index : indices)
+	{
+		if (time - entered[index] > cacheSize)
+		{
+			entered[index] = time++;
+			misses++;
+		}
+		if (!used[index])
+		{
+			used[index] = true;
+			usedVertices++;
+		}
+	}
+
+	statistics.ACMR = (float)misses / (indices.size() / 3);
+	statistics.ATVR = (float)misses / usedVertices;
+	return statistics;
+}
+
+float MeshOptimizer::AnalyzeOverdraw(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, unsigned int directionCount, unsigned int resolution)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0 || resolution == 0)
+	{
+		return 0.0f;
+	}
+	if (directionCount > DefaultOverdrawDirections)
+	{
+		directionCount = DefaultOverdrawDirections;
+	}
+
+	std::vector<float> depth((size_t)resolution * resolution);
+	std::vector<XMFLOAT3> projected(vertices.size());
+	float totalOverdraw = 0.0f;
+
+	for (unsigned int d = 0; d < directionCount; d++)
+	{
+		//Build an orthographic view looking along the direction
+		XMVECTOR forward = XMVector3Normalize(XMLoadFloat3(&OverdrawDirections[d]));
+		XMVECTOR up = fabsf(XMVectorGetY(forward)) > 0.99f ? XMVectorSet(0, 0, 1, 0) : XMVectorSet(0, 1, 0, 0);
+		XMVECTOR right = XMVector3Normalize(XMVector3Cross(up, forward));
+		up = XMVector3Cross(forward, right);
+
+		XMFLOAT3 minimum(FLT_MAX, FLT_MAX, FLT_MAX);
+		XMFLOAT3 maximum(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for (size_t v = 0; v < vertices.size(); v++)
+		{
+			XMVECTOR position = XMLoadFloat3(&vertices[v].Pos);
+			XMFLOAT3& p = projected[v];
+			p.x = XMVectorGetX(XMVector3Dot(position, right));
+			p.y = XMVectorGetX(XMVector3Dot(position, up));
+			p.z = XMVectorGetX(XMVector3Dot(position, forward));
+			minimum.x = std::min(minimum.x, p.x); maximum.x = std::max(maximum.x, p.x);
+			minimum.y = std::min(minimum.y, p.y); maximum.y = std::max(maximum.y, p.y);
+		}
+
+		//Fit the mesh into the view, keeping its aspect ratio
+		float extent = std::max(maximum.x - minimum.x, maximum.y - minimum.y);
+		float scale = extent > 0.0f ? resolution / extent : 0.0f;
+		for (XMFLOAT3& p : projected)
+		{
+			p.x = (p.x - minimum.x) * scale;
+			p.y = (p.y - minimum.y) * scale;
+		}
+
+		std::fill(depth.begin(), depth.end(), FLT_MAX);
+		size_t shaded = 0;
+
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			const XMFLOAT3& a = projected[indices[t * 3]];
+			XMFLOAT3 b = projected[indices[t * 3 + 1]];
+			XMFLOAT3 c = projected[indices[t * 3 + 2]];
+
+			//Make every triangle wind the same way, as both sides get drawn
+			float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+			if (area == 0.0f)
+			{
+				continue;
+			}
+			if (area < 0.0f)
+			{
+				std::swap(b, c);
+				area = -area;
+			}
+
+			int minX = std::max(0, (int)floorf(std::min({ a.x, b.x, c.x })));
+			int maxX = std::min((int)resolution - 1, (int)ceilf(std::max({ a.x, b.x, c.x })));
+			int minY = std::max(0, (int)floorf(std::min({ a.y, b.y, c.y })));
+			int maxY = std::min((int)resolution - 1, (int)ceilf(std::max({ a.y, b.y, c.y })));
+
+			for (int y = minY; y <= maxY; y++)
+			{
+				for (int x = minX; x <= maxX; x++)
+				{
+					//Sample at the pixel centre using edge functions, which are the barycentric weights scaled by the area
+					float px = x + 0.5f;
+					float py = y + 0.5f;
+					float wa = (b.x - px) * (c.y - py) - (b.y - py) * (c.x - px);
+					float wb = (c.x - px) * (a.y - py) - (c.y - py) * (a.x - px);
+					float wc = (a.x - px) * (b.y - py) - (a.y - py) * (b.x - px);
+					if (wa < 0.0f || wb < 0.0f || wc < 0.0f)
+					{
+						continue;
+					}
+
+					float z = (wa * a.z + wb * b.z + wc * c.z) / area;
+					float& stored = depth[(size_t)y * resolution + x];
+					if (z < stored)
+					{
+						stored = z;
+						shaded++;
+					}
+				}
+			}
+		}
+
+		size_t covered = 0;
+		for (float z : depth)
+		{
+			if (z != FLT_MAX) covered++;
+		}
+		totalOverdraw += covered > 0 ? (float)shaded / covered : 0.0f;
+	}
+
+	return totalOverdraw / directionCount;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+
+#include "Vertices.h"
+
+/// <summary>How well an index buffer uses the GPU's post-transform vertex cache, as measured by MeshOptimizer::AnalyzeVertexCache</summary>
+struct VertexCacheStatistics
+{
+	/// <summary>Vertices transformed per triangle (average cache miss ratio). 3 is the worst possible, 0.5 is about the best for a regular grid</summary>
+	float ACMR;
+	/// <summary>Vertices transformed per vertex in the mesh (average transform to vertex ratio). 1 means every vertex is only transformed once</summary>
+	float ATVR;
+};
+
+/// <summary>Reorders meshes at import time so they render faster. Everything here works on plain index and vertex arrays, with no GPU involved</summary>
+namespace MeshOptimizer
+{
+	/// <summary>The size of the LRU cache OptimizeVertexCache models</summary>
+	const unsigned int OptimizeCacheSize = 32;
+	/// <summary>How much worse OptimizeOverdraw may make the ACMR of each cluster by default, 1.05 being 5% worse</summary>
+	const float DefaultOverdrawThreshold = 1.05f;
+	/// <summary>How many of the canonical view directions AnalyzeOverdraw renders from by default: the 6 axes and the 8 cube diagonals</summary>
+	const unsigned int DefaultOverdrawDirections = 14;
+	/// <summary>The size of the FIFO cache AnalyzeVertexCache simulates, roughly what current GPUs reuse across</summary>
+	const unsigned int SimulatedCacheSize = 16;
+
+	/// <summary><para>Reorders triangles so vertices that were transformed recently are reused before they leave the post-transform cache. </para>
+	/// <para>This is Tom Forsyth's "Linear-Speed Vertex Cache Optimisation": each vertex is scored by its position in a modelled LRU cache and by how
+	/// many triangles still use it, and the triangle with the highest total score is emitted next.</para></summary>
+	/// <param name="indices">A triangle list, reordered in place</param>
+	/// <param name="vertexCount">One more than the highest index</param>
+	void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+	/// <summary><para>Reorders clusters of triangles so the outside of a mesh tends to be drawn before the inside, letting the depth test reject
+	/// hidden pixels before they're shaded, whichever way the mesh is viewed. </para>
+	/// <para>This is the view-independent pass from Sander, Nehab and Barczak's "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw".
+	/// The triangles are split into clusters wherever the vertex cache starts afresh, and again wherever splitting keeps each cluster's ACMR
+	/// within threshold of what it was. Clusters are then sorted by how far out from the mesh's centre they face.</para>
+	/// <para>Run this after OptimizeVertexCache, as it keeps the order of the triangles within each cluster.</para></summary>
+	/// <param name="indices">A triangle list, reordered in place</param>
+	/// <param name="threshold">How much the ACMR is allowed to rise. 1 only splits where it costs nothing, higher values give the sort more freedom</param>
+	void OptimizeOverdraw(const std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices, float threshold = DefaultOverdrawThreshold);
+
+	/// <summary>Orders clusters of triangles by how far out from the mesh's centre they face, which is the sort OptimizeOverdraw uses</summary>
+	/// <param name="clusters">The first triangle of each cluster, then one past the last triangle of the last cluster</param>
+	/// <returns>The index of each cluster, in the order they should be drawn</returns>
+	std::vector<size_t> SortClustersByOcclusion(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<size_t>& clusters);
+
+	/// <summary>Renumbers vertices in the order the index buffer first uses them, so vertex fetch walks memory forwards. Vertices no triangle uses are removed</summary>
+	void OptimizeVertexFetch(std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices);
+
+	/// <summary>Runs an index buffer through a simulated FIFO post-transform cache and counts how many vertices would be transformed</summary>
+	/// <param name="cacheSize">How many vertices the simulated cache holds</param>
+	VertexCacheStatistics AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize = SimulatedCacheSize);
+
+	/// <summary><para>Rasterizes a mesh with a depth buffer from several fixed directions, in index buffer order, and measures the overdraw. </para>
+	/// <para>Overdraw is the number of pixels that pass the depth test, so would be shaded, divided by the number of pixels the mesh covers.
+	/// Like the renderer, nothing is back-face culled.</para></summary>
+	/// <param name="directionCount">How many of the canonical directions to render from, up to DefaultOverdrawDirections</param>
+	/// <param name="resolution">The width and height of the orthographic views, in pixels</param>
+	/// <returns>The overdraw averaged over every direction. 1 means no pixel was shaded twice</returns>
+	float AnalyzeOverdraw(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, unsigned int directionCount = DefaultOverdrawDirections, unsigned int resolution = 256);
+};
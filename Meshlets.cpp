@@ -0,0 +1,501 @@
+#include "Meshlets.h"
+#include "Bounds.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	const unsigned int NoMeshlet = 0xFFFFFFFF;
+	const unsigned int NoTriangle = 0xFFFFFFFF;
+
+	//Cones wider than this (about 84 degrees from the axis) would almost never be culled, so aren't worth testing
+	const float MinConeCosine = 0.1f;
+
+	//The unit normal of a triangle, facing the same way as its vertex normals. Nothing is back-face culled, so the winding of a triangle
+	//doesn't decide which side is its front, the normals it's lit with do. Zero for a triangle with no area
+	XMVECTOR FaceNormal(const std::vector<SimpleVertex>& vertices, const unsigned int* triangle)
+	{
+		XMVECTOR a = XMLoadFloat3(&vertices[triangle[0]].Pos);
+		XMVECTOR b = XMLoadFloat3(&vertices[triangle[1]].Pos);
+		XMVECTOR c = XMLoadFloat3(&vertices[triangle[2]].Pos);
+		XMVECTOR normal = XMVector3Cross(XMVectorSubtract(b, a), XMVectorSubtract(c, a));
+		if (XMVectorGetX(XMVector3LengthSq(normal)) <= FLT_MIN)
+		{
+			return XMVectorZero();
+		}
+
+		XMVECTOR vertexNormals = XMVectorAdd(XMVectorAdd(XMLoadFloat3(&vertices[triangle[0]].Normal), XMLoadFloat3(&vertices[triangle[1]].Normal)),
+			XMLoadFloat3(&vertices[triangle[2]].Normal));
+		if (XMVectorGetX(XMVector3Dot(normal, vertexNormals)) < 0.0f)
+		{
+			normal = XMVectorScale(normal, -1.0f);
+		}
+		return XMVector3Normalize(normal);
+	}
+
+	//A k-d tree of triangle centres, for finding the nearest triangle not yet in a meshlet when a meshlet has no neighbours left to grow into.
+	//Each node counts how many of its triangles are left, so whole branches that have been used up are skipped
+	class CentreTree
+	{
+	public:
+		CentreTree(const std::vector<XMFLOAT3>& centres) : m_centres(centres), m_order(centres.size()), m_leafOf(centres.size())
+		{
+			for (size_t t = 0; t < centres.size(); t++)
+			{
+				m_order[t] = (unsigned int)t;
+			}
+			Build(NoNode, 0, (unsigned int)centres.size());
+		}
+
+		void Remove(unsigned int triangle)
+		{
+			for (unsigned int node = m_leafOf[triangle]; node != NoNode; node = m_nodes[node].Parent)
+			{
+				m_nodes[node].Remaining--;
+			}
+		}
+
+		//NoTriangle if every triangle has been removed
+		unsigned int FindNearest(const XMFLOAT3& point, const std::vector<bool>& emitted) const
+		{
+			unsigned int nearest = NoTriangle;
+			float nearestDistance = FLT_MAX;
+			Search(0, &point.x, emitted, nearest, nearestDistance);
+			return nearest;
+		}
+
+	private:
+		static const unsigned int NoNode = 0xFFFFFFFF;
+		static const unsigned int LeafSize = 8;
+
+		struct Node
+		{
+			unsigned int Parent;
+			unsigned int Left;
+			unsigned int Right;
+			unsigned int Start;
+			unsigned int Count;
+			unsigned int Remaining;
+			//-1 for a leaf
+			int Axis;
+			float Split;
+		};
+
+		const std::vector<XMFLOAT3>& m_centres;
+		std::vector<unsigned int> m_order;
+		std::vector<unsigned int> m_leafOf;
+		std::vector<Node> m_nodes;
+
+		float Coordinate(unsigned int triangle, int axis) const
+		{
+			return (&m_centres[triangle].x)[axis];
+		}
+
+		unsigned int Build(unsigned int parent, unsigned int start, unsigned int count)
+		{
+			unsigned int node = (unsigned int)m_nodes.size();
+			m_nodes.push_back({ parent, NoNode, NoNode, start, count, count, -1, 0.0f });
+			if (count <= LeafSize)
+			{
+				for (unsigned int i = start; i < start + count; i++)
+				{
+					m_leafOf[m_order[i]] = node;
+				}
+				return node;
+			}
+
+			//Split the widest axis at the median
+			float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+			float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			for (unsigned int i = start; i < start + count; i++)
+			{
+				for (int axis = 0; axis < 3; axis++)
+				{
+					minimum[axis] = std::min(minimum[axis], Coordinate(m_order[i], axis));
+					maximum[axis] = std::max(maximum[axis], Coordinate(m_order[i], axis));
+				}
+			}
+			int axis = 0;
+			for (int a = 1; a < 3; a++)
+			{
+				if (maximum[a] - minimum[a] > maximum[axis] - minimum[axis]) axis = a;
+			}
+
+			unsigned int half = count / 2;
+			std::nth_element(m_order.begin() + start, m_order.begin() + start + half, m_order.begin() + start + count,
+				[this, axis](unsigned int a, unsigned int b) { return Coordinate(a, axis) < Coordinate(b, axis); });
+
+			unsigned int left = Build(node, start, half);
+			unsigned int right = Build(node, start + half, count - half);
+			m_nodes[node].Left = left;
+			m_nodes[node].Right = right;
+			m_nodes[node].Axis = axis;
+			m_nodes[node].Split = Coordinate(m_order[start + half], axis);
+			return node;
+		}
+
+		void Search(unsigned int index, const float* point, const std::vector<bool>& emitted, unsigned int& nearest, float& nearestDistance) const
+		{
+			const Node& node = m_nodes[index];
+			if (node.Remaining == 0)
+			{
+				return;
+			}
+
+			if (node.Axis < 0)
+			{
+				for (unsigned int i = node.Start; i < node.Start + node.Count; i++)
+				{
+					unsigned int triangle = m_order[i];
+					if (emitted[triangle])
+					{
+						continue;
+					}
+
+					const float* centre = &m_centres[triangle].x;
+					float dx = centre[0] - point[0], dy = centre[1] - point[1], dz = centre[2] - point[2];
+					float distance = dx * dx + dy * dy + dz * dz;
+					if (distance < nearestDistance)
+					{
+						nearest = triangle;
+						nearestDistance = distance;
+					}
+				}
+				return;
+			}
+
+			//Search the side the point is on first, then the other side only if it could be closer than what's been found
+			float offset = point[node.Axis] - node.Split;
+			Search(offset < 0.0f ? node.Left : node.Right, point, emitted, nearest, nearestDistance);
+			if (offset * offset < nearestDistance)
+			{
+				Search(offset < 0.0f ? node.Right : node.Left, point, emitted, nearest, nearestDistance);
+			}
+		}
+	};
+
+	void ComputeBounds(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<XMFLOAT3>& points, Meshlet& meshlet)
+	{
+		XMFLOAT3 center;
+		Bounds::BoundingSphere(points, center, meshlet.Radius);
+		meshlet.Center[0] = center.x;
+		meshlet.Center[1] = center.y;
+		meshlet.Center[2] = center.z;
+
+		//The cone's axis is the average of the triangles' normals, and it's as wide as the furthest of them from it
+		const unsigned int* first = indices.data() + meshlet.IndexStart;
+		unsigned int triangleCount = meshlet.IndexCount / 3;
+		std::vector<XMVECTOR> normals(triangleCount);
+		XMVECTOR axis = XMVectorZero();
+		for (unsigned int t = 0; t < triangleCount; t++)
+		{
+			normals[t] = FaceNormal(vertices, first + t * 3);
+			axis = XMVectorAdd(axis, normals[t]);
+		}
+
+		float smallestCosine = -1.0f;
+		if (XMVectorGetX(XMVector3LengthSq(axis)) > FLT_MIN)
+		{
+			axis = XMVector3Normalize(axis);
+			smallestCosine = 1.0f;
+			for (const XMVECTOR& normal : normals)
+			{
+				//Triangles with no area can't be seen from either side, so they don't widen the cone
+				if (XMVectorGetX(XMVector3LengthSq(normal)) > 0.0f)
+				{
+					smallestCosine = std::min(smallestCosine, XMVectorGetX(XMVector3Dot(axis, normal)));
+				}
+			}
+		}
+
+		XMFLOAT3 coneAxis;
+		XMStoreFloat3(&coneAxis, axis);
+		meshlet.ConeAxis[0] = coneAxis.x;
+		meshlet.ConeAxis[1] = coneAxis.y;
+		meshlet.ConeAxis[2] = coneAxis.z;
+		meshlet.ConeCutoff = smallestCosine > MinConeCosine ? sqrtf(1.0f - smallestCosine * smallestCosine) : 1.0f;
+	}
+}
+
+void Meshlets::Build(const std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices, std::vector<Meshlet>& meshlets, unsigned int maxVertices, unsigned int maxTriangles)
+{
+	meshlets.clear();
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	//The triangles that use each vertex, so a meshlet can find the triangles next to it
+	std::vector<unsigned int> firstTriangle(vertices.size() + 1, 0);
+	for (unsigned int index : indices)
+	{
+		firstTriangle[index + 1]++;
+	}
+	for (size_t v = 0; v < vertices.size(); v++)
+	{
+		firstTriangle[v + 1] += firstTriangle[v];
+	}
+	std::vector<unsigned int> vertexTriangles(indices.size());
+	std::vector<unsigned int> filled(firstTriangle.begin(), firstTriangle.end() - 1);
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		vertexTriangles[filled[indices[i]]++] = (unsigned int)(i / 3);
+	}
+
+	std::vector<XMFLOAT3> centres(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		const unsigned int* triangle = &indices[t * 3];
+		XMVECTOR sum = XMVectorAdd(XMVectorAdd(XMLoadFloat3(&vertices[triangle[0]].Pos), XMLoadFloat3(&vertices[triangle[1]].Pos)), XMLoadFloat3(&vertices[triangle[2]].Pos));
+		XMStoreFloat3(&centres[t], XMVectorScale(sum, 1.0f / 3.0f));
+	}
+
+	//Which meshlet last used each vertex, so counting a meshlet's vertices doesn't need clearing between meshlets
+	std::vector<unsigned int> usedBy(vertices.size(), NoMeshlet);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<unsigned int> meshletVertices;
+	std::vector<unsigned int> meshletTriangles;
+	std::vector<unsigned int> triangleOrder;
+	triangleOrder.reserve(triangleCount);
+	std::vector<size_t> clusters;
+	CentreTree tree(centres);
+
+	//Each meshlet starts from the first triangle left in the order they came in, then grows across shared vertices, taking whichever
+	//neighbour adds the fewest new vertices and, of those, is closest to the middle of the meshlet. That keeps meshlets round and small,
+	//which makes their spheres tight and their normal cones narrow
+	size_t seed = 0;
+	unsigned int id = 0;
+	while (true)
+	{
+		while (seed < triangleCount && emitted[seed])
+		{
+			seed++;
+		}
+		if (seed == triangleCount)
+		{
+			break;
+		}
+
+		meshletVertices.clear();
+		meshletTriangles.clear();
+		XMVECTOR centreSum = XMVectorZero();
+		unsigned int next = (unsigned int)seed;
+		while (next != NoTriangle)
+		{
+			emitted[next] = true;
+			tree.Remove(next);
+			meshletTriangles.push_back(next);
+			centreSum = XMVectorAdd(centreSum, XMLoadFloat3(&centres[next]));
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int vertex = indices[next * 3 + k];
+				if (usedBy[vertex] != id)
+				{
+					usedBy[vertex] = id;
+					meshletVertices.push_back(vertex);
+				}
+			}
+
+			if (meshletTriangles.size() >= maxTriangles)
+			{
+				break;
+			}
+
+			XMVECTOR centre = XMVectorScale(centreSum, 1.0f / meshletTriangles.size());
+			next = NoTriangle;
+			unsigned int fewestNew = 4;
+			float nearest = FLT_MAX;
+			for (unsigned int vertex : meshletVertices)
+			{
+				for (unsigned int i = firstTriangle[vertex]; i < firstTriangle[vertex + 1]; i++)
+				{
+					unsigned int candidate = vertexTriangles[i];
+					if (emitted[candidate])
+					{
+						continue;
+					}
+
+					const unsigned int* triangle = &indices[candidate * 3];
+					unsigned int newVertices = (usedBy[triangle[0]] != id) + (usedBy[triangle[1]] != id && triangle[1] != triangle[0])
+						+ (usedBy[triangle[2]] != id && triangle[2] != triangle[0] && triangle[2] != triangle[1]);
+					if (meshletVertices.size() + newVertices > maxVertices || newVertices > fewestNew)
+					{
+						continue;
+					}
+
+					float distance = XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(XMLoadFloat3(&centres[candidate]), centre)));
+					if (newVertices < fewestNew || distance < nearest)
+					{
+						next = candidate;
+						fewestNew = newVertices;
+						nearest = distance;
+					}
+				}
+			}
+
+			//Nothing connected is left, as happens with meshes made of separate pieces or with every face split apart by its normals.
+			//Carry on with the nearest triangle left anywhere, if its 3 vertices fit
+			if (next == NoTriangle && meshletVertices.size() + 3 <= maxVertices)
+			{
+				XMFLOAT3 point;
+				XMStoreFloat3(&point, centre);
+				next = tree.FindNearest(point, emitted);
+			}
+		}
+
+		clusters.push_back(triangleOrder.size());
+		triangleOrder.insert(triangleOrder.end(), meshletTriangles.begin(), meshletTriangles.end());
+		id++;
+	}
+	clusters.push_back(triangleCount);
+
+	std::vector<unsigned int> grouped(indices.size());
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		memcpy(&grouped[t * 3], &indices[triangleOrder[t] * 3], sizeof(unsigned int) * 3);
+	}
+
+	//Regrouping the triangles undoes OptimizeOverdraw's sort, so sort the meshlets the same way
+	std::vector<size_t> order = MeshOptimizer::SortClustersByOcclusion(vertices, grouped, clusters);
+
+	std::vector<XMFLOAT3> points;
+	points.reserve(maxVertices);
+	std::vector<unsigned int> localIndex(vertices.size());
+	std::vector<unsigned int> localIndices;
+	size_t written = 0;
+	for (size_t c : order)
+	{
+		size_t start = clusters[c] * 3;
+		size_t end = clusters[c + 1] * 3;
+
+		Meshlet meshlet = {};
+		meshlet.IndexStart = (uint32_t)written;
+		meshlet.IndexCount = (uint32_t)(end - start);
+
+		//Regrouping also breaks up the vertex cache order, so optimize each meshlet's triangles again. Its vertices are numbered
+		//from 0 while that's done, so the optimizer only tracks as many vertices as the meshlet uses
+		meshletVertices.clear();
+		points.clear();
+		localIndices.resize(end - start);
+		for (size_t i = start; i < end; i++)
+		{
+			unsigned int vertex = grouped[i];
+			if (usedBy[vertex] != id)
+			{
+				usedBy[vertex] = id;
+				localIndex[vertex] = (unsigned int)meshletVertices.size();
+				meshletVertices.push_back(vertex);
+				points.push_back(vertices[vertex].Pos);
+			}
+			localIndices[i - start] = localIndex[vertex];
+		}
+		id++;
+
+		MeshOptimizer::OptimizeVertexCache(localIndices, meshletVertices.size());
+		for (size_t i = 0; i < localIndices.size(); i++)
+		{
+			indices[written + i] = meshletVertices[localIndices[i]];
+		}
+		written += end - start;
+
+		ComputeBounds(vertices, indices, points, meshlet);
+		meshlets.push_back(meshlet);
+	}
+}
+
+MeshletCullingView Meshlets::CreateCullingView(const XMFLOAT4X4& world, const XMFLOAT4X4& viewProjection, const XMFLOAT3& eye, bool cullBackfaces)
+{
+	MeshletCullingView view;
+	view.CullBackfaces = cullBackfaces;
+
+	//The frustum planes of the whole model to clip space transform are the frustum in model space (Gribb and Hartmann). With row vectors
+	//clip = position * matrix, so each plane is a sum of the matrix's columns
+	XMMATRIX worldMatrix = XMLoadFloat4x4(&world);
+	XMFLOAT4X4 m;
+	XMStoreFloat4x4(&m, XMMatrixMultiply(worldMatrix, XMLoadFloat4x4(&viewProjection)));
+
+	const float sign[6] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+	for (int p = 0; p < 6; p++)
+	{
+		int column = p / 2;
+		//D3D's clip space runs from 0 to w in z, so the near plane is z >= 0 rather than z >= -w
+		float w = p == 4 ? 0.0f : 1.0f;
+		float plane[4];
+		for (int row = 0; row < 4; row++)
+		{
+			plane[row] = w * m.m[row][3] + sign[p] * m.m[row][column];
+		}
+
+		float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+		float scale = length > 0.0f ? 1.0f / length : 0.0f;
+		view.Planes[p] = XMFLOAT4(plane[0] * scale, plane[1] * scale, plane[2] * scale, plane[3] * scale);
+	}
+
+	XMVECTOR determinant;
+	XMStoreFloat3(&view.Eye, XMVector3TransformCoord(XMLoadFloat3(&eye), XMMatrixInverse(&determinant, worldMatrix)));
+	return view;
+}
+
+MeshletCullStatistics Meshlets::Cull(const std::vector<Meshlet>& meshlets, const MeshletCullingView& view, std::vector<MeshletDrawRange>& ranges)
+{
+	return Cull(meshlets.data(), meshlets.size(), view, ranges);
+}
+
+MeshletCullStatistics Meshlets::Cull(const Meshlet* meshlets, size_t meshletCount, const MeshletCullingView& view, std::vector<MeshletDrawRange>& ranges)
+{
+	MeshletCullStatistics statistics = {};
+	statistics.MeshletCount = (unsigned int)meshletCount;
+	ranges.clear();
+
+	for (size_t i = 0; i < meshletCount; i++)
+	{
+		const Meshlet& meshlet = meshlets[i];
+		const float* center = meshlet.Center;
+
+		bool outside = false;
+		for (const XMFLOAT4& plane : view.Planes)
+		{
+			if (plane.x * center[0] + plane.y * center[1] + plane.z * center[2] + plane.w < -meshlet.Radius)
+			{
+				outside = true;
+				break;
+			}
+		}
+		if (outside)
+		{
+			statistics.FrustumCulled++;
+			continue;
+		}
+
+		//Every triangle faces away if the camera is behind all their planes. For every point in the sphere to be seen from within
+		//acos(ConeCutoff) of the axis, the direction to the centre has to be that much closer again
+		if (view.CullBackfaces && meshlet.ConeCutoff < 1.0f)
+		{
+			float toCenter[3] = { center[0] - view.Eye.x, center[1] - view.Eye.y, center[2] - view.Eye.z };
+			float distance = sqrtf(toCenter[0] * toCenter[0] + toCenter[1] * toCenter[1] + toCenter[2] * toCenter[2]);
+			const float* axis = meshlet.ConeAxis;
+			if (toCenter[0] * axis[0] + toCenter[1] * axis[1] + toCenter[2] * axis[2] >= meshlet.ConeCutoff * distance + meshlet.Radius)
+			{
+				statistics.BackfaceCulled++;
+				continue;
+			}
+		}
+
+		//Meshlets are in index buffer order, so a visible one straight after another extends its range
+		if (!ranges.empty() && ranges.back().IndexStart + ranges.back().IndexCount == meshlet.IndexStart)
+		{
+			ranges.back().IndexCount += meshlet.IndexCount;
+		}
+		else
+		{
+			ranges.push_back({ meshlet.IndexStart, meshlet.IndexCount });
+		}
+	}
+
+	statistics.DrawRanges = (unsigned int)ranges.size();
+	return statistics;
+}
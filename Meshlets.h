@@ -0,0 +1,90 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+#include "Vertices.h"
+
+using namespace DirectX;
+
+/// <summary><para>A cluster of up to Meshlets::MaxVertices vertices and Meshlets::MaxTriangles triangles that is a contiguous range of its mesh's
+/// index buffer, so it can be drawn on its own with DrawIndexed. </para>
+/// <para>Meshlets are stored in binary meshes as they are, so every field is fixed width.</para></summary>
+struct Meshlet
+{
+	/// <summary>The first index of the meshlet's triangles in the index buffer</summary>
+	uint32_t IndexStart;
+	uint32_t IndexCount;
+	/// <summary>The centre of a sphere around every vertex in the meshlet, in model space</summary>
+	float Center[3];
+	float Radius;
+	/// <summary>The average direction the meshlet's triangles face, in model space</summary>
+	float ConeAxis[3];
+	/// <summary><para>The sine of the widest angle between ConeAxis and any of the triangles' normals. </para>
+	/// <para>Every triangle faces away from a camera looking at the sphere from within acos(ConeCutoff) of ConeAxis.
+	/// 1 when the triangles face too many ways for there to be such a camera.</para></summary>
+	float ConeCutoff;
+};
+
+/// <summary>What Meshlets::Cull needs to know about the camera, in the model space of the actor being drawn</summary>
+struct MeshletCullingView
+{
+	/// <summary>The left, right, bottom, top, near and far planes of the view frustum, normalized and facing inwards</summary>
+	XMFLOAT4 Planes[6];
+	/// <summary>The camera's position</summary>
+	XMFLOAT3 Eye;
+	/// <summary>Whether meshlets that face away from the camera are culled. Nothing is back-face culled, so this is only safe for closed meshes</summary>
+	bool CullBackfaces;
+};
+
+/// <summary>A range of the index buffer to draw, made of one or more visible meshlets that are next to each other</summary>
+struct MeshletDrawRange
+{
+	uint32_t IndexStart;
+	uint32_t IndexCount;
+};
+
+/// <summary>What Meshlets::Cull did with a mesh's meshlets</summary>
+struct MeshletCullStatistics
+{
+	unsigned int MeshletCount;
+	/// <summary>Meshlets whose bounding sphere is outside the view frustum</summary>
+	unsigned int FrustumCulled;
+	/// <summary>Meshlets inside the frustum that face away from the camera</summary>
+	unsigned int BackfaceCulled;
+	/// <summary>How many DrawIndexed calls the visible meshlets were merged into</summary>
+	unsigned int DrawRanges;
+};
+
+/// <summary><para>Splits meshes into small clusters of triangles at import time, and culls them against the camera each frame,
+/// so only the parts of a large mesh that can be seen are drawn.</para></summary>
+namespace Meshlets
+{
+	/// <summary>The most vertices one meshlet uses</summary>
+	const unsigned int MaxVertices = 64;
+	/// <summary>The most triangles one meshlet holds</summary>
+	const unsigned int MaxTriangles = 124;
+
+	/// <summary><para>Splits a triangle list into meshlets, reordering it so each meshlet is a contiguous range. </para>
+	/// <para>Each meshlet is grown across shared vertices from the first triangle not yet in one, so run this after MeshOptimizer to seed meshlets
+	/// in its order. The triangles within each meshlet are then reordered for the vertex cache, and the meshlets are sorted to reduce overdraw
+	/// the way OptimizeOverdraw sorts clusters.</para></summary>
+	/// <param name="indices">A triangle list, reordered in place</param>
+	/// <param name="meshlets">Replaced with meshlets that cover every triangle, in index buffer order</param>
+	void Build(const std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices, std::vector<Meshlet>& meshlets,
+		unsigned int maxVertices = MaxVertices, unsigned int maxTriangles = MaxTriangles);
+
+	/// <summary>Puts the camera into an actor's model space, so its meshlets can be culled without being transformed</summary>
+	/// <param name="world">The actor's world matrix</param>
+	/// <param name="viewProjection">The camera's view matrix multiplied by its projection matrix</param>
+	/// <param name="eye">The camera's position in world space</param>
+	/// <param name="cullBackfaces">Whether to cull meshlets that face away from the camera, see MeshletCullingView::CullBackfaces</param>
+	MeshletCullingView CreateCullingView(const XMFLOAT4X4& world, const XMFLOAT4X4& viewProjection, const XMFLOAT3& eye, bool cullBackfaces);
+
+	/// <summary>Finds the meshlets that can be seen, and merges the ones that are next to each other in the index buffer into ranges to draw</summary>
+	/// <param name="ranges">Replaced with the ranges to draw, in index buffer order</param>
+	MeshletCullStatistics Cull(const std::vector<Meshlet>& meshlets, const MeshletCullingView& view, std::vector<MeshletDrawRange>& ranges);
+
+	/// <summary>Culls a range of a mesh's meshlets, such as one submesh's</summary>
+	MeshletCullStatistics Cull(const Meshlet* meshlets, size_t meshletCount, const MeshletCullingView& view, std::vector<MeshletDrawRange>& ranges);
+};
@@ -0,0 +1,237 @@
+#include "MipStreamer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+MipStreamer::MipStreamer(uint64_t memoryBudget, size_t tailSize)
+{
+	m_memoryBudget = memoryBudget;
+	m_tailSize = tailSize;
+	memset(&m_stats, 0, sizeof(m_stats));
+	memset(&m_frame, 0, sizeof(m_frame));
+}
+
+uint32_t MipStreamer::GetTailMip(const DDSTextureInfo& info, size_t tailSize)
+{
+	//DDSTextureLoader fails a texture if every mip is bigger than its maxsize, so the last mip stands in for the tail then
+	return std::min<uint32_t>(DDSProbe::GetFirstMip(info, tailSize), info.MipCount - 1);
+}
+
+uint32_t MipStreamer::GetRequiredMip(const DDSTextureInfo& info, float texCoordDensity, float distance, float pixelScale)
+{
+	if (texCoordDensity <= 0.0f || pixelScale <= 0.0f)
+	{
+		return info.MipCount - 1;
+	}
+
+	//How many texels of the first mip fall on each pixel. Rounding the mip down keeps at least one texel a pixel
+	float size = sqrtf((float)info.Width * (float)info.Height);
+	float texelsPerPixel = texCoordDensity * size * std::max<float>(distance, 0.0f) / pixelScale;
+	if (!(texelsPerPixel > 1.0f))
+	{
+		return 0;
+	}
+	float mip = floorf(log2f(texelsPerPixel));
+	return mip >= (float)(info.MipCount - 1) ? info.MipCount - 1 : (uint32_t)mip;
+}
+
+uint32_t MipStreamer::Add(const DDSTextureInfo& info)
+{
+	StreamedTexture texture;
+	texture.Info = info;
+	texture.TailMip = GetTailMip(info, m_tailSize);
+	texture.ResidentMip = texture.TailMip;
+	texture.RequiredMip = texture.TailMip;
+	texture.TargetMip = texture.TailMip;
+	texture.LastUsedFrame = m_stats.Frames + 1;
+	m_textures.push_back(texture);
+
+	uint64_t bytes = DDSProbe::GetBytes(info, texture.TailMip);
+	m_stats.TailBytes += bytes;
+	m_stats.ResidentBytes += bytes;
+	m_stats.PeakResidentBytes = std::max<uint64_t>(m_stats.PeakResidentBytes, m_stats.ResidentBytes);
+	return (uint32_t)(m_textures.size() - 1);
+}
+
+void MipStreamer::Require(uint32_t index, uint32_t mip)
+{
+	//Asked for between two Updates, so in the frame the next one plans for
+	StreamedTexture& texture = m_textures[index];
+	texture.RequiredMip = std::min<uint32_t>(texture.RequiredMip, mip);
+	texture.LastUsedFrame = m_stats.Frames + 1;
+}
+
+bool MipStreamer::Update(uint64_t uploadBudget, std::vector<MipChange>& changes)
+{
+	m_stats.Frames++;
+	memset(&m_frame, 0, sizeof(m_frame));
+	m_frame.Frame = m_stats.Frames;
+
+	//Plan for every texture to keep what it has, and for those drawn this frame to add what they've been asked for, which is at least the
+	//tail of one evicted
+	uint64_t targetBytes = 0;
+	uint64_t requiredBytes = 0;
+	for (StreamedTexture& texture : m_textures)
+	{
+		bool used = texture.LastUsedFrame == m_stats.Frames;
+		texture.TargetMip = used ? std::min<uint32_t>(texture.RequiredMip, texture.ResidentMip) : texture.ResidentMip;
+		targetBytes += DDSProbe::GetBytes(texture.Info, texture.TargetMip);
+		requiredBytes += used ? DDSProbe::GetBytes(texture.Info, texture.RequiredMip) : 0;
+		m_frame.Stalls += used && texture.ResidentMip >= texture.Info.MipCount ? 1 : 0;
+	}
+	m_stats.RequiredBytes = requiredBytes;
+	m_stats.Stalls += m_frame.Stalls;
+
+	//Then give up mips until it fits: the least recently drawn textures' first, down to nothing for those not drawn this frame. Among those
+	//drawn as recently, the mips no longer asked for, then the biggest mip, then the last added
+	while (targetBytes > m_memoryBudget)
+	{
+		size_t victim = m_textures.size();
+		uint32_t victimLastUsed = 0;
+		bool victimUnneeded = false;
+		uint64_t victimBytes = 0;
+		for (size_t i = 0; i < m_textures.size(); i++)
+		{
+			const StreamedTexture& texture = m_textures[i];
+			bool used = texture.LastUsedFrame == m_stats.Frames;
+			if (texture.TargetMip >= (used ? texture.TailMip : texture.Info.MipCount))
+			{
+				continue;
+			}
+
+			//Below the tail it's a mip at a time, and the tail goes all at once
+			bool unneeded = texture.TargetMip < texture.RequiredMip;
+			uint64_t bytes = texture.TargetMip < texture.TailMip ? texture.Info.MipBytes[texture.TargetMip] * texture.Info.ArraySize
+				: DDSProbe::GetBytes(texture.Info, texture.TargetMip);
+			if (victim == m_textures.size() || texture.LastUsedFrame < victimLastUsed || (texture.LastUsedFrame == victimLastUsed
+				&& (unneeded > victimUnneeded || (unneeded == victimUnneeded && bytes >= victimBytes))))
+			{
+				victim = i;
+				victimLastUsed = texture.LastUsedFrame;
+				victimUnneeded = unneeded;
+				victimBytes = bytes;
+			}
+		}
+		if (victim == m_textures.size())
+		{
+			break;
+		}
+		StreamedTexture& texture = m_textures[victim];
+		texture.TargetMip = texture.TargetMip < texture.TailMip ? texture.TargetMip + 1 : texture.Info.MipCount;
+		targetBytes -= victimBytes;
+	}
+
+	//Leaving mips out frees the memory for adding them, so those changes go first, then the textures with the most mips to add, which puts
+	//evicted textures being drawn again first of those
+	std::vector<uint32_t> order;
+	for (uint32_t i = 0; i < (uint32_t)m_textures.size(); i++)
+	{
+		if (m_textures[i].TargetMip != m_textures[i].ResidentMip)
+		{
+			order.push_back(i);
+		}
+	}
+	std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+	{
+		int addedA = (int)m_textures[a].ResidentMip - (int)m_textures[a].TargetMip;
+		int addedB = (int)m_textures[b].ResidentMip - (int)m_textures[b].TargetMip;
+		return addedA != addedB ? addedA < addedB : a < b;
+	});
+
+	//Until the mips left out have been, adding some could go over what was planned
+	uint64_t residentLimit = std::max<uint64_t>(m_memoryBudget, targetBytes);
+	uint64_t uploadedBytes = 0;
+	size_t made = 0;
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		StreamedTexture& texture = m_textures[order[i]];
+		bool upgrade = texture.TargetMip < texture.ResidentMip;
+		bool eviction = texture.TargetMip >= texture.Info.MipCount;
+
+		//Evicting uploads nothing, so it's never put off
+		uint64_t bytes = DDSProbe::GetBytes(texture.Info, texture.TargetMip);
+		if (!eviction && (uploadBudget == 0 || (made > 0 && uploadedBytes + bytes > uploadBudget)))
+		{
+			m_frame.Deferred++;
+			continue;
+		}
+		uint64_t residentBytes = m_stats.ResidentBytes - DDSProbe::GetBytes(texture.Info, texture.ResidentMip) + bytes;
+		if (upgrade && residentBytes > residentLimit)
+		{
+			m_frame.Deferred++;
+			continue;
+		}
+
+		changes.push_back({ order[i], texture.ResidentMip, texture.TargetMip, bytes });
+		texture.ResidentMip = texture.TargetMip;
+		m_stats.ResidentBytes = residentBytes;
+		m_frame.Upgrades += upgrade ? 1 : 0;
+		m_frame.Downgrades += upgrade ? 0 : 1;
+		m_frame.Evictions += eviction ? 1 : 0;
+		m_frame.UploadedBytes += bytes;
+		uploadedBytes += bytes;
+		made += eviction ? 0 : 1;
+	}
+
+	m_frame.ResidentBytes = m_stats.ResidentBytes;
+	m_stats.PeakResidentBytes = std::max<uint64_t>(m_stats.PeakResidentBytes, m_stats.ResidentBytes);
+	m_stats.Upgrades += m_frame.Upgrades;
+	m_stats.Downgrades += m_frame.Downgrades;
+	m_stats.Evictions += m_frame.Evictions;
+	m_stats.Deferred += m_frame.Deferred;
+	m_stats.UploadedBytes += m_frame.UploadedBytes;
+
+	//Whatever draws the textures asks again next frame
+	for (StreamedTexture& texture : m_textures)
+	{
+		texture.RequiredMip = texture.TailMip;
+	}
+	return order.empty();
+}
+
+void MipStreamer::SetResidentMip(uint32_t index, uint32_t mip)
+{
+	StreamedTexture& texture = m_textures[index];
+	m_stats.ResidentBytes = m_stats.ResidentBytes - DDSProbe::GetBytes(texture.Info, texture.ResidentMip) + DDSProbe::GetBytes(texture.Info, mip);
+	texture.ResidentMip = mip;
+}
+
+const DDSTextureInfo& MipStreamer::GetInfo(uint32_t index) const
+{
+	return m_textures[index].Info;
+}
+
+uint32_t MipStreamer::GetResidentMip(uint32_t index) const
+{
+	return m_textures[index].ResidentMip;
+}
+
+uint32_t MipStreamer::GetTailMip(uint32_t index) const
+{
+	return m_textures[index].TailMip;
+}
+
+uint32_t MipStreamer::GetLastUsedFrame(uint32_t index) const
+{
+	return m_textures[index].LastUsedFrame;
+}
+
+bool MipStreamer::IsEvicted(uint32_t index) const
+{
+	return m_textures[index].ResidentMip >= m_textures[index].Info.MipCount;
+}
+
+size_t MipStreamer::GetCount() const
+{
+	return m_textures.size();
+}
+
+const MipStreamerStats& MipStreamer::GetStats() const
+{
+	return m_stats;
+}
+
+const MipStreamerFrame& MipStreamer::GetFrame() const
+{
+	return m_frame;
+}
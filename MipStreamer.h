@@ -0,0 +1,140 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "DDSProbe.h"
+
+/// <summary>A texture to be uploaded again starting from a different mip, as MipStreamer::Update decided</summary>
+struct MipChange
+{
+	/// <summary>What MipStreamer::Add returned for it</summary>
+	uint32_t Index;
+	/// <summary>The first mip it has on the GPU now, and the first it's to have. Its MipCount for none at all, when it's evicted or being uploaded again</summary>
+	uint32_t FromMip;
+	uint32_t ToMip;
+	/// <summary>The pixel data to upload, every mip from ToMip on</summary>
+	uint64_t Bytes;
+};
+
+/// <summary>What one call to MipStreamer::Update did, and what the textures took up after it</summary>
+struct MipStreamerFrame
+{
+	/// <summary>Counts up from 1</summary>
+	uint32_t Frame;
+	uint64_t ResidentBytes;
+	/// <summary>Changes that added mips, changes that left them out, and of those the ones that left out every mip</summary>
+	uint32_t Upgrades;
+	uint32_t Downgrades;
+	uint32_t Evictions;
+	/// <summary>Textures drawn while evicted, so with nothing of their own, until they've been uploaded again</summary>
+	uint32_t Stalls;
+	uint32_t Deferred;
+	uint64_t UploadedBytes;
+};
+
+/// <summary>What a MipStreamer has done since it was made, and what its textures take up</summary>
+struct MipStreamerStats
+{
+	uint32_t Frames;
+	/// <summary>Changes that added mips, and changes that left them out</summary>
+	uint32_t Upgrades;
+	uint32_t Downgrades;
+	/// <summary>Downgrades that left out every mip of a texture not drawn that frame, and frames textures were drawn while evicted</summary>
+	uint32_t Evictions;
+	uint32_t Stalls;
+	/// <summary>Changes put off to a later frame by the upload budget, or because the mips they add didn't fit until others were left out</summary>
+	uint32_t Deferred;
+	uint64_t UploadedBytes;
+	uint64_t ResidentBytes;
+	uint64_t PeakResidentBytes;
+	/// <summary>What every texture takes up with only its tail</summary>
+	uint64_t TailBytes;
+	/// <summary>What the textures drawn last frame would take up at the mips asked for, however far over the budget that is</summary>
+	uint64_t RequiredBytes;
+};
+
+/// <summary><para>Decides which mips of each texture are on the GPU. </para>
+/// <para>Textures start with only their tail, the mips no bigger than the tail size, so a level's first frame uploads a fraction of its pixel data.
+/// Each frame, whatever draws a texture says how detailed a mip it needs with Require, usually GetRequiredMip of how far away it's drawn and how
+/// densely its texture coordinates are spread. Update then plans the mips each texture should have within the memory budget, and picks the
+/// changes to upload this frame within the upload budget. </para>
+/// <para>A texture keeps mips it no longer needs until the budget wants the memory back. When the mips asked for don't fit, the least recently
+/// drawn textures give theirs up first: a texture not drawn this frame is downgraded to its tail and then evicted altogether before any texture
+/// that was is touched. Among those drawn equally recently, mips no longer needed go first, then the top mip of the biggest texture at a time,
+/// so detail is lost evenly rather than from whichever texture came last. A texture drawn this frame always keeps its tail. </para>
+/// <para>An evicted texture drawn again stalls, drawn with nothing of its own until its mips are uploaded again, so those uploads go first. </para>
+/// <para>Nothing here needs Direct3D or a clock, so the same requests always give the same changes, see TextureChecks mips and TextureChecks residency.
+/// TextureLoader does the uploading.</para></summary>
+class MipStreamer
+{
+public:
+	/// <summary>The longest side of the largest mip uploaded to begin with</summary>
+	static const size_t DefaultTailSize = 128;
+	static const uint64_t DefaultMemoryBudget = 64 * 1024 * 1024;
+
+private:
+	struct StreamedTexture
+	{
+		DDSTextureInfo Info;
+		uint32_t TailMip;
+		/// <summary>The first mip on the GPU</summary>
+		uint32_t ResidentMip;
+		/// <summary>The most detailed mip asked for since the last Update, TailMip if none was</summary>
+		uint32_t RequiredMip;
+		/// <summary>The first mip Update planned for it</summary>
+		uint32_t TargetMip;
+		/// <summary>The frame it was last asked for in, by Require. The frame it was added in until then, so it isn't evicted before it's drawn</summary>
+		uint32_t LastUsedFrame;
+	};
+
+	std::vector<StreamedTexture> m_textures;
+	uint64_t m_memoryBudget;
+	size_t m_tailSize;
+	MipStreamerStats m_stats;
+	MipStreamerFrame m_frame;
+
+public:
+	/// <param name="memoryBudget">The most pixel data to keep on the GPU. The tails of the textures drawn each frame are kept whatever the budget</param>
+	/// <param name="tailSize">The longest side of the largest mip each texture starts with</param>
+	MipStreamer(uint64_t memoryBudget = DefaultMemoryBudget, size_t tailSize = DefaultTailSize);
+
+	/// <summary>The first mip of the tail: the largest no bigger than the tail size, or the last if none is</summary>
+	static uint32_t GetTailMip(const DDSTextureInfo& info, size_t tailSize);
+
+	/// <summary><para>The least detailed mip that still has a texel for every pixel of a surface. </para>
+	/// <para>A unit of the surface covers texCoordDensity of the texture on each side, so texCoordDensity times the texture's size texels of its
+	/// first mip, and pixelScale / distance pixels on screen. Each mip after the first halves the texels.</para></summary>
+	/// <param name="texCoordDensity">How far across the texture a world unit of the surface goes, see Submesh::GetTexCoordDensity</param>
+	/// <param name="distance">How far the nearest of the surface is from the camera</param>
+	/// <param name="pixelScale">The camera's Camera::GetPixelScale</param>
+	static uint32_t GetRequiredMip(const DDSTextureInfo& info, float texCoordDensity, float distance, float pixelScale);
+
+	/// <summary>Starts streaming a texture just uploaded with only its tail</summary>
+	/// <returns>Its index, counting up from 0</returns>
+	uint32_t Add(const DDSTextureInfo& info);
+
+	/// <summary>Asks for a texture to have at least the detail of mip this frame, and marks it drawn this frame. The most detailed mip asked for wins</summary>
+	void Require(uint32_t index, uint32_t mip);
+
+	/// <summary>Plans the mips each texture should have from what was asked for since the last call, and picks the changes to upload this frame.
+	/// Called once a frame</summary>
+	/// <param name="uploadBudget">How much pixel data the changes can upload. The first change is made however big it is, unless this is 0</param>
+	/// <param name="changes">Has the changes picked appended to it, least detailed first. They're taken as done, see SetResidentMip</param>
+	/// <returns>true if every texture already has the mips planned for it, so there was nothing to change</returns>
+	bool Update(uint64_t uploadBudget, std::vector<MipChange>& changes);
+
+	/// <summary>Puts back the first mip a texture actually has, its MipCount for none, when uploading a change failed</summary>
+	void SetResidentMip(uint32_t index, uint32_t mip);
+
+	const DDSTextureInfo& GetInfo(uint32_t index) const;
+	uint32_t GetResidentMip(uint32_t index) const;
+	uint32_t GetTailMip(uint32_t index) const;
+	/// <summary>The frame it was last asked for in, see MipStreamerFrame::Frame</summary>
+	uint32_t GetLastUsedFrame(uint32_t index) const;
+	/// <summary>Whether none of its mips are on the GPU</summary>
+	bool IsEvicted(uint32_t index) const;
+	size_t GetCount() const;
+	const MipStreamerStats& GetStats() const;
+	/// <summary>What the last call to Update did</summary>
+	const MipStreamerFrame& GetFrame() const;
+};
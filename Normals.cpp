@@ -1,75 +1,431 @@
-#include "Normals.h"
-
-/// <summary>
-/// <para>Used to calculate the smooth shading normals by:</para>
-/// <para>  -   computing the cross product for each triangle in the vertex</para>
-/// <para>  -   add that to the normal of each vertex of that triangle</para>
-/// <para>  -   normalize the normal of each vertex</para>
-/// <para>This whole function is made possible thanks to Julien Guertault on stack exchange: https://computergraphics.stackexchange.com/a/4032 </para>
-/// </summary>
-/// <param name="Vertices">:    an std::vector* of SimpleVertex s. </param>
-/// <param name="Indices">: an array of indices used to get the vertices of each triangle</param>
-/// <param name="IndicesCount">:    the number of indices (i.e. the length of indices)</param>
-void CalculateSmoothNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices)
-{
-    //  The function is based off of the following psuedocode
-    //  for each traingle abc
-    //      perpendicular - crossProduct(triangle.b - triangle.a, triangle.c - triangle.a)
-    //      a.normal += perpendicular
-    //      b.normal += perpendicular
-    //      c.normal += perpendicular
-    //  for each vertex
-    //      vertex.normal = normalize(vertex.normal)
-
-    //For each triangle...
-    for (int i = 0; i < Indices->size(); i += 3)
-    {
-        //Load the positions into temporary vectors
-        SimpleVertex_Vector a = { XMLoadFloat3(&Vertices->at(Indices->at(i)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i)).Normal) };
-        SimpleVertex_Vector b = { XMLoadFloat3(&Vertices->at(Indices->at(i + 1)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i + 1)).Normal) };
-        SimpleVertex_Vector c = { XMLoadFloat3(&Vertices->at(Indices->at(i + 2)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i + 2)).Normal) };
-
-        //Find the perpendicular vector to the triangle
-        XMVECTOR P = XMVector3Cross(b.Pos - a.Pos, c.Pos - a.Pos);
-
-        //Add the result to the already exisiting normal and then store that result into the original vertex array's normal
-        XMStoreFloat3(&Vertices->at(Indices->at(i)).Normal, P + a.Normal);
-        XMStoreFloat3(&Vertices->at(Indices->at(i + 1)).Normal, P + b.Normal);
-        XMStoreFloat3(&Vertices->at(Indices->at(i + 2)).Normal, P + c.Normal);
-    }
-    //For each vertex's normal
-    for (int i = 0; i < Vertices->size(); i++)
-    {
-        //Normalize that vertex's normal and store it where it was.
-        XMStoreFloat3(&Vertices->at(i).Normal, XMVector3Normalize(XMLoadFloat3(&Vertices->at(i).Normal)));
-    }
-}
-
-void CalculateFlatNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices)
-{
-    //  The function is based off of the following psuedocode
-    //  for each traingle abc
-    //      perpendicular = normalize(crossProduct(triangle.b - triangle.a, triangle.c - triangle.a))
-    //      a.normal = perpendicular
-    //      b.normal = perpendicular
-    //      c.normal = perpendicular
-
-    // For each triangle...
-    int i = 0;
-    while (i < Indices->size())
-    {
-        //Load the positions into temporary vectors
-        SimpleVertex_Vector a = { XMLoadFloat3(&Vertices->at(Indices->at(i)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i)).Normal) };
-        SimpleVertex_Vector b = { XMLoadFloat3(&Vertices->at(Indices->at(i + 1)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i + 1)).Normal) };
-        SimpleVertex_Vector c = { XMLoadFloat3(&Vertices->at(Indices->at(i + 2)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i + 2)).Normal) };
-
-        //Find the perpendicular vector to the triangle
-        XMVECTOR P = XMVector3Normalize(XMVector3Cross(b.Pos - a.Pos, c.Pos - a.Pos));
-
-        //Store that result to each vertex in the triangle and move onto the next triangle
-        XMStoreFloat3(&Vertices->at(Indices->at(i)).Normal, P);
-        XMStoreFloat3(&Vertices->at(Indices->at(i + 1)).Normal, P);
-        XMStoreFloat3(&Vertices->at(Indices->at(i + 2)).Normal, P);
-        i += 3;
-    }
-}
+#include "Normals.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>       //For Normals::Benchmark
+#include <cmath>
+
+//Face normals and normalizing are done four at a time with SSE2 where it's there, which it always is on x86 and x64
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define NORMALS_SSE2
+#endif
+
+namespace
+{
+    //Fewer triangles or vertices than this aren't worth handing to another thread
+    const size_t MinimumChunk = 4096;
+
+    //Splits count items into ranges and calls body(begin, end) on each, across the shared thread pool unless threadCount is 1.
+    //Every range but the last is a multiple of four long, so only the last one ends with a partial SSE2 group
+    template <typename Body>
+    void ForEachRange(size_t count, unsigned int threadCount, const Body& body)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = ThreadPool::GetShared().GetThreadCount();
+        }
+        size_t chunkCount = (count + MinimumChunk - 1) / MinimumChunk;
+        if (chunkCount > threadCount) chunkCount = threadCount;
+        if (chunkCount <= 1)
+        {
+            body((size_t)0, count);
+            return;
+        }
+
+        size_t chunkSize = ((count + chunkCount - 1) / chunkCount + 3) & ~(size_t)3;
+        ThreadPool::GetShared().ParallelFor(chunkCount, [&](size_t chunk)
+        {
+            size_t begin = chunk * chunkSize;
+            size_t end = std::min<size_t>(begin + chunkSize, count);
+            if (begin < end)
+            {
+                body(begin, end);
+            }
+        });
+    }
+
+    template <typename Index>
+    void BuildVertexFacesT(const Index* indices, size_t indexCount, size_t vertexCount, VertexFaces& adjacency)
+    {
+        //A partial triangle at the end of the indices is ignored
+        size_t cornerCount = indexCount - indexCount % 3;
+        adjacency.Offsets.assign(vertexCount + 1, 0);
+        adjacency.Faces.resize(cornerCount);
+
+        //Count the corners each vertex is, one place along, so adding up the counts leaves each vertex's offset where its faces start
+        for (size_t i = 0; i < cornerCount; i++)
+        {
+            adjacency.Offsets[indices[i] + 1]++;
+        }
+        for (size_t v = 0; v < vertexCount; v++)
+        {
+            adjacency.Offsets[v + 1] += adjacency.Offsets[v];
+        }
+
+        //Going through the triangles in order keeps each vertex's faces in the order the original adds them up in
+        std::vector<unsigned int> cursors(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+        for (size_t i = 0; i < cornerCount; i++)
+        {
+            adjacency.Faces[cursors[indices[i]]++] = (unsigned int)(i / 3);
+        }
+    }
+
+#ifdef NORMALS_SSE2
+    //Loads one component of the same corner of four triangles in a row, one triangle per lane
+    template <typename Index>
+    inline __m128 Gather(const float* stream, const Index* triangles, int corner)
+    {
+        return _mm_setr_ps(stream[triangles[corner]], stream[triangles[corner + 3]], stream[triangles[corner + 6]], stream[triangles[corner + 9]]);
+    }
+#endif
+
+    //Works out the cross product of (b - a) and (c - a) for the triangles from begin to end, the same sum XMVector3Cross does
+    template <typename Index>
+    void CalculateFaceNormals(NormalStreams& streams, const Index* indices, size_t begin, size_t end)
+    {
+        const float* px = streams.PositionX.data();
+        const float* py = streams.PositionY.data();
+        const float* pz = streams.PositionZ.data();
+        float* fx = streams.FaceX.data();
+        float* fy = streams.FaceY.data();
+        float* fz = streams.FaceZ.data();
+
+        size_t t = begin;
+#ifdef NORMALS_SSE2
+        for (; t + 4 <= end; t += 4)
+        {
+            const Index* triangles = indices + t * 3;
+            __m128 ax = Gather(px, triangles, 0);
+            __m128 ay = Gather(py, triangles, 0);
+            __m128 az = Gather(pz, triangles, 0);
+            __m128 e1x = _mm_sub_ps(Gather(px, triangles, 1), ax);
+            __m128 e1y = _mm_sub_ps(Gather(py, triangles, 1), ay);
+            __m128 e1z = _mm_sub_ps(Gather(pz, triangles, 1), az);
+            __m128 e2x = _mm_sub_ps(Gather(px, triangles, 2), ax);
+            __m128 e2y = _mm_sub_ps(Gather(py, triangles, 2), ay);
+            __m128 e2z = _mm_sub_ps(Gather(pz, triangles, 2), az);
+
+            _mm_storeu_ps(fx + t, _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y)));
+            _mm_storeu_ps(fy + t, _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z)));
+            _mm_storeu_ps(fz + t, _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x)));
+        }
+#endif
+        for (; t < end; t++)
+        {
+            const Index* triangle = indices + t * 3;
+            float e1x = px[triangle[1]] - px[triangle[0]];
+            float e1y = py[triangle[1]] - py[triangle[0]];
+            float e1z = pz[triangle[1]] - pz[triangle[0]];
+            float e2x = px[triangle[2]] - px[triangle[0]];
+            float e2y = py[triangle[2]] - py[triangle[0]];
+            float e2z = pz[triangle[2]] - pz[triangle[0]];
+
+            fx[t] = e1y * e2z - e1z * e2y;
+            fy[t] = e1z * e2x - e1x * e2z;
+            fz[t] = e1x * e2y - e1y * e2x;
+        }
+    }
+
+    //Adds each vertex from begin to end's face normals onto its normal and normalizes it. Only those vertices are written to,
+    //so ranges can be worked on at the same time
+    void GatherVertexNormals(NormalStreams& streams, const VertexFaces& adjacency, size_t begin, size_t end)
+    {
+        float* nx = streams.NormalX.data();
+        float* ny = streams.NormalY.data();
+        float* nz = streams.NormalZ.data();
+        const float* fx = streams.FaceX.data();
+        const float* fy = streams.FaceY.data();
+        const float* fz = streams.FaceZ.data();
+        const unsigned int* offsets = adjacency.Offsets.data();
+        const unsigned int* faces = adjacency.Faces.data();
+
+        for (size_t v = begin; v < end; v++)
+        {
+            float x = nx[v];
+            float y = ny[v];
+            float z = nz[v];
+            for (unsigned int f = offsets[v]; f < offsets[v + 1]; f++)
+            {
+                x += fx[faces[f]];
+                y += fy[faces[f]];
+                z += fz[faces[f]];
+            }
+            nx[v] = x;
+            ny[v] = y;
+            nz[v] = z;
+        }
+
+        //A normal with no length is left at zero, as XMVector3Normalize leaves it
+        size_t v = begin;
+#ifdef NORMALS_SSE2
+        __m128 zero = _mm_setzero_ps();
+        for (; v + 4 <= end; v += 4)
+        {
+            __m128 x = _mm_loadu_ps(nx + v);
+            __m128 y = _mm_loadu_ps(ny + v);
+            __m128 z = _mm_loadu_ps(nz + v);
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+            __m128 nonZero = _mm_cmpneq_ps(length, zero);
+
+            _mm_storeu_ps(nx + v, _mm_and_ps(_mm_div_ps(x, length), nonZero));
+            _mm_storeu_ps(ny + v, _mm_and_ps(_mm_div_ps(y, length), nonZero));
+            _mm_storeu_ps(nz + v, _mm_and_ps(_mm_div_ps(z, length), nonZero));
+        }
+#endif
+        for (; v < end; v++)
+        {
+            float length = sqrtf(nx[v] * nx[v] + ny[v] * ny[v] + nz[v] * nz[v]);
+            if (length != 0.0f)
+            {
+                nx[v] /= length;
+                ny[v] /= length;
+                nz[v] /= length;
+            }
+        }
+    }
+
+    template <typename Index>
+    void CalculateSmoothT(NormalStreams& streams, const Index* indices, size_t indexCount, const VertexFaces& adjacency, unsigned int threadCount)
+    {
+        size_t triangleCount = indexCount / 3;
+        streams.FaceX.resize(triangleCount);
+        streams.FaceY.resize(triangleCount);
+        streams.FaceZ.resize(triangleCount);
+
+        ForEachRange(triangleCount, threadCount, [&](size_t begin, size_t end)
+        {
+            CalculateFaceNormals(streams, indices, begin, end);
+        });
+        ForEachRange(streams.NormalX.size(), threadCount, [&](size_t begin, size_t end)
+        {
+            GatherVertexNormals(streams, adjacency, begin, end);
+        });
+    }
+
+    template <typename Index>
+    void CalculateSmoothNormalsT(std::vector<SimpleVertex>* Vertices, std::vector<Index>* Indices)
+    {
+        NormalStreams streams;
+        VertexFaces adjacency;
+        Normals::ToStreams(*Vertices, streams);
+        Normals::BuildVertexFaces(Indices->data(), Indices->size(), Vertices->size(), adjacency);
+        Normals::CalculateSmooth(streams, Indices->data(), Indices->size(), adjacency);
+        Normals::FromStreams(streams, *Vertices);
+    }
+
+    /// <summary>
+    /// <para>Used to calculate the smooth shading normals by:</para>
+    /// <para>  -   computing the cross product for each triangle in the vertex</para>
+    /// <para>  -   add that to the normal of each vertex of that triangle</para>
+    /// <para>  -   normalize the normal of each vertex</para>
+    /// <para>This whole function is made possible thanks to Julien Guertault on stack exchange: https://computergraphics.stackexchange.com/a/4032 </para>
+    /// </summary>
+    /// <param name="Vertices">:    an std::vector* of SimpleVertex s. </param>
+    /// <param name="Indices">: an array of indices used to get the vertices of each triangle</param>
+    template <typename Index>
+    void CalculateSmoothReferenceT(std::vector<SimpleVertex>* Vertices, std::vector<Index>* Indices)
+    {
+        //  The function is based off of the following psuedocode
+        //  for each traingle abc
+        //      perpendicular - crossProduct(triangle.b - triangle.a, triangle.c - triangle.a)
+        //      a.normal += perpendicular
+        //      b.normal += perpendicular
+        //      c.normal += perpendicular
+        //  for each vertex
+        //      vertex.normal = normalize(vertex.normal)
+
+        //For each triangle...
+        for (size_t i = 0; i < Indices->size(); i += 3)
+        {
+            //Load the positions into temporary vectors
+            SimpleVertex_Vector a = { XMLoadFloat3(&Vertices->at(Indices->at(i)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i)).Normal) };
+            SimpleVertex_Vector b = { XMLoadFloat3(&Vertices->at(Indices->at(i + 1)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i + 1)).Normal) };
+            SimpleVertex_Vector c = { XMLoadFloat3(&Vertices->at(Indices->at(i + 2)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i + 2)).Normal) };
+
+            //Find the perpendicular vector to the triangle
+            XMVECTOR P = XMVector3Cross(b.Pos - a.Pos, c.Pos - a.Pos);
+
+            //Add the result to the already exisiting normal and then store that result into the original vertex array's normal
+            XMStoreFloat3(&Vertices->at(Indices->at(i)).Normal, P + a.Normal);
+            XMStoreFloat3(&Vertices->at(Indices->at(i + 1)).Normal, P + b.Normal);
+            XMStoreFloat3(&Vertices->at(Indices->at(i + 2)).Normal, P + c.Normal);
+        }
+        //For each vertex's normal
+        for (size_t i = 0; i < Vertices->size(); i++)
+        {
+            //Normalize that vertex's normal and store it where it was.
+            XMStoreFloat3(&Vertices->at(i).Normal, XMVector3Normalize(XMLoadFloat3(&Vertices->at(i).Normal)));
+        }
+    }
+
+    float GetMaxError(const std::vector<SimpleVertex>& a, const std::vector<SimpleVertex>& b)
+    {
+        float maxError = 0.0f;
+        for (size_t i = 0; i < a.size() && i < b.size(); i++)
+        {
+            maxError = std::max(maxError, std::fabs(a[i].Normal.x - b[i].Normal.x));
+            maxError = std::max(maxError, std::fabs(a[i].Normal.y - b[i].Normal.y));
+            maxError = std::max(maxError, std::fabs(a[i].Normal.z - b[i].Normal.z));
+        }
+        return maxError;
+    }
+}
+
+void CalculateSmoothNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices)
+{
+    CalculateSmoothNormalsT(Vertices, Indices);
+}
+
+void CalculateSmoothNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned int>* Indices)
+{
+    CalculateSmoothNormalsT(Vertices, Indices);
+}
+
+void CalculateFlatNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices)
+{
+    //  The function is based off of the following psuedocode
+    //  for each traingle abc
+    //      perpendicular = normalize(crossProduct(triangle.b - triangle.a, triangle.c - triangle.a))
+    //      a.normal = perpendicular
+    //      b.normal = perpendicular
+    //      c.normal = perpendicular
+
+    // For each triangle...
+    int i = 0;
+    while (i < Indices->size())
+    {
+        //Load the positions into temporary vectors
+        SimpleVertex_Vector a = { XMLoadFloat3(&Vertices->at(Indices->at(i)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i)).Normal) };
+        SimpleVertex_Vector b = { XMLoadFloat3(&Vertices->at(Indices->at(i + 1)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i + 1)).Normal) };
+        SimpleVertex_Vector c = { XMLoadFloat3(&Vertices->at(Indices->at(i + 2)).Pos), XMLoadFloat3(&Vertices->at(Indices->at(i + 2)).Normal) };
+
+        //Find the perpendicular vector to the triangle
+        XMVECTOR P = XMVector3Normalize(XMVector3Cross(b.Pos - a.Pos, c.Pos - a.Pos));
+
+        //Store that result to each vertex in the triangle and move onto the next triangle
+        XMStoreFloat3(&Vertices->at(Indices->at(i)).Normal, P);
+        XMStoreFloat3(&Vertices->at(Indices->at(i + 1)).Normal, P);
+        XMStoreFloat3(&Vertices->at(Indices->at(i + 2)).Normal, P);
+        i += 3;
+    }
+}
+
+void Normals::ToStreams(const std::vector<SimpleVertex>& vertices, NormalStreams& streams)
+{
+    size_t count = vertices.size();
+    streams.PositionX.resize(count);
+    streams.PositionY.resize(count);
+    streams.PositionZ.resize(count);
+    streams.NormalX.resize(count);
+    streams.NormalY.resize(count);
+    streams.NormalZ.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        streams.PositionX[i] = vertices[i].Pos.x;
+        streams.PositionY[i] = vertices[i].Pos.y;
+        streams.PositionZ[i] = vertices[i].Pos.z;
+        streams.NormalX[i] = vertices[i].Normal.x;
+        streams.NormalY[i] = vertices[i].Normal.y;
+        streams.NormalZ[i] = vertices[i].Normal.z;
+    }
+}
+
+void Normals::FromStreams(const NormalStreams& streams, std::vector<SimpleVertex>& vertices)
+{
+    for (size_t i = 0; i < vertices.size() && i < streams.NormalX.size(); i++)
+    {
+        vertices[i].Normal = XMFLOAT3(streams.NormalX[i], streams.NormalY[i], streams.NormalZ[i]);
+    }
+}
+
+void Normals::BuildVertexFaces(const unsigned short* indices, size_t indexCount, size_t vertexCount, VertexFaces& adjacency)
+{
+    BuildVertexFacesT(indices, indexCount, vertexCount, adjacency);
+}
+
+void Normals::BuildVertexFaces(const unsigned int* indices, size_t indexCount, size_t vertexCount, VertexFaces& adjacency)
+{
+    BuildVertexFacesT(indices, indexCount, vertexCount, adjacency);
+}
+
+void Normals::CalculateSmooth(NormalStreams& streams, const unsigned short* indices, size_t indexCount, const VertexFaces& adjacency, unsigned int threadCount)
+{
+    CalculateSmoothT(streams, indices, indexCount, adjacency, threadCount);
+}
+
+void Normals::CalculateSmooth(NormalStreams& streams, const unsigned int* indices, size_t indexCount, const VertexFaces& adjacency, unsigned int threadCount)
+{
+    CalculateSmoothT(streams, indices, indexCount, adjacency, threadCount);
+}
+
+void Normals::CalculateSmoothReference(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices)
+{
+    CalculateSmoothReferenceT(Vertices, Indices);
+}
+
+void Normals::CalculateSmoothReference(std::vector<SimpleVertex>* Vertices, std::vector<unsigned int>* Indices)
+{
+    CalculateSmoothReferenceT(Vertices, Indices);
+}
+
+NormalsBenchmark Normals::Benchmark(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, int iterations)
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    NormalsBenchmark result = {};
+    result.VertexCount = vertices.size();
+    result.TriangleCount = indices.size() / 3;
+
+    //Normals are generated from nothing, so every run starts from zeroed ones
+    std::vector<SimpleVertex> zeroed(vertices);
+    for (SimpleVertex& vertex : zeroed)
+    {
+        vertex.Normal = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    }
+    std::vector<unsigned int> indexCopy(indices);
+
+    std::vector<SimpleVertex> reference;
+    std::vector<SimpleVertex> total;
+    std::vector<SimpleVertex> streamed(zeroed);
+    double bestReference = 0.0;
+    double bestTotal = 0.0;
+    double bestStreams = 0.0;
+
+    for (int i = 0; i < iterations; i++)
+    {
+        reference = zeroed;
+        Clock::time_point start = Clock::now();
+        CalculateSmoothReference(&reference, &indexCopy);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (i == 0 || seconds < bestReference) bestReference = seconds;
+    }
+
+    for (int i = 0; i < iterations; i++)
+    {
+        total = zeroed;
+        Clock::time_point start = Clock::now();
+        CalculateSmoothNormals(&total, &indexCopy);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (i == 0 || seconds < bestTotal) bestTotal = seconds;
+    }
+
+    NormalStreams streams;
+    VertexFaces adjacency;
+    BuildVertexFaces(indexCopy.data(), indexCopy.size(), zeroed.size(), adjacency);
+    for (int i = 0; i < iterations; i++)
+    {
+        ToStreams(zeroed, streams);
+        Clock::time_point start = Clock::now();
+        CalculateSmooth(streams, indexCopy.data(), indexCopy.size(), adjacency);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (i == 0 || seconds < bestStreams) bestStreams = seconds;
+    }
+    FromStreams(streams, streamed);
+
+    result.ReferenceMs = bestReference * 1000.0;
+    result.TotalMs = bestTotal * 1000.0;
+    result.StreamsMs = bestStreams * 1000.0;
+    result.Threads = ThreadPool::GetShared().GetThreadCount();
+    result.MaxError = std::max(GetMaxError(reference, total), GetMaxError(reference, streamed));
+    return result;
+}
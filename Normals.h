@@ -1,9 +1,84 @@
-#pragma once
-#include <DirectXMath.h>
-#include <vector>
-#include "Vertices.h"
-
-using namespace DirectX;
-
-void CalculateSmoothNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices);
-void CalculateFlatNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices);
\ No newline at end of file
+#pragma once
+#include <DirectXMath.h>
+#include <vector>
+#include "Vertices.h"
+
+using namespace DirectX;
+
+/// <summary>A mesh's positions and normals with one array per component, so four vertices' worth of any one component load into a single SSE register</summary>
+struct NormalStreams
+{
+	std::vector<float> PositionX;
+	std::vector<float> PositionY;
+	std::vector<float> PositionZ;
+	std::vector<float> NormalX;
+	std::vector<float> NormalY;
+	std::vector<float> NormalZ;
+	/// <summary>Each triangle's unnormalized normal, filled in by Normals::CalculateSmooth. Kept here so recalculating doesn't reallocate them</summary>
+	std::vector<float> FaceX;
+	std::vector<float> FaceY;
+	std::vector<float> FaceZ;
+};
+
+/// <summary>The triangles around each vertex, in the order they are in the index buffer: vertex v's are Faces[Offsets[v]] up to Faces[Offsets[v + 1]].
+/// A triangle that uses a vertex twice is listed twice</summary>
+struct VertexFaces
+{
+	std::vector<unsigned int> Offsets;
+	std::vector<unsigned int> Faces;
+};
+
+/// <summary>The results of Normals::Benchmark. Times are the fastest of every iteration</summary>
+struct NormalsBenchmark
+{
+	size_t VertexCount;
+	size_t TriangleCount;
+	/// <summary>The original CalculateSmoothNormals, kept as Normals::CalculateSmoothReference</summary>
+	double ReferenceMs;
+	/// <summary>CalculateSmoothNormals as a whole: converting to and from streams, building the adjacency and calculating</summary>
+	double TotalMs;
+	/// <summary>Normals::CalculateSmooth on its own, for a mesh whose streams and adjacency are kept between calculations</summary>
+	double StreamsMs;
+	/// <summary>How many threads CalculateSmooth could use</summary>
+	unsigned int Threads;
+	/// <summary>The largest difference between any component of the reference's normals and CalculateSmoothNormals'</summary>
+	float MaxError;
+};
+
+/// <summary>Adds up the cross products of the triangles around each vertex, on top of its existing normal, and normalizes the sums. Works through Normals::CalculateSmooth</summary>
+void CalculateSmoothNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices);
+void CalculateSmoothNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned int>* Indices);
+void CalculateFlatNormals(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices);
+
+/// <summary><para>Smooth normal generation laid out for SIMD and threads. </para>
+/// <para>Face normals are worked out four triangles at a time with SSE2 from NormalStreams, split across the shared thread pool. Each vertex then
+/// adds up its own triangles' normals through VertexFaces, so every thread writes only its own vertices and nothing needs to be atomic.
+/// Each vertex adds its triangles in index buffer order, exactly as the original did, so the results match it to rounding.</para></summary>
+namespace Normals
+{
+	/// <summary>How far apart CalculateSmoothNormals and CalculateSmoothReference's normals may be before Benchmark counts them as different</summary>
+	const float MatchEpsilon = 1e-5f;
+
+	void ToStreams(const std::vector<SimpleVertex>& vertices, NormalStreams& streams);
+
+	/// <summary>Copies the normals back into vertices, leaving everything else as it was</summary>
+	void FromStreams(const NormalStreams& streams, std::vector<SimpleVertex>& vertices);
+
+	/// <summary>Finds the triangles around each vertex with a counting sort over the index buffer. Only has to be built again if the indices change</summary>
+	void BuildVertexFaces(const unsigned short* indices, size_t indexCount, size_t vertexCount, VertexFaces& adjacency);
+	void BuildVertexFaces(const unsigned int* indices, size_t indexCount, size_t vertexCount, VertexFaces& adjacency);
+
+	/// <summary>Adds each triangle's cross product to the normals of its vertices, then normalizes every normal. Every index must be a vertex in streams</summary>
+	/// <param name="adjacency">Built by BuildVertexFaces from the same indices</param>
+	/// <param name="threadCount">How many threads to spread the work over. 0 uses the shared thread pool, 1 works on the calling thread only</param>
+	void CalculateSmooth(NormalStreams& streams, const unsigned short* indices, size_t indexCount, const VertexFaces& adjacency, unsigned int threadCount = 0);
+	void CalculateSmooth(NormalStreams& streams, const unsigned int* indices, size_t indexCount, const VertexFaces& adjacency, unsigned int threadCount = 0);
+
+	/// <summary>The original one triangle at a time CalculateSmoothNormals. Slow, but kept as the reference the streamed version is measured and checked against</summary>
+	void CalculateSmoothReference(std::vector<SimpleVertex>* Vertices, std::vector<unsigned short>* Indices);
+	void CalculateSmoothReference(std::vector<SimpleVertex>* Vertices, std::vector<unsigned int>* Indices);
+
+	/// <summary>Regenerates a mesh's normals from zero with the reference and the streamed version, times both and compares them</summary>
+	/// <param name="iterations">How many times to run each. The fastest run of each is kept</param>
+	NormalsBenchmark Benchmark(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, int iterations = 5);
+};
@@ -0,0 +1,401 @@
+#include "OBJImporter.h"
+#include "MeshOptimizer.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace
+{
+	//Reports go to the debugger's output on Windows. Elsewhere the importer runs in the asset cooker, which keeps stdout for its own table
+	void Report(const char* line)
+	{
+#ifdef _WIN32
+		OutputDebugStringA(line);
+#else
+		fputs(line, stderr);
+#endif
+	}
+}
+
+std::string OBJImporter::GetBinaryFilename(const std::string& filename)
+{
+	return filename + "Binary";
+}
+
+uint32_t OBJImporter::ChooseIndexSize(size_t vertexCount)
+{
+	//16 bit indices can address vertices 0 to 65535, anything bigger would wrap around
+	return vertexCount <= 0xFFFF ? sizeof(unsigned short) : sizeof(unsigned int);
+}
+
+void OBJImporter::CreateIndices(const std::vector<XMFLOAT3>& inVertices, 
+							  const std::vector<XMFLOAT2>& inTexCoords, 
+							  const std::vector<XMFLOAT3>& inNormals, 
+							  std::vector<unsigned int>& outIndices, 
+							  std::vector<XMFLOAT3>& outVertices, 
+							  std::vector<XMFLOAT2>& outTexCoords, 
+							  std::vector<XMFLOAT3>& outNormals)
+{
+	int numVertices = inVertices.size();
+
+	// Hash table of the vertices we've already added, so identical corners share one vertex
+	VertexWelder welder(numVertices);
+	
+	for(int i = 0; i < numVertices; ++i) //For each vertex
+	{
+		SimpleVertex vertex = {inVertices[i], inNormals[i],  inTexCoords[i]}; 
+
+		// Re-uses the index of an identical vertex if there is one, otherwise adds this one to the end
+		size_t uniqueVertices = welder.GetVertexCount();
+		unsigned int index = welder.Insert(vertex);
+		
+		if(welder.GetVertexCount() > uniqueVertices) //if it was new, add it to the buffer
+		{
+			outVertices.push_back(vertex.Pos);
+			outTexCoords.push_back(vertex.TexCoord);
+			outNormals.push_back(vertex.Normal);
+		}
+
+		outIndices.push_back(index);
+	}
+}
+
+void OBJImporter::ReportWelding(const std::string& filename, size_t verticesBefore, size_t verticesAfter, size_t indexCount)
+{
+	size_t bytesBefore = sizeof(SimpleVertex) * verticesBefore + ChooseIndexSize(verticesBefore) * indexCount;
+	size_t bytesAfter = sizeof(SimpleVertex) * verticesAfter + ChooseIndexSize(verticesAfter) * indexCount;
+
+	char line[512];
+	snprintf(line, sizeof(line), "%s: welded %zu -> %zu vertices, %zu -> %zu bytes of vertex and index buffer\n",
+		filename.c_str(), verticesBefore, verticesAfter, bytesBefore, bytesAfter);
+	Report(line);
+}
+
+void OBJImporter::ReportVertexCache(const std::string& filename, const VertexCacheStatistics& before, const VertexCacheStatistics& after)
+{
+	char line[512];
+	snprintf(line, sizeof(line), "%s: vertex cache ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+		filename.c_str(), before.ACMR, after.ACMR, before.ATVR, after.ATVR);
+	Report(line);
+}
+
+void OBJImporter::ReportQuantization(const std::string& filename, const VertexQuantizationError& error)
+{
+	char line[512];
+	snprintf(line, sizeof(line), "%s: compact vertices are 16 bytes instead of 32, max error position %g (%.4f%% of the bounds), normal %.3f degrees, texcoord %g\n",
+		filename.c_str(), error.MaxPositionError, error.RelativePositionError * 100.0f, error.MaxNormalError, error.MaxTexCoordError);
+	Report(line);
+}
+
+void OBJImporter::ReportMeshlets(const std::string& filename, const std::vector<Meshlet>& meshlets)
+{
+	size_t triangles = 0;
+	size_t withCones = 0;
+	for (const Meshlet& meshlet : meshlets)
+	{
+		triangles += meshlet.IndexCount / 3;
+		if (meshlet.ConeCutoff < 1.0f) withCones++;
+	}
+
+	char line[512];
+	snprintf(line, sizeof(line), "%s: %zu meshlets of %.1f triangles on average, %zu with a normal cone narrow enough to back-face cull\n",
+		filename.c_str(), meshlets.size(), meshlets.empty() ? 0.0f : (float)triangles / meshlets.size(), withCones);
+	Report(line);
+}
+
+void OBJImporter::ReportSubmeshes(const std::string& filename, const std::vector<Submesh>& submeshes)
+{
+	char line[512];
+	for (size_t i = 0; i < submeshes.size(); i++)
+	{
+		snprintf(line, sizeof(line), "%s: submesh %zu of %zu uses material \"%s\", %u triangles, %u meshlets, %.3f texture coordinates a unit\n", filename.c_str(),
+			i + 1, submeshes.size(), submeshes[i].GetMaterialName().c_str(), submeshes[i].IndexCount / 3, submeshes[i].MeshletCount, submeshes[i].GetTexCoordDensity());
+		Report(line);
+	}
+}
+
+void OBJImporter::ReportLods(const std::string& filename, const std::vector<MeshLod>& lods, const std::vector<Submesh>& submeshes)
+{
+	char line[512];
+	for (const Submesh& submesh : submeshes)
+	{
+		//Only name the material when there's more than one, so single material meshes report as they always have
+		std::string name = submeshes.size() > 1 ? " (" + submesh.GetMaterialName() + ")" : "";
+		const MeshLod* chain = lods.data() + submesh.LodStart;
+		for (size_t level = 1; level < submesh.LodCount; level++)
+		{
+			snprintf(line, sizeof(line), "%s%s: LOD %zu keeps %u of %u triangles (%.1f%%), at most %g from the full detail mesh\n", filename.c_str(), name.c_str(), level,
+				chain[level].IndexCount / 3, chain[0].IndexCount / 3, 100.0f * chain[level].IndexCount / chain[0].IndexCount, chain[level].Error);
+			Report(line);
+		}
+		if (submesh.LodCount < 2)
+		{
+			snprintf(line, sizeof(line), "%s%s: couldn't be simplified enough for any lower levels of detail\n", filename.c_str(), name.c_str());
+			Report(line);
+		}
+	}
+}
+
+void OBJImporter::ReportOverdraw(const std::string& filename, float before, float after)
+{
+	char line[512];
+	snprintf(line, sizeof(line), "%s: average overdraw from %u directions %.3f -> %.3f\n",
+		filename.c_str(), MeshOptimizer::DefaultOverdrawDirections, before, after);
+	Report(line);
+}
+
+bool OBJImporter::GetCorner(const OBJData& data, size_t corner, XMFLOAT3& position, XMFLOAT2& texCoord, XMFLOAT3& normal, bool& filled)
+{
+	//OBJParser leaves an empty field as index 0 less 1, and "f 1 2 3" reuses the position's index, which only fits when there are vt and vn lines
+	const unsigned int missing = 0xFFFFFFFF;
+	unsigned int v = data.VertexIndices[corner];
+	unsigned int t = data.TexCoordIndices[corner];
+	unsigned int n = data.NormalIndices[corner];
+	bool noTexCoord = t == missing || data.TexCoords.empty();
+	bool noNormal = n == missing || data.Normals.empty();
+	if (v >= data.Vertices.size() || (!noTexCoord && t >= data.TexCoords.size()) || (!noNormal && n >= data.Normals.size()))
+	{
+		return false;
+	}
+
+	position = data.Vertices[v];
+	texCoord = noTexCoord ? XMFLOAT2(0.0f, 0.0f) : data.TexCoords[t];
+	normal = noNormal ? XMFLOAT3(0.0f, 0.0f, 0.0f) : data.Normals[n];
+	filled = noTexCoord || noNormal;
+	return true;
+}
+
+bool OBJImporter::ExpandVertices(const OBJData& data, std::vector<XMFLOAT3>& outVertices, std::vector<XMFLOAT2>& outTexCoords, std::vector<XMFLOAT3>& outNormals, size_t& filledCorners)
+{
+	filledCorners = 0;
+	size_t numIndices = data.VertexIndices.size();
+	outVertices.resize(numIndices);
+	outTexCoords.resize(numIndices);
+	outNormals.resize(numIndices);
+	for(size_t i = 0; i < numIndices; i++)
+	{
+		bool filled;
+		if (!GetCorner(data, i, outVertices[i], outTexCoords[i], outNormals[i], filled))
+		{
+			return false;
+		}
+		filledCorners += filled ? 1 : 0;
+	}
+	return true;
+}
+
+void OBJImporter::GroupByMaterial(const OBJData& data, const std::vector<unsigned int>& indices, std::vector<std::string>& materials, std::vector<std::vector<unsigned int>>& groups)
+{
+	materials.clear();
+	groups.clear();
+
+	//Each usemtl record applies up to the next one, and the faces before the first have no material
+	size_t useCount = data.MaterialUses.size();
+	for (size_t use = 0; use <= useCount; use++)
+	{
+		size_t start = use == 0 ? 0 : data.MaterialUses[use - 1].IndexStart;
+		size_t end = use == useCount ? indices.size() : data.MaterialUses[use].IndexStart;
+		end = std::min<size_t>(end, indices.size());
+		if (start >= end)
+		{
+			continue;
+		}
+
+		//Materials are usually used a handful of times at most, so a search is quicker than a map
+		const std::string& name = use == 0 ? std::string() : data.MaterialUses[use - 1].Name;
+		size_t group = std::find(materials.begin(), materials.end(), name) - materials.begin();
+		if (group == materials.size())
+		{
+			materials.push_back(name);
+			groups.emplace_back();
+		}
+		groups[group].insert(groups[group].end(), indices.begin() + start, indices.begin() + end);
+	}
+}
+
+//WARNING: This code expects your models to have texture coordinates AND normals, which they should have anyway (else you can't do texturing and lighting!)
+//A face corner without them gets zero ones, so the model loads but is drawn with one texel and unlit. If your .obj file has no lines beginning with "vt" or "vn",
+//then you'll need to change the Export settings in your modelling software so that it exports the texture coordinates and normals. If you still have no "vt" lines,
+//you'll need to do some texture unwrapping, also known as UV unwrapping.
+bool OBJImporter::Import(const std::string& filename, std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices, std::vector<Meshlet>& meshlets, std::vector<MeshLod>& lods, std::vector<Submesh>& submeshes, bool invertTexCoords, float overdrawThreshold)
+{
+	//DirectX uses 1 index buffer, OBJ is optimized for storage and not rendering and so uses 3 smaller index buffers.....great...
+	//We'll have to merge this into 1 index buffer which we'll do after loading in all of the required data.
+	OBJData data;
+	if(!OBJParser::ParseFile(filename, data, invertTexCoords))
+	{
+		return false;
+	}
+
+	//Get vectors to be of same size, ready for singular indexing
+	std::vector<XMFLOAT3> expandedVertices;
+	std::vector<XMFLOAT3> expandedNormals;
+	std::vector<XMFLOAT2> expandedTexCoords;
+	size_t filledCorners;
+	if (!ExpandVertices(data, expandedVertices, expandedTexCoords, expandedNormals, filledCorners))
+	{
+		char line[512];
+		snprintf(line, sizeof(line), "%s: a face uses a position, texture coordinate or normal that hasn't been defined\n", filename.c_str());
+		Report(line);
+		return false;
+	}
+	if (filledCorners > 0)
+	{
+		char line[512];
+		snprintf(line, sizeof(line), "%s: %zu face corners have no texture coordinate or normal, given zero ones\n", filename.c_str(), filledCorners);
+		Report(line);
+	}
+	unsigned int numIndices = data.VertexIndices.size();
+
+	//Now to (finally) form the final vertex, texture coord, normal list and single index buffer using the above expanded vectors
+	std::vector<unsigned int> meshIndices;
+	meshIndices.reserve(numIndices);
+	std::vector<XMFLOAT3> meshVertices;
+	meshVertices.reserve(expandedVertices.size());
+	std::vector<XMFLOAT3> meshNormals;
+	meshNormals.reserve(expandedNormals.size());
+	std::vector<XMFLOAT2> meshTexCoords;
+	meshTexCoords.reserve(expandedTexCoords.size());
+
+	CreateIndices(expandedVertices, expandedTexCoords, expandedNormals, meshIndices, meshVertices, meshTexCoords, meshNormals);
+	ReportWelding(filename, expandedVertices.size(), meshVertices.size(), meshIndices.size());
+
+	//Turn data from vector form to arrays
+	unsigned int numMeshVertices = meshVertices.size();
+	vertices.resize(numMeshVertices);
+	for(unsigned int i = 0; i < numMeshVertices; ++i)
+	{
+		vertices[i].Pos = meshVertices[i];
+		vertices[i].Normal = meshNormals[i];
+		vertices[i].TexCoord = meshTexCoords[i];
+	}
+
+	//Faces with the same material are drawn the same way wherever they are in the file, so each material's faces become one submesh, which the
+	//optimizations below work on separately so its triangles stay in one range of the index buffer
+	std::vector<std::string> materials;
+	std::vector<std::vector<unsigned int>> submeshIndices;
+	GroupByMaterial(data, meshIndices, materials, submeshIndices);
+
+	VertexCacheStatistics before = MeshOptimizer::AnalyzeVertexCache(meshIndices, numMeshVertices);
+	float overdrawBefore = MeshOptimizer::AnalyzeOverdraw(vertices, meshIndices);
+
+	indices.clear();
+	meshlets.clear();
+	lods.clear();
+	submeshes.clear();
+	std::vector<unsigned int> fullDetail;
+	fullDetail.reserve(meshIndices.size());
+	for(size_t s = 0; s < submeshIndices.size(); s++)
+	{
+		std::vector<unsigned int>& submeshTriangles = submeshIndices[s];
+
+		//The file's triangle order ignores the GPU's vertex cache, so reorder the triangles to reuse recently transformed vertices
+		std::vector<unsigned int> optimizedIndices = submeshTriangles;
+		MeshOptimizer::OptimizeVertexCache(optimizedIndices, numMeshVertices);
+
+		//Forsyth's LRU model doesn't always beat the file's order on the FIFO cache we measure with, so keep whichever is better
+		if(MeshOptimizer::AnalyzeVertexCache(optimizedIndices, numMeshVertices).ACMR < MeshOptimizer::AnalyzeVertexCache(submeshTriangles, numMeshVertices).ACMR)
+		{
+			submeshTriangles.swap(optimizedIndices);
+		}
+
+		//Then sort clusters of those triangles so the outside of the mesh is drawn first and hides the inside from the pixel shader,
+		//giving up a little of the cache reuse to do it
+		MeshOptimizer::OptimizeOverdraw(vertices, submeshTriangles, overdrawThreshold);
+
+		//Next group the triangles into meshlets, so the parts of the mesh that can't be seen can be skipped when it's drawn.
+		//That reorders the triangles again, for the cache within each meshlet and for overdraw between them
+		std::vector<Meshlet> submeshMeshlets;
+		Meshlets::Build(vertices, submeshTriangles, submeshMeshlets);
+
+		//Last, simplify the finished triangles into lower levels of detail. They only use vertices the full mesh does, so they're appended to the
+		//submesh's triangles and drawn from the same vertex buffer
+		std::vector<MeshLod> submeshLods;
+		Simplifier::BuildLods(vertices, submeshTriangles, submeshLods);
+
+		//Move everything along to where the submesh goes in the combined buffers
+		uint32_t indexStart = (uint32_t)indices.size();
+		Submesh submesh = {};
+		submesh.IndexStart = indexStart;
+		submesh.IndexCount = submeshLods[0].IndexCount;
+		submesh.MeshletStart = (uint32_t)meshlets.size();
+		submesh.MeshletCount = (uint32_t)submeshMeshlets.size();
+		submesh.LodStart = (uint32_t)lods.size();
+		submesh.LodCount = (uint32_t)submeshLods.size();
+		Bounds::MeasureSurface(vertices, submeshTriangles, 0, submesh.IndexCount, submesh.ModelArea, submesh.TexCoordArea);
+		submesh.SetMaterialName(materials[s]);
+		submeshes.push_back(submesh);
+
+		for(Meshlet& meshlet : submeshMeshlets)
+		{
+			meshlet.IndexStart += indexStart;
+			meshlets.push_back(meshlet);
+		}
+		for(MeshLod& lod : submeshLods)
+		{
+			lod.IndexStart += indexStart;
+			lods.push_back(lod);
+		}
+		fullDetail.insert(fullDetail.end(), submeshTriangles.begin(), submeshTriangles.begin() + submesh.IndexCount);
+		indices.insert(indices.end(), submeshTriangles.begin(), submeshTriangles.end());
+	}
+
+	ReportSubmeshes(filename, submeshes);
+	ReportMeshlets(filename, meshlets);
+	ReportVertexCache(filename, before, MeshOptimizer::AnalyzeVertexCache(fullDetail, numMeshVertices));
+	ReportOverdraw(filename, overdrawBefore, MeshOptimizer::AnalyzeOverdraw(vertices, fullDetail));
+	ReportLods(filename, lods, submeshes);
+
+	//Renumber the vertices so they're fetched in the order they're used. Each submesh's full detail triangles come before its levels, so they decide the order
+	MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+	return true;
+}
+
+bool OBJImporter::Cook(const std::string& filename, CookedMesh& mesh, bool invertTexCoords, VertexFormat format)
+{
+	if(!Import(filename, mesh.Vertices, mesh.Indices, mesh.Meshlets, mesh.Lods, mesh.Submeshes, invertTexCoords))
+	{
+		return false;
+	}
+
+	//Small meshes keep 16 bit indices, which halves the size of the index buffer. Only meshes with too many vertices for that use 32 bits
+	unsigned int numMeshVertices = mesh.Vertices.size();
+	unsigned int numMeshIndices = mesh.Indices.size();
+	uint32_t indexSize = ChooseIndexSize(numMeshVertices);
+	const void* indicesArray = mesh.Indices.data();
+	if(indexSize == sizeof(unsigned short))
+	{
+		mesh.ShortIndices.assign(mesh.Indices.begin(), mesh.Indices.end());
+		indicesArray = mesh.ShortIndices.data();
+	}
+
+	//Quantize the vertices if they're wanted compact. The shader turns the positions back into model space using the quantization
+	MeshBinaryContents& contents = mesh.Contents;
+	contents.Format = format;
+	contents.Quantization = VertexFormats::GetIdentityQuantization();
+	contents.Bounds = Bounds::Compute(mesh.Vertices);
+	contents.Vertices = mesh.Vertices.data();
+	contents.VertexCount = numMeshVertices;
+	contents.Indices = indicesArray;
+	contents.IndexCount = numMeshIndices;
+	contents.IndexSize = indexSize;
+	contents.Meshlets = mesh.Meshlets.data();
+	contents.MeshletCount = (uint32_t)mesh.Meshlets.size();
+	contents.Lods = mesh.Lods.data();
+	contents.LodCount = (uint32_t)mesh.Lods.size();
+	contents.Submeshes = mesh.Submeshes.data();
+	contents.SubmeshCount = (uint32_t)mesh.Submeshes.size();
+
+	if(format == VertexFormat::Compact)
+	{
+		VertexFormats::Compress(mesh.Vertices, mesh.CompactVertices, contents.Quantization);
+		ReportQuantization(filename, VertexFormats::MeasureError(mesh.Vertices, mesh.CompactVertices, contents.Quantization));
+		contents.Vertices = mesh.CompactVertices.data();
+	}
+	return true;
+}
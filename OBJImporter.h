@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>		//For storing the XMFLOAT3/2 variables
+
+#include "Vertices.h"
+#include "OBJParser.h"
+#include "Bounds.h"
+#include "MeshBinary.h"
+#include "MeshOptimizer.h"
+#include "Meshlets.h"
+#include "Simplifier.h"
+#include "Submesh.h"
+#include "VertexFormat.h"
+
+//A model that has been imported and converted to the format it's stored and drawn in, without touching the GPU.
+//Contents points into the vectors, so this can be moved but not copied
+struct CookedMesh
+{
+	std::vector<SimpleVertex> Vertices;
+	//Only filled in for VertexFormat::Compact
+	std::vector<CompactVertex> CompactVertices;
+	std::vector<unsigned int> Indices;
+	//Only filled in for 16 bit indices
+	std::vector<unsigned short> ShortIndices;
+	std::vector<Meshlet> Meshlets;
+	std::vector<MeshLod> Lods;
+	std::vector<Submesh> Submeshes;
+	//What gets written to the binary mesh and uploaded to the GPU
+	MeshBinaryContents Contents;
+
+	CookedMesh() = default;
+	CookedMesh(CookedMesh&&) = default;
+	CookedMesh& operator=(CookedMesh&&) = default;
+	CookedMesh(const CookedMesh&) = delete;
+	CookedMesh& operator=(const CookedMesh&) = delete;
+};
+
+//Everything that turns an .obj file into a binary mesh without touching the GPU, so it builds on its own for the asset cooker as well as the game
+namespace OBJImporter
+{
+	//Where the binary version of an .obj file is cached, next to it
+	std::string GetBinaryFilename(const std::string& filename);
+
+	//Imports an .obj file and converts it to format, with the smallest index size that can address every vertex. Returns false if the file couldn't be read
+	bool Cook(const std::string& filename, CookedMesh& mesh, bool invertTexCoords = true, VertexFormat format = VertexFormat::Compact);
+
+	//Parses an .obj file into a single welded, cache and overdraw optimized vertex and index buffer, without touching the GPU. Returns false if the file couldn't be read.
+	//The faces are grouped into one submesh per material, each a range of the index buffer followed by its simplified levels of detail, and split into meshlets
+	//which it's ordered to match. overdrawThreshold is how much worse the vertex cache may get to reduce overdraw, see MeshOptimizer::OptimizeOverdraw
+	bool Import(const std::string& filename, std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices, std::vector<Meshlet>& meshlets, std::vector<MeshLod>& lods, std::vector<Submesh>& submeshes, bool invertTexCoords = true, float overdrawThreshold = MeshOptimizer::DefaultOverdrawThreshold);
+
+	//Looks up the position, texture coordinate and normal of a face corner. A corner without a texture coordinate or normal, as in "f 1//1" or a file
+	//with no vt or vn lines, gets zero ones and sets filled. Returns false if it uses anything else that hasn't been defined, which a corrupt file could
+	bool GetCorner(const OBJData& data, size_t corner, XMFLOAT3& position, XMFLOAT2& texCoord, XMFLOAT3& normal, bool& filled);
+
+	//Looks up the position, texture coordinate and normal of every face corner in the OBJ file with GetCorner, so all three have one entry per corner.
+	//Returns false if a corner uses something that hasn't been defined. filledCorners is how many had no texture coordinate or normal
+	bool ExpandVertices(const OBJData& data, std::vector<XMFLOAT3>& outVertices, std::vector<XMFLOAT2>& outTexCoords, std::vector<XMFLOAT3>& outNormals, size_t& filledCorners);
+
+	//Splits the triangles of indices, one per face of the OBJ file in file order, into one list per material in the order the materials are first used.
+	//Faces before the first usemtl record have no material, so get the name ""
+	void GroupByMaterial(const OBJData& data, const std::vector<unsigned int>& indices, std::vector<std::string>& materials, std::vector<std::vector<unsigned int>>& groups);
+
+	//Re-creates a single index buffer from the 3 given in the OBJ file, re-using the index of any vertex that has been seen before
+	void CreateIndices(const std::vector<XMFLOAT3>& inVertices, const std::vector<XMFLOAT2>& inTexCoords, const std::vector<XMFLOAT3>& inNormals, std::vector<unsigned int>& outIndices, std::vector<XMFLOAT3>& outVertices, std::vector<XMFLOAT2>& outTexCoords, std::vector<XMFLOAT3>& outNormals);
+
+	//Writes how many vertices welding removed, and what that saves in the vertex and index buffers, to the debug output
+	void ReportWelding(const std::string& filename, size_t verticesBefore, size_t verticesAfter, size_t indexCount);
+
+	//Writes the simulated vertex cache miss ratios before and after the triangles were reordered to the debug output
+	void ReportVertexCache(const std::string& filename, const VertexCacheStatistics& before, const VertexCacheStatistics& after);
+
+	//Writes the simulated overdraw before and after the triangle clusters were sorted to the debug output
+	void ReportOverdraw(const std::string& filename, float before, float after);
+
+	//4 bytes per index if 16 bits can't address every vertex, otherwise 2
+	uint32_t ChooseIndexSize(size_t vertexCount);
+
+	//Writes how far compact vertices are from the float ones they were made from to the debug output
+	void ReportQuantization(const std::string& filename, const VertexQuantizationError& error);
+
+	//Writes how many meshlets the mesh was split into, how full they are and how many can be back-face culled to the debug output
+	void ReportMeshlets(const std::string& filename, const std::vector<Meshlet>& meshlets);
+
+	//Writes which material each submesh uses and how many triangles it has to the debug output
+	void ReportSubmeshes(const std::string& filename, const std::vector<Submesh>& submeshes);
+
+	//Writes how many triangles each submesh's levels of detail kept and how far they are from its full detail triangles to the debug output
+	void ReportLods(const std::string& filename, const std::vector<MeshLod>& lods, const std::vector<Submesh>& submeshes);
+};
@@ -1,33 +1,66 @@
-#pragma once
-#include <windows.h>
-#include <d3d11_1.h>
-#include <directxmath.h>
-#include <fstream>		//For loading in an external file
-#include <vector>		//For storing the XMFLOAT3/2 variables
-#include <map>			//For fast searching when re-creating the index buffer
-
-#include "Vertices.h"
-
-using namespace DirectX;
-
-struct MeshData
-{
-	ID3D11Buffer * VertexBuffer;
-	ID3D11Buffer * IndexBuffer;
-	UINT VBStride;
-	UINT VBOffset;
-	UINT IndexCount;
-};
-
-namespace OBJLoader
-{
-	//The only method you'll need to call
-	MeshData Load(std::string filename, ID3D11Device* _pd3dDevice, bool invertTexCoords = true);
-
-	//Helper methods for the above method
-	//Searhes to see if a similar vertex already exists in the buffer -- if true, we re-use that index
-	bool FindSimilarVertex(const SimpleVertex& vertex, std::map<SimpleVertex, unsigned short>& vertToIndexMap, unsigned short& index);
-
-	//Re-creates a single index buffer from the 3 given in the OBJ file
-	void CreateIndices(const std::vector<XMFLOAT3>& inVertices, const std::vector<XMFLOAT2>& inTexCoords, const std::vector<XMFLOAT3>& inNormals, std::vector<unsigned short>& outIndices, std::vector<XMFLOAT3>& outVertices, std::vector<XMFLOAT2>& outTexCoords, std::vector<XMFLOAT3>& outNormals);
+#pragma once
+#include <windows.h>
+#include <d3d11_1.h>
+#include <directxmath.h>
+#include <fstream>		//For loading in an external file
+#include <vector>		//For storing the XMFLOAT3/2 variables
+
+#include "Vertices.h"
+#include "GeometryPool.h"
+#include "OBJImporter.h"
+#include "OBJStreamImporter.h"
+
+using namespace DirectX;
+
+struct MeshData
+{
+	/// <summary>The mesh's own buffers, or null if its vertices and indices are in Pool</summary>
+	ID3D11Buffer * VertexBuffer;
+	ID3D11Buffer * IndexBuffer;
+	UINT VBStride;
+	UINT VBOffset;
+	UINT VertexCount;
+	/// <summary>Every index in the index buffer, across all of the levels of detail</summary>
+	UINT IndexCount;
+	/// <summary>DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT, whichever the index buffer was created with</summary>
+	DXGI_FORMAT IndexFormat;
+	/// <summary>The format of the vertex buffer, which decides the shader and input layout to draw with</summary>
+	VertexFormat Format;
+	/// <summary>What the vertex shader needs to turn compact positions back into model space</summary>
+	VertexQuantization Quantization;
+	/// <summary>The box and sphere around the mesh in model space, so it can be culled and measured without reading its vertices back</summary>
+	MeshBounds Bounds;
+	/// <summary>The levels of detail, each a range of the index buffer. Each submesh has its own from its full detail triangles down. Empty if the mesh failed to load</summary>
+	std::vector<MeshLod> Lods;
+	/// <summary>Clusters of the full detail level that can be culled and drawn on their own, in index buffer order</summary>
+	std::vector<Meshlet> Meshlets;
+	/// <summary>The parts of the mesh drawn with each of its materials, each with its own range of the indices, meshlets and levels of detail</summary>
+	std::vector<Submesh> Submeshes;
+	/// <summary>The pool the vertices and indices were put in, or null if the mesh has buffers of its own</summary>
+	GeometryPool* Pool;
+	/// <summary>Where in Pool they are. Every index range above is from the start of the mesh's indices, and every index from its first vertex,
+	/// so drawing adds Pool's start index and base vertex</summary>
+	GeometryRange Geometry;
+};
+
+namespace OBJLoader
+{
+	//The only method you'll need to call. Compact vertices are half the size of float ones, see VertexFormat.
+	//The binary cache is written raw by default, so it loads straight from its mapping. AssetCooker --compress writes compressed caches
+	//for slow disks, which load the same way once decoded, see MeshEncoding.
+	//Files of OBJStreamImporter::StreamingThreshold or more are streamed into a raw cache within a fixed memory budget instead, see OBJStreamImporter.
+	//Given a pool, the mesh is put in it rather than in buffers of its own, unless the pool can't grow to fit it
+	MeshData Load(std::string filename, ID3D11Device* _pd3dDevice, bool invertTexCoords = true, VertexFormat format = VertexFormat::Compact, MeshEncoding encoding = MeshEncoding::Raw, GeometryPool* pool = nullptr);
+
+	//Helper methods for the above method. Importing the .obj file itself is done by OBJImporter, see there
+	//Picks 16 bit indices if they can address every vertex, and 32 bit ones if they can't
+	DXGI_FORMAT ChooseIndexFormat(size_t vertexCount);
+	//The size of one index in bytes
+	UINT GetIndexSize(DXGI_FORMAT indexFormat);
+
+	//Creates the vertex and index buffers on the GPU, or adds them to pool if there is one. vertices must already be in vertexFormat, and indices in indexFormat
+	MeshData CreateMeshData(ID3D11Device* _pd3dDevice, VertexFormat vertexFormat, const VertexQuantization& quantization, const void* vertices, UINT numVertices, const void* indices, UINT numIndices, DXGI_FORMAT indexFormat, GeometryPool* pool = nullptr);
+
+	//Loads a mesh previously written out by Load. Returns false if the file is missing, isn't a valid binary mesh, isn't in format, or is older than sourceFilename
+	bool LoadBinary(const std::string& binaryFilename, const std::string& sourceFilename, VertexFormat format, ID3D11Device* _pd3dDevice, MeshData& meshData, GeometryPool* pool = nullptr);
 };
\ No newline at end of file
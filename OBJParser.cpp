@@ -0,0 +1,392 @@
+#include "OBJParser.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <charconv>		//For std::from_chars, which parses numbers in place without locales or allocation
+#include <chrono>		//For timing the benchmark
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	inline bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	inline const char* SkipSpaces(const char* p, const char* end)
+	{
+		while (p < end && IsSpace(*p)) ++p;
+		return p;
+	}
+
+	//Returns the start of the next line
+	inline const char* SkipLine(const char* p, const char* end)
+	{
+		const char* newline = (const char*)memchr(p, '\n', end - p);
+		return newline ? newline + 1 : end;
+	}
+
+	inline const char* ParseFloat(const char* p, const char* end, float& value)
+	{
+		p = SkipSpaces(p, end);
+		if (p < end && *p == '+') ++p;	//from_chars doesn't accept a leading '+', stream extraction does
+		return std::from_chars(p, end, value).ptr;	//On failure, ptr is left at p and value is untouched
+	}
+
+	inline const char* ParseIndex(const char* p, const char* end, int& value)
+	{
+		if (p < end && *p == '+') ++p;
+		value = 0;	//atoi("") is 0, keep that behaviour for empty fields such as the middle of "1//1"
+		return std::from_chars(p, end, value).ptr;
+	}
+
+	//Parses a single "v/vt/vn" face corner. Mirrors what the substr/atoi version did with missing slashes, so that
+	//"1" and "1/2" still produce the same indices as they always have
+	inline const char* ParseCorner(const char* p, const char* end, int& v, int& t, int& n)
+	{
+		p = SkipSpaces(p, end);
+		p = ParseIndex(p, end, v);
+		t = v;
+		n = v;
+		if (p < end && *p == '/')
+		{
+			p = ParseIndex(p + 1, end, t);
+			if (p < end && *p == '/')
+			{
+				p = ParseIndex(p + 1, end, n);
+			}
+		}
+		//Skip anything left in this token
+		while (p < end && !IsSpace(*p) && *p != '\n') ++p;
+		return p;
+	}
+}
+
+bool OBJParser::ParseFile(const std::string& filename, OBJData& data, bool invertTexCoords, unsigned int threadCount)
+{
+	MappedFile file(filename);
+	if (!file.IsOpen())
+	{
+		return false;
+	}
+
+	if (threadCount == 1)
+	{
+		Parse(file.GetData(), file.GetEnd(), data, invertTexCoords);
+	}
+	else
+	{
+		ParseParallel(file.GetData(), file.GetEnd(), data, invertTexCoords, threadCount);
+	}
+	return true;
+}
+
+void OBJParser::Parse(const char* begin, const char* end, OBJData& data, bool invertTexCoords)
+{
+	const char* p = begin;
+	while (p < end) //One record per line
+	{
+		p = SkipSpaces(p, end);
+		if (p == end) break;
+
+		//Find the end of the keyword
+		const char* keyword = p;
+		while (p < end && !IsSpace(*p) && *p != '\n') ++p;
+		size_t length = p - keyword;
+
+		if (keyword[0] == 'v' && length == 1) //Vertex position
+		{
+			XMFLOAT3 vert = XMFLOAT3(0.0f, 0.0f, 0.0f);
+			p = ParseFloat(p, end, vert.x);
+			p = ParseFloat(p, end, vert.y);
+			p = ParseFloat(p, end, vert.z);
+
+			data.Vertices.push_back(vert);
+		}
+		else if (keyword[0] == 'v' && length == 2 && keyword[1] == 't') //Texture coordinate
+		{
+			XMFLOAT2 texCoord = XMFLOAT2(0.0f, 0.0f);
+			p = ParseFloat(p, end, texCoord.x);
+			p = ParseFloat(p, end, texCoord.y);
+
+			if (invertTexCoords) texCoord.y = 1.0f - texCoord.y;
+
+			data.TexCoords.push_back(texCoord);
+		}
+		else if (keyword[0] == 'v' && length == 2 && keyword[1] == 'n') //Normal
+		{
+			XMFLOAT3 normal = XMFLOAT3(0.0f, 0.0f, 0.0f);
+			p = ParseFloat(p, end, normal.x);
+			p = ParseFloat(p, end, normal.y);
+			p = ParseFloat(p, end, normal.z);
+
+			data.Normals.push_back(normal);
+		}
+		else if (keyword[0] == 'f' && length == 1) //Face
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				int v, t, n;
+				p = ParseCorner(p, end, v, t, n);
+
+				//Minus 1 from each as OBJ indexes start from 1
+				data.VertexIndices.push_back((unsigned int)(v - 1));
+				data.TexCoordIndices.push_back((unsigned int)(t - 1));
+				data.NormalIndices.push_back((unsigned int)(n - 1));
+			}
+		}
+		else if (length == 6 && memcmp(keyword, "usemtl", 6) == 0) //Material
+		{
+			p = SkipSpaces(p, end);
+			const char* name = p;
+			while (p < end && !IsSpace(*p) && *p != '\n') ++p;
+
+			data.MaterialUses.push_back({ (unsigned int)data.VertexIndices.size(), std::string(name, p) });
+		}
+
+		//Ignore the rest of the line, this skips comments, groups, material libraries and any fourth component
+		p = SkipLine(p, end);
+	}
+}
+
+namespace
+{
+	//Below this, the cost of handing a chunk to another thread outweighs parsing it
+	const size_t MinimumChunkSize = 64 * 1024;
+
+	//Appends each chunk's vector to the end of the combined one. The sizes are prefix-summed first so the destination is only
+	//resized once, then every chunk copies into its own slice in parallel
+	template <typename T>
+	void Concatenate(std::vector<OBJData>& chunks, std::vector<T> OBJData::* member, std::vector<T>& out)
+	{
+		std::vector<size_t> offsets(chunks.size() + 1);
+		offsets[0] = out.size();
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			offsets[i + 1] = offsets[i] + (chunks[i].*member).size();
+		}
+
+		out.resize(offsets[chunks.size()]);
+		ThreadPool::GetShared().ParallelFor(chunks.size(), [&](size_t i)
+		{
+			const std::vector<T>& chunk = chunks[i].*member;
+			if (!chunk.empty())
+			{
+				memcpy(out.data() + offsets[i], chunk.data(), sizeof(T) * chunk.size());
+			}
+		});
+	}
+}
+
+void OBJParser::ParseParallel(const char* begin, const char* end, OBJData& data, bool invertTexCoords, unsigned int threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = ThreadPool::GetShared().GetThreadCount();
+	}
+
+	size_t size = end - begin;
+	size_t chunkCount = size / MinimumChunkSize;
+	if (chunkCount > threadCount) chunkCount = threadCount;
+	if (chunkCount <= 1)
+	{
+		Parse(begin, end, data, invertTexCoords);
+		return;
+	}
+
+	//Cut roughly equal chunks, moving each cut forward to just after the next newline so no record is split between two chunks
+	std::vector<const char*> cuts;
+	cuts.push_back(begin);
+	for (size_t i = 1; i < chunkCount; i++)
+	{
+		const char* cut = begin + size * i / chunkCount;
+		if (cut < cuts.back()) cut = cuts.back();
+		cuts.push_back(SkipLine(cut, end));
+	}
+	cuts.push_back(end);
+
+	std::vector<OBJData> chunks(chunkCount);
+	ThreadPool::GetShared().ParallelFor(chunkCount, [&](size_t i)
+	{
+		Parse(cuts[i], cuts[i + 1], chunks[i], invertTexCoords);
+	});
+
+	Concatenate(chunks, &OBJData::Vertices, data.Vertices);
+	Concatenate(chunks, &OBJData::Normals, data.Normals);
+	Concatenate(chunks, &OBJData::TexCoords, data.TexCoords);
+	Concatenate(chunks, &OBJData::VertexIndices, data.VertexIndices);
+	Concatenate(chunks, &OBJData::TexCoordIndices, data.TexCoordIndices);
+	Concatenate(chunks, &OBJData::NormalIndices, data.NormalIndices);
+
+	//Each chunk counted its face corners from 0, so its materials start after every corner in the chunks before it
+	unsigned int indexOffset = 0;
+	for (OBJData& chunk : chunks)
+	{
+		for (OBJMaterialUse& use : chunk.MaterialUses)
+		{
+			use.IndexStart += indexOffset;
+			data.MaterialUses.push_back(std::move(use));
+		}
+		indexOffset += (unsigned int)chunk.VertexIndices.size();
+	}
+}
+
+void OBJParser::ParseStream(std::istream& inFile, OBJData& data, bool invertTexCoords)
+{
+	std::string input;
+
+	XMFLOAT3 vert;
+	XMFLOAT2 texCoord;
+	XMFLOAT3 normal;
+	unsigned int vInd[3]; //indices for the vertex position
+	unsigned int tInd[3]; //indices for the texture coordinate
+	unsigned int nInd[3]; //indices for the normal
+	std::string beforeFirstSlash;
+	std::string afterFirstSlash;
+	std::string afterSecondSlash;
+
+	while(!inFile.eof()) //While we have yet to reach the end of the file...
+	{
+		inFile >> input; //Get the next input from the file
+
+		//Check what type of input it was, we are only interested in vertex positions, texture coordinates, normals and indices, nothing else
+		if(input.compare("v") == 0) //Vertex position
+		{
+			inFile >> vert.x;
+			inFile >> vert.y;
+			inFile >> vert.z;
+
+			data.Vertices.push_back(vert);
+		}
+		else if(input.compare("vt") == 0) //Texture coordinate
+		{
+			inFile >> texCoord.x;
+			inFile >> texCoord.y;
+
+			if(invertTexCoords) texCoord.y = 1.0f - texCoord.y;
+
+			data.TexCoords.push_back(texCoord);
+		}
+		else if(input.compare("vn") == 0) //Normal
+		{
+			inFile >> normal.x;
+			inFile >> normal.y;
+			inFile >> normal.z;
+
+			data.Normals.push_back(normal);
+		}
+		else if(input.compare("f") == 0) //Face
+		{
+			for(int i = 0; i < 3; ++i)
+			{
+				inFile >> input;
+				int slash = input.find("/"); //Find first forward slash
+				int secondSlash = input.find("/", slash + 1); //Find second forward slash
+
+				//Extract from string
+				beforeFirstSlash = input.substr(0, slash); //The vertex position index
+				afterFirstSlash = input.substr(slash + 1, secondSlash - slash - 1); //The texture coordinate index
+				afterSecondSlash = input.substr(secondSlash + 1); //The normal index
+
+				//Parse into int
+				vInd[i] = (unsigned int)atoi(beforeFirstSlash.c_str()); //atoi = "ASCII to int"
+				tInd[i] = (unsigned int)atoi(afterFirstSlash.c_str());
+				nInd[i] = (unsigned int)atoi(afterSecondSlash.c_str());
+			}
+
+			//Place into vectors
+			for(int i = 0; i < 3; ++i)
+			{
+				data.VertexIndices.push_back(vInd[i] - 1);		//Minus 1 from each as these as OBJ indexes start from 1 whereas C++ arrays start from 0
+				data.TexCoordIndices.push_back(tInd[i] - 1);	//which is really annoying. Apart from Lua and SQL, there's not much else that has indexing
+				data.NormalIndices.push_back(nInd[i] - 1);		//starting at 1. So many more languages index from 0, the .OBJ people screwed up there.
+			}
+		}
+		else if(input.compare("usemtl") == 0) //Material, which applies to every face from here on
+		{
+			inFile >> input;
+			data.MaterialUses.push_back({ (unsigned int)data.VertexIndices.size(), input });
+		}
+	}
+}
+
+namespace
+{
+	template <typename T>
+	bool EqualBytes(const std::vector<T>& a, const std::vector<T>& b)
+	{
+		return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), sizeof(T) * a.size()) == 0);
+	}
+}
+
+bool OBJParser::Equal(const OBJData& a, const OBJData& b)
+{
+	return EqualBytes(a.Vertices, b.Vertices)
+		&& EqualBytes(a.Normals, b.Normals)
+		&& EqualBytes(a.TexCoords, b.TexCoords)
+		&& EqualBytes(a.VertexIndices, b.VertexIndices)
+		&& EqualBytes(a.TexCoordIndices, b.TexCoordIndices)
+		&& EqualBytes(a.NormalIndices, b.NormalIndices)
+		&& a.MaterialUses.size() == b.MaterialUses.size()
+		&& std::equal(a.MaterialUses.begin(), a.MaterialUses.end(), b.MaterialUses.begin(), [](const OBJMaterialUse& x, const OBJMaterialUse& y)
+		{
+			return x.IndexStart == y.IndexStart && x.Name == y.Name;
+		});
+}
+
+OBJParserBenchmark OBJParser::Benchmark(const std::string& filename, int iterations)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	OBJParserBenchmark result = {};
+	OBJData streamData;
+	OBJData mappedData;
+	OBJData parallelData;
+	double bestStream = 0.0;
+	double bestMapped = 0.0;
+	double bestParallel = 0.0;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		OBJData data;
+		Clock::time_point start = Clock::now();
+		std::ifstream inFile(filename);
+		ParseStream(inFile, data, true);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		if (i == 0 || seconds < bestStream) bestStream = seconds;
+		if (i == 0) streamData = data;
+	}
+
+	for (int i = 0; i < iterations; i++)
+	{
+		OBJData data;
+		Clock::time_point start = Clock::now();
+		ParseFile(filename, data, true, 1);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		if (i == 0 || seconds < bestMapped) bestMapped = seconds;
+		if (i == 0) mappedData = data;
+	}
+
+	for (int i = 0; i < iterations; i++)
+	{
+		OBJData data;
+		Clock::time_point start = Clock::now();
+		ParseFile(filename, data, true, 0);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		if (i == 0 || seconds < bestParallel) bestParallel = seconds;
+		if (i == 0) parallelData = data;
+	}
+
+	MappedFile file(filename);
+	result.FileSize = file.GetSize();
+	double megabytes = result.FileSize / (1024.0 * 1024.0);
+	result.StreamMBps = bestStream > 0.0 ? megabytes / bestStream : 0.0;
+	result.MappedMBps = bestMapped > 0.0 ? megabytes / bestMapped : 0.0;
+	result.ParallelMBps = bestParallel > 0.0 ? megabytes / bestParallel : 0.0;
+	result.Threads = ThreadPool::GetShared().GetThreadCount();
+	result.Identical = Equal(streamData, mappedData) && Equal(mappedData, parallelData);
+	return result;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <DirectXMath.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+using namespace DirectX;
+
+/// <summary>A usemtl record, which gives every face after it a material until the next one</summary>
+struct OBJMaterialUse
+{
+	/// <summary>How many entries the index lists had when the record was read, so the first face corner it applies to</summary>
+	unsigned int IndexStart;
+	std::string Name;
+};
+
+/// <summary><para>The contents of an .obj file exactly as it lays them out: </para>
+/// <para>  -   one pool each of positions, normals and texture coordinates</para>
+/// <para>  -   one index list per pool, three entries per face, already converted to start from 0</para>
+/// <para>  -   the usemtl records, in file order. o and g records only name parts of the model without changing how they're drawn, so are skipped</para>
+/// </summary>
+struct OBJData
+{
+	std::vector<XMFLOAT3> Vertices;
+	std::vector<XMFLOAT3> Normals;
+	std::vector<XMFLOAT2> TexCoords;
+
+	std::vector<unsigned int> VertexIndices;
+	std::vector<unsigned int> TexCoordIndices;
+	std::vector<unsigned int> NormalIndices;
+
+	std::vector<OBJMaterialUse> MaterialUses;
+};
+
+/// <summary>Timings of the two text parsers over the same file</summary>
+struct OBJParserBenchmark
+{
+	/// <summary>The size of the file that was parsed, in bytes</summary>
+	size_t FileSize;
+	/// <summary>Throughput of ParseStream (std::ifstream extraction), in MB/s</summary>
+	double StreamMBps;
+	/// <summary>Throughput of ParseFile on one thread (mapped, in-place scanning), in MB/s</summary>
+	double MappedMBps;
+	/// <summary>Throughput of ParseFile split across the shared thread pool, in MB/s</summary>
+	double ParallelMBps;
+	/// <summary>How many threads the parallel parse could use</summary>
+	unsigned int Threads;
+	/// <summary>Whether every parser produced exactly the same OBJData</summary>
+	bool Identical;
+};
+
+namespace OBJParser
+{
+	/// <summary>Maps an .obj file into memory and parses it in place. This is what OBJLoader::Load uses</summary>
+	/// <param name="filename">The .obj file to parse</param>
+	/// <param name="data">Filled with the records found in the file</param>
+	/// <param name="invertTexCoords">Flips the v texture coordinate, as DirectX's origin is at the top left</param>
+	/// <param name="threadCount">How many threads to parse with. 0 uses the shared thread pool, 1 parses on the calling thread only</param>
+	/// <returns>false if the file could not be opened</returns>
+	bool ParseFile(const std::string& filename, OBJData& data, bool invertTexCoords = true, unsigned int threadCount = 0);
+
+	/// <summary>Parses the v, vt, vn, f and usemtl records in [begin, end) without copying or allocating per token. Everything else is skipped a line at a time</summary>
+	void Parse(const char* begin, const char* end, OBJData& data, bool invertTexCoords = true);
+
+	/// <summary><para>Splits [begin, end) into chunks at line boundaries, parses the chunks in parallel on the shared thread pool, then
+	/// concatenates them in file order. </para>
+	/// <para>Every record is self-contained, face indices are absolute and usemtl records are kept where they are rather than applied, so the result is identical to Parse.
+	/// Files too small to be worth splitting are parsed on the calling thread.</para></summary>
+	/// <param name="threadCount">The most chunks to split the file into. 0 uses one per thread in the shared pool</param>
+	void ParseParallel(const char* begin, const char* end, OBJData& data, bool invertTexCoords = true, unsigned int threadCount = 0);
+
+	/// <summary>The original token-by-token std::istream parser. Slow, but kept as the reference that Parse is measured and checked against</summary>
+	void ParseStream(std::istream& inFile, OBJData& data, bool invertTexCoords = true);
+
+	/// <summary>Returns true if both sets of data are bit-for-bit the same</summary>
+	bool Equal(const OBJData& a, const OBJData& b);
+
+	/// <summary>Parses the same file with ParseStream, and with ParseFile on one and on all threads, and reports their throughput</summary>
+	/// <param name="iterations">How many times to parse the file with each parser. The fastest run of each is kept</param>
+	OBJParserBenchmark Benchmark(const std::string& filename, int iterations = 5);
+};
@@ -0,0 +1,591 @@
+#include "OBJStreamImporter.h"
+#include "Bounds.h"
+#include "MeshBinary.h"
+#include "MeshOptimizer.h"
+#include "Meshlets.h"
+#include "OBJImporter.h"
+#include "OBJParser.h"
+#include "Simplifier.h"
+#include "Submesh.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace
+{
+	//The read buffer is a sixteenth of the budget, within these. A line longer than the buffer can't be parsed, so it can't be too small
+	const size_t MinimumBufferSize = 64 * 1024;
+	const size_t MaximumBufferSize = 4 * 1024 * 1024;
+
+	//Kept back from the budget for the submeshes, the temporary files' stream buffers and everything else that doesn't grow with the file
+	const size_t FixedBytes = 1024 * 1024;
+
+	//Reports go to the debugger's output on Windows. Elsewhere the importer runs in the asset cooker, which keeps stdout for its own table
+	void Report(const char* line)
+	{
+#ifdef _WIN32
+		OutputDebugStringA(line);
+#else
+		fputs(line, stderr);
+#endif
+	}
+
+	enum class LineType
+	{
+		Position,
+		TexCoord,
+		Normal,
+		Face,
+		Other,
+	};
+
+	//What the line starting at p holds, read the same way OBJParser::Parse reads it, so the counts match what Parse adds
+	LineType GetLineType(const char* p, const char* end)
+	{
+		while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+		const char* keyword = p;
+		while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') ++p;
+		size_t length = p - keyword;
+
+		if (length == 1 && keyword[0] == 'v') return LineType::Position;
+		if (length == 1 && keyword[0] == 'f') return LineType::Face;
+		if (length == 2 && keyword[0] == 'v' && keyword[1] == 't') return LineType::TexCoord;
+		if (length == 2 && keyword[0] == 'v' && keyword[1] == 'n') return LineType::Normal;
+		return LineType::Other;
+	}
+
+	inline const char* NextLine(const char* p, const char* end)
+	{
+		const char* newline = (const char*)memchr(p, '\n', end - p);
+		return newline ? newline + 1 : end;
+	}
+
+	//Reads a file through a fixed buffer, handing out only whole lines. Whatever follows the last newline in the buffer is kept for the next block
+	struct BlockReader
+	{
+		FILE* File;
+		std::vector<char> Buffer;
+		//The part of the buffer that hasn't been handed out
+		size_t Start;
+		size_t End;
+		bool AtEnd;
+	};
+
+	bool OpenReader(BlockReader& reader, const std::string& filename, size_t bufferSize)
+	{
+		reader.File = fopen(filename.c_str(), "rb");
+		reader.Buffer.resize(bufferSize);
+		reader.Start = 0;
+		reader.End = 0;
+		reader.AtEnd = false;
+		return reader.File != nullptr;
+	}
+
+	void CloseReader(BlockReader& reader)
+	{
+		if (reader.File != nullptr)
+		{
+			fclose(reader.File);
+			reader.File = nullptr;
+		}
+	}
+
+	//Fills the buffer up after what's left of the last block, and points [begin, end) at every whole line in it. hasher, if there is one, is given every byte read.
+	//Returns false at the end of the file, or if a line is too long for the buffer, which tooLong is set for
+	bool ReadBlock(BlockReader& reader, const char*& begin, const char*& end, MeshHasher* hasher, bool& tooLong)
+	{
+		tooLong = false;
+		size_t left = reader.End - reader.Start;
+		memmove(reader.Buffer.data(), reader.Buffer.data() + reader.Start, left);
+		reader.Start = 0;
+		reader.End = left;
+		if (!reader.AtEnd)
+		{
+			size_t read = fread(reader.Buffer.data() + left, 1, reader.Buffer.size() - left, reader.File);
+			if (hasher != nullptr)
+			{
+				hasher->Add(reader.Buffer.data() + left, read);
+			}
+			reader.End += read;
+			reader.AtEnd = reader.End < reader.Buffer.size();
+		}
+		if (reader.End == 0)
+		{
+			return false;
+		}
+
+		//The last line of the file needn't end in a newline, but any other block has to hold at least one whole line
+		begin = reader.Buffer.data();
+		end = begin + reader.End;
+		if (!reader.AtEnd)
+		{
+			const char* last = begin + reader.End;
+			while (last > begin && last[-1] != '\n') --last;
+			if (last == begin)
+			{
+				tooLong = true;
+				return false;
+			}
+			end = last;
+		}
+		reader.Start = end - begin;
+		return true;
+	}
+
+	//Everything that carries over from one window to the next. The window's vectors are kept so each window reuses the last one's memory
+	struct StreamState
+	{
+		std::string Filename;
+		std::ofstream Vertices;
+		std::ofstream Indices;
+		std::ofstream Meshlets;
+		uint64_t VertexCount;
+		uint64_t IndexCount;
+		uint64_t MeshletCount;
+		uint32_t WindowCount;
+		//Face corners with no texture coordinate or normal, given zero ones
+		uint64_t FilledCorners;
+		std::vector<Submesh> Submeshes;
+		//The material of the last face of the last window, which the next window's faces keep until they reach a usemtl record
+		std::string Material;
+
+		VertexWelder Welder;
+		std::vector<SimpleVertex> WindowVertices;
+		std::vector<unsigned int> WindowIndices;
+		std::vector<unsigned int> Ordered;
+		std::vector<unsigned int> Segment;
+		std::vector<unsigned int> Optimized;
+		std::vector<Meshlet> SegmentMeshlets;
+
+		StreamState(size_t windowFaces) : VertexCount(0), IndexCount(0), MeshletCount(0), WindowCount(0), FilledCorners(0), Welder(windowFaces * 3)
+		{
+		}
+	};
+
+	void AddToSubmesh(StreamState& state, const std::string& material, uint64_t indexStart, size_t indexCount, size_t meshletCount, float modelArea, float texCoordArea)
+	{
+		Submesh submesh = {};
+		submesh.SetMaterialName(material);
+
+		//Consecutive runs with the same material, like the same material carried across two windows, are one submesh
+		if (!state.Submeshes.empty())
+		{
+			Submesh& last = state.Submeshes.back();
+			if (memcmp(last.MaterialName, submesh.MaterialName, sizeof(submesh.MaterialName)) == 0 && last.IndexStart + (uint64_t)last.IndexCount == indexStart)
+			{
+				last.IndexCount += (uint32_t)indexCount;
+				last.MeshletCount += (uint32_t)meshletCount;
+				last.ModelArea += modelArea;
+				last.TexCoordArea += texCoordArea;
+				return;
+			}
+		}
+
+		submesh.IndexStart = (uint32_t)indexStart;
+		submesh.IndexCount = (uint32_t)indexCount;
+		submesh.MeshletStart = (uint32_t)(state.MeshletCount - meshletCount);
+		submesh.MeshletCount = (uint32_t)meshletCount;
+		submesh.ModelArea = modelArea;
+		submesh.TexCoordArea = texCoordArea;
+		state.Submeshes.push_back(submesh);
+	}
+
+	template <typename T>
+	void Append(std::ofstream& out, const std::vector<T>& items)
+	{
+		if (!items.empty())
+		{
+			out.write((const char*)items.data(), sizeof(T) * items.size());
+		}
+	}
+
+	//Welds, optimizes and splits up the faces read since the last window, appends the results to the temporary files, and empties data's index lists and
+	//material uses for the next window. Returns false if a face uses something that isn't in the pools, or the mesh has outgrown 32 bit indices
+	bool FlushWindow(StreamState& state, OBJData& data)
+	{
+		size_t cornerCount = data.VertexIndices.size();
+		if (cornerCount == 0)
+		{
+			return true;
+		}
+
+		//Weld the window's corners into vertices, checking every index as a corrupt file could point anywhere. Missing texture coordinates and normals are
+		//zero, as OBJImporter::Import has them
+		state.Welder.Clear();
+		state.WindowIndices.resize(cornerCount);
+		for (size_t i = 0; i < cornerCount; i++)
+		{
+			SimpleVertex vertex;
+			bool filled;
+			if (!OBJImporter::GetCorner(data, i, vertex.Pos, vertex.TexCoord, vertex.Normal, filled))
+			{
+				char line[512];
+				snprintf(line, sizeof(line), "%s: a face in window %u uses a position, texture coordinate or normal that hasn't been defined\n", state.Filename.c_str(),
+					state.WindowCount + 1);
+				Report(line);
+				return false;
+			}
+			state.FilledCorners += filled ? 1 : 0;
+			state.WindowIndices[i] = state.Welder.Insert(vertex);
+		}
+		state.WindowVertices.assign(state.Welder.GetVertices().begin(), state.Welder.GetVertices().end());
+		size_t vertexCount = state.WindowVertices.size();
+
+		if (state.VertexCount + vertexCount > UINT32_MAX || state.IndexCount + cornerCount > UINT32_MAX)
+		{
+			char line[512];
+			snprintf(line, sizeof(line), "%s: has more vertices or indices than a binary mesh can hold\n", state.Filename.c_str());
+			Report(line);
+			return false;
+		}
+
+		//Each run of one material is optimized and split into meshlets on its own, so it stays one range of the index buffer, as OBJImporter::Import does with
+		//each material's faces
+		state.Ordered.clear();
+		size_t useCount = data.MaterialUses.size();
+		for (size_t use = 0; use <= useCount; use++)
+		{
+			size_t start = use == 0 ? 0 : std::min<size_t>(data.MaterialUses[use - 1].IndexStart, cornerCount);
+			size_t end = use == useCount ? cornerCount : std::min<size_t>(data.MaterialUses[use].IndexStart, cornerCount);
+			if (use != 0)
+			{
+				state.Material = data.MaterialUses[use - 1].Name;
+			}
+			if (start >= end)
+			{
+				continue;
+			}
+
+			state.Segment.assign(state.WindowIndices.begin() + start, state.WindowIndices.begin() + end);
+			state.Optimized = state.Segment;
+			MeshOptimizer::OptimizeVertexCache(state.Optimized, vertexCount);
+			if (MeshOptimizer::AnalyzeVertexCache(state.Optimized, vertexCount).ACMR < MeshOptimizer::AnalyzeVertexCache(state.Segment, vertexCount).ACMR)
+			{
+				state.Segment.swap(state.Optimized);
+			}
+			Meshlets::Build(state.WindowVertices, state.Segment, state.SegmentMeshlets);
+
+			uint64_t indexStart = state.IndexCount + state.Ordered.size();
+			for (Meshlet& meshlet : state.SegmentMeshlets)
+			{
+				meshlet.IndexStart += (uint32_t)indexStart;
+			}
+			Append(state.Meshlets, state.SegmentMeshlets);
+			state.MeshletCount += state.SegmentMeshlets.size();
+
+			//Areas add up across windows, so a submesh's are complete once its last window is flushed
+			float modelArea;
+			float texCoordArea;
+			Bounds::MeasureSurface(state.WindowVertices, state.Segment, 0, state.Segment.size(), modelArea, texCoordArea);
+			AddToSubmesh(state, state.Material, indexStart, state.Segment.size(), state.SegmentMeshlets.size(), modelArea, texCoordArea);
+			state.Ordered.insert(state.Ordered.end(), state.Segment.begin(), state.Segment.end());
+		}
+
+		//Number the window's vertices in the order its triangles use them, then move them along past every earlier window's
+		MeshOptimizer::OptimizeVertexFetch(state.WindowVertices, state.Ordered);
+		for (unsigned int& index : state.Ordered)
+		{
+			index += (unsigned int)state.VertexCount;
+		}
+		Append(state.Vertices, state.WindowVertices);
+		Append(state.Indices, state.Ordered);
+		state.VertexCount += state.WindowVertices.size();
+		state.IndexCount += state.Ordered.size();
+		state.WindowCount++;
+
+		data.VertexIndices.clear();
+		data.TexCoordIndices.clear();
+		data.NormalIndices.clear();
+		data.MaterialUses.clear();
+		return true;
+	}
+
+	//Copies count items of type In from a temporary file into the binary mesh a buffer at a time, converting each block with convert(in, count, out)
+	template <typename In, typename Out, typename Convert>
+	bool CopyThrough(std::ifstream& in, uint64_t count, std::vector<char>& buffer, MeshBinaryWriter& writer, Convert convert)
+	{
+		//The buffer holds a block as read and as converted, side by side
+		size_t blockCount = std::max<size_t>(buffer.size() / (sizeof(In) + sizeof(Out)), 1);
+		In* read = (In*)buffer.data();
+		Out* converted = (Out*)(buffer.data() + sizeof(In) * blockCount);
+		for (uint64_t done = 0; done < count;)
+		{
+			size_t block = (size_t)std::min<uint64_t>(blockCount, count - done);
+			in.read((char*)read, sizeof(In) * block);
+			if (!in.good())
+			{
+				return false;
+			}
+			convert(read, block, converted);
+			if (!writer.Append(converted, sizeof(Out) * block))
+			{
+				return false;
+			}
+			done += block;
+		}
+		return true;
+	}
+
+	void RemoveFiles(const std::vector<std::string>& filenames)
+	{
+		for (const std::string& filename : filenames)
+		{
+			std::error_code error;
+			std::filesystem::remove(filename, error);
+		}
+	}
+}
+
+StreamingImportOptions OBJStreamImporter::GetDefaultOptions()
+{
+	StreamingImportOptions options;
+	options.MemoryBudget = DefaultMemoryBudget;
+	options.Format = VertexFormat::Compact;
+	options.InvertTexCoords = true;
+	return options;
+}
+
+bool OBJStreamImporter::Import(const std::string& filename, const std::string& binaryFilename, const StreamingImportOptions& options, StreamingImportStats& stats)
+{
+	stats = StreamingImportStats();
+	char line[512];
+
+	MeshSourceInfo source;
+	if (!MeshBinary::GetSourceInfo(filename, source, false))
+	{
+		return false;
+	}
+	stats.FileSize = source.Size;
+
+	//The first read through counts the pools, so they're allocated once at exactly their size, and hashes the file for the binary mesh's header
+	//rather than mapping all of it to hash it
+	size_t bufferSize = std::min<size_t>(std::max<size_t>(options.MemoryBudget / 16, MinimumBufferSize), MaximumBufferSize);
+	BlockReader reader;
+	if (!OpenReader(reader, filename, bufferSize))
+	{
+		return false;
+	}
+
+	size_t positionCount = 0;
+	size_t texCoordCount = 0;
+	size_t normalCount = 0;
+	MeshHasher hasher(source.Size);
+	const char* begin;
+	const char* end;
+	bool tooLong = false;
+	while (ReadBlock(reader, begin, end, &hasher, tooLong))
+	{
+		for (const char* p = begin; p < end; p = NextLine(p, end))
+		{
+			switch (GetLineType(p, end))
+			{
+			case LineType::Position: positionCount++; break;
+			case LineType::TexCoord: texCoordCount++; break;
+			case LineType::Normal: normalCount++; break;
+			default: break;
+			}
+		}
+	}
+	CloseReader(reader);
+	source.Hash = hasher.Finish();
+	if (tooLong)
+	{
+		snprintf(line, sizeof(line), "%s: has a line longer than the %zu KB read buffer\n", filename.c_str(), bufferSize / 1024);
+		Report(line);
+		return false;
+	}
+
+	//Whatever the pools and buffer leave goes to the window
+	stats.PoolBytes = positionCount * sizeof(XMFLOAT3) + normalCount * sizeof(XMFLOAT3) + texCoordCount * sizeof(XMFLOAT2);
+	stats.BufferBytes = bufferSize;
+	size_t fixedBytes = stats.PoolBytes + stats.BufferBytes + FixedBytes;
+	size_t windowBytes = options.MemoryBudget > fixedBytes ? options.MemoryBudget - fixedBytes : 0;
+	stats.WindowFaces = windowBytes / BytesPerFace;
+	stats.WindowBytes = stats.WindowFaces * BytesPerFace;
+	if (stats.WindowFaces < MinimumWindowFaces)
+	{
+		size_t needed = fixedBytes + MinimumWindowFaces * BytesPerFace;
+		snprintf(line, sizeof(line), "%s: needs a memory budget of at least %zu MB to stream, its pools alone take %zu MB\n", filename.c_str(),
+			(needed + 1024 * 1024 - 1) / (1024 * 1024), stats.PoolBytes / (1024 * 1024));
+		Report(line);
+		return false;
+	}
+
+	OBJData data;
+	data.Vertices.reserve(positionCount);
+	data.TexCoords.reserve(texCoordCount);
+	data.Normals.reserve(normalCount);
+	data.VertexIndices.reserve(stats.WindowFaces * 3);
+	data.TexCoordIndices.reserve(stats.WindowFaces * 3);
+	data.NormalIndices.reserve(stats.WindowFaces * 3);
+
+	std::vector<std::string> tempFilenames = { binaryFilename + ".vertices.tmp", binaryFilename + ".indices.tmp", binaryFilename + ".meshlets.tmp" };
+	std::vector<Submesh> submeshes;
+	uint64_t vertexCount = 0;
+	uint64_t indexCount = 0;
+	uint64_t meshletCount = 0;
+	uint64_t filledCorners = 0;
+	bool streamed = true;
+	{
+		StreamState state(stats.WindowFaces);
+		state.Filename = filename;
+		state.Vertices.open(tempFilenames[0], std::ios::out | std::ios::binary | std::ios::trunc);
+		state.Indices.open(tempFilenames[1], std::ios::out | std::ios::binary | std::ios::trunc);
+		state.Meshlets.open(tempFilenames[2], std::ios::out | std::ios::binary | std::ios::trunc);
+		streamed = OpenReader(reader, filename, bufferSize);
+
+		//Parse up to a window's worth of faces at a time, working on them whenever the window fills. The pools carry on growing, and since face indices
+		//are absolute they still point into them
+		size_t faces = 0;
+		while (streamed && ReadBlock(reader, begin, end, nullptr, tooLong))
+		{
+			const char* p = begin;
+			while (streamed && p < end)
+			{
+				const char* cut = p;
+				while (cut < end && faces < stats.WindowFaces)
+				{
+					if (GetLineType(cut, end) == LineType::Face) faces++;
+					cut = NextLine(cut, end);
+				}
+				OBJParser::Parse(p, cut, data, options.InvertTexCoords);
+				p = cut;
+
+				if (faces == stats.WindowFaces)
+				{
+					streamed = FlushWindow(state, data);
+					faces = 0;
+				}
+			}
+		}
+		streamed = streamed && !tooLong && FlushWindow(state, data);
+		CloseReader(reader);
+
+		//Changing the file between the two reads could have outgrown the pools' budget, and would make its hash wrong
+		streamed = streamed && data.Vertices.size() == positionCount && data.TexCoords.size() == texCoordCount && data.Normals.size() == normalCount;
+
+		state.Vertices.close();
+		state.Indices.close();
+		state.Meshlets.close();
+		streamed = streamed && !state.Vertices.fail() && !state.Indices.fail() && !state.Meshlets.fail();
+
+		submeshes.swap(state.Submeshes);
+		vertexCount = state.VertexCount;
+		indexCount = state.IndexCount;
+		meshletCount = state.MeshletCount;
+		filledCorners = state.FilledCorners;
+		stats.WindowCount = state.WindowCount;
+	}
+	if (!streamed)
+	{
+		snprintf(line, sizeof(line), "%s: couldn't be streamed%s\n", filename.c_str(), tooLong ? ", a line is longer than the read buffer" : "");
+		Report(line);
+		RemoveFiles(tempFilenames);
+		return false;
+	}
+	if (filledCorners > 0)
+	{
+		snprintf(line, sizeof(line), "%s: %llu face corners have no texture coordinate or normal, given zero ones\n", filename.c_str(), (unsigned long long)filledCorners);
+		Report(line);
+	}
+
+	//Every position is still in memory, so the bounds can be worked out from them before they're let go
+	MeshBinaryContents contents = {};
+	contents.Format = options.Format;
+	contents.Bounds = Bounds::Compute(data.Vertices);
+	contents.Quantization = options.Format == VertexFormat::Compact ? VertexFormats::GetQuantization(contents.Bounds.Min, contents.Bounds.Max) : VertexFormats::GetIdentityQuantization();
+	data = OBJData();
+
+	//Each submesh only has its full detail level
+	std::vector<MeshLod> lods(submeshes.size());
+	for (size_t s = 0; s < submeshes.size(); s++)
+	{
+		lods[s] = { submeshes[s].IndexStart, submeshes[s].IndexCount, 0.0f };
+		submeshes[s].LodStart = (uint32_t)s;
+		submeshes[s].LodCount = 1;
+	}
+
+	contents.VertexCount = (uint32_t)vertexCount;
+	contents.IndexCount = (uint32_t)indexCount;
+	contents.IndexSize = OBJImporter::ChooseIndexSize(vertexCount);
+	contents.MeshletCount = (uint32_t)meshletCount;
+	contents.Lods = lods.data();
+	contents.LodCount = (uint32_t)lods.size();
+	contents.Submeshes = submeshes.data();
+	contents.SubmeshCount = (uint32_t)submeshes.size();
+
+	//Copy the temporary files into the binary mesh through the read buffer, converting the vertices and indices to the format they're stored in
+	MeshBinaryWriter writer;
+	std::ifstream vertices(tempFilenames[0], std::ios::in | std::ios::binary);
+	std::ifstream indices(tempFilenames[1], std::ios::in | std::ios::binary);
+	std::ifstream meshlets(tempFilenames[2], std::ios::in | std::ios::binary);
+	bool written = writer.Open(binaryFilename, source, contents);
+	if (written && options.Format == VertexFormat::Compact)
+	{
+		written = CopyThrough<SimpleVertex, CompactVertex>(vertices, vertexCount, reader.Buffer, writer, [&](const SimpleVertex* in, size_t count, CompactVertex* out)
+		{
+			VertexFormats::Compress(in, count, contents.Quantization, out);
+		});
+	}
+	else if (written)
+	{
+		written = CopyThrough<SimpleVertex, SimpleVertex>(vertices, vertexCount, reader.Buffer, writer, [](const SimpleVertex* in, size_t count, SimpleVertex* out)
+		{
+			memcpy(out, in, sizeof(SimpleVertex) * count);
+		});
+	}
+	if (written && contents.IndexSize == sizeof(unsigned short))
+	{
+		written = CopyThrough<unsigned int, unsigned short>(indices, indexCount, reader.Buffer, writer, [](const unsigned int* in, size_t count, unsigned short* out)
+		{
+			for (size_t i = 0; i < count; i++) out[i] = (unsigned short)in[i];
+		});
+	}
+	else if (written)
+	{
+		written = CopyThrough<unsigned int, unsigned int>(indices, indexCount, reader.Buffer, writer, [](const unsigned int* in, size_t count, unsigned int* out)
+		{
+			memcpy(out, in, sizeof(unsigned int) * count);
+		});
+	}
+
+	size_t blockMeshlets = reader.Buffer.size() / sizeof(Meshlet);
+	for (uint64_t done = 0; written && done < meshletCount;)
+	{
+		size_t block = (size_t)std::min<uint64_t>(blockMeshlets, meshletCount - done);
+		meshlets.read(reader.Buffer.data(), sizeof(Meshlet) * block);
+		written = meshlets.good() && writer.AppendMeshlets((const Meshlet*)reader.Buffer.data(), block);
+		done += block;
+	}
+	written = written && writer.Finish();
+
+	vertices.close();
+	indices.close();
+	meshlets.close();
+	RemoveFiles(tempFilenames);
+	if (!written)
+	{
+		snprintf(line, sizeof(line), "%s: couldn't be written\n", binaryFilename.c_str());
+		Report(line);
+		return false;
+	}
+
+	stats.VertexCount = contents.VertexCount;
+	stats.TriangleCount = contents.IndexCount / 3;
+	stats.MeshletCount = contents.MeshletCount;
+	stats.SubmeshCount = contents.SubmeshCount;
+	snprintf(line, sizeof(line), "%s: streamed %u vertices, %u triangles, %u meshlets and %u submeshes in %u windows of up to %zu faces, within a %zu MB budget "
+		"(pools %.1f MB, buffer %.1f MB, window %.1f MB)\n", filename.c_str(), stats.VertexCount, stats.TriangleCount, stats.MeshletCount, stats.SubmeshCount,
+		stats.WindowCount, stats.WindowFaces, options.MemoryBudget / (1024 * 1024), stats.PoolBytes / (1024.0 * 1024.0), stats.BufferBytes / (1024.0 * 1024.0),
+		stats.WindowBytes / (1024.0 * 1024.0));
+	Report(line);
+	return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "VertexFormat.h"
+
+/// <summary>How OBJStreamImporter::Import reads a file and what it makes of it</summary>
+struct StreamingImportOptions
+{
+	/// <summary>The most memory the import may allocate, in bytes. The file's pools of positions, normals and texture coordinates have to fit in it
+	/// with room to spare for at least OBJStreamImporter::MinimumWindowFaces faces</summary>
+	size_t MemoryBudget;
+	/// <summary>The vertex format the binary mesh is written in</summary>
+	VertexFormat Format;
+	/// <summary>Flips the v texture coordinate, as DirectX's origin is at the top left</summary>
+	bool InvertTexCoords;
+};
+
+/// <summary>What OBJStreamImporter::Import made, and how it split its budget up</summary>
+struct StreamingImportStats
+{
+	/// <summary>The size of the .obj file, in bytes</summary>
+	uint64_t FileSize;
+	uint32_t VertexCount;
+	uint32_t TriangleCount;
+	uint32_t MeshletCount;
+	uint32_t SubmeshCount;
+	/// <summary>How many windows the faces were worked on in</summary>
+	uint32_t WindowCount;
+	/// <summary>The most faces in one window</summary>
+	size_t WindowFaces;
+	/// <summary>The part of the budget the pools of positions, normals and texture coordinates take, for the whole import</summary>
+	size_t PoolBytes;
+	/// <summary>The part of the budget the read buffer takes, which is also what the temporary files are copied into the binary mesh through</summary>
+	size_t BufferBytes;
+	/// <summary>The part of the budget set aside for working on one window of faces</summary>
+	size_t WindowBytes;
+};
+
+/// <summary><para>Imports .obj files too big to hold in memory all at once, such as photogrammetry scans of hundreds of MB, straight into a binary mesh. </para>
+/// <para>OBJImporter::Import holds the file's pools, its three index lists, three expanded copies and the final arrays at the same time, roughly ten times the
+/// size of the mesh it makes. This reads the file a block at a time instead and works on its faces a window at a time: each window is welded, ordered for the
+/// vertex cache and split into meshlets, then its vertices, indices and meshlets are appended to temporary files and the window's memory is reused for the next.
+/// Once the whole file has been read, they're copied into the binary mesh through MeshBinaryWriter, converted to the vertex and index format on the way. </para>
+/// <para>Only the pools of positions, normals and texture coordinates are kept from start to finish, as any face may use any of them. The file is read through
+/// once first to count them, so a budget too small to hold them fails straight away rather than part way through, and they're allocated exactly once. </para>
+/// <para>What streaming gives up: vertices are only welded within a window, so one shared by faces in two windows is stored twice. The triangles aren't sorted
+/// for overdraw, and each submesh only has its full detail level, as both need the whole mesh at once. Each run of faces with one material is a submesh, rather
+/// than every face with that material. Compact vertices are quantized within the box around every position in the file. The payload is always stored raw, as
+/// MeshEncoding::Compressed encodes each stream in one go.</para></summary>
+namespace OBJStreamImporter
+{
+	const size_t DefaultMemoryBudget = 256 * 1024 * 1024;
+
+	/// <summary>OBJLoader::Load and the asset cooker import .obj files at least this big with Import rather than OBJImporter</summary>
+	const uint64_t StreamingThreshold = 128 * 1024 * 1024;
+
+	/// <summary>The most working on one face of a window takes: its corners in the index lists, the welder, the window's vertices and indices, and
+	/// the scratch memory MeshOptimizer and Meshlets::Build use. Measured with ImportBenchmark --streaming, with some to spare</summary>
+	const size_t BytesPerFace = 1024;
+
+	/// <summary>Windows smaller than this weld so little that the mesh would be mostly duplicate vertices, so a budget that can't fit one fails instead</summary>
+	const size_t MinimumWindowFaces = 4096;
+
+	/// <summary>The default budget, in the compact vertex format with flipped texture coordinates, as OBJLoader::Load uses</summary>
+	StreamingImportOptions GetDefaultOptions();
+
+	/// <summary>Imports an .obj file into a binary mesh at binaryFilename without allocating more than options.MemoryBudget. Reports what it did, or why it couldn't,
+	/// to the debug output</summary>
+	/// <returns>false if the file couldn't be read, the budget is too small for it, or the binary mesh couldn't be written. Any existing binary mesh is left as it was</returns>
+	bool Import(const std::string& filename, const std::string& binaryFilename, const StreamingImportOptions& options, StreamingImportStats& stats);
+};
@@ -0,0 +1,799 @@
+#include "Simplifier.h"
+#include "MeshOptimizer.h"
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+	const unsigned int NoVertex = 0xFFFFFFFF;
+
+	//How a vertex may move, decided by the edges around it that only have a triangle on one side
+	enum VertexKind
+	{
+		//Inside the surface, with one set of attributes. Can collapse onto any neighbour
+		Manifold,
+		//On the edge of an open surface. Only slides along that edge, onto the next border vertex
+		Border,
+		//On a seam between two sets of attributes, like a UV seam. Only slides along the seam, with its twin on the other side
+		Seam,
+		//A corner, or something more tangled. Never moves
+		Locked,
+		KindCount,
+	};
+
+	//Which kinds of vertex each kind may collapse onto, indexed [from][to]
+	const bool CanCollapse[KindCount][KindCount] =
+	{
+		{ true, true, true, true },
+		{ false, true, false, false },
+		{ false, false, true, false },
+		{ false, false, false, false },
+	};
+
+	//Open edges get planes at right angles to their triangle, so moving along the edge is cheap and moving off it isn't.
+	//Borders are held harder than seams, as moving a border changes the silhouette
+	const double BorderWeight = 10.0;
+	const double SeamWeight = 1.0;
+
+	//A collapse that turns any triangle's normal by more than about 75 degrees is rejected, which catches flips and most slivers
+	const double MinTurnCosine = 0.25;
+
+	//Each pass may go this far past the error of the collapse that would hit its goal, so passes aren't cut short by near ties
+	const double PassErrorSlack = 1.5;
+
+	struct Point
+	{
+		double x, y, z;
+	};
+
+	Point GetPoint(const SimpleVertex& vertex)
+	{
+		return { vertex.Pos.x, vertex.Pos.y, vertex.Pos.z };
+	}
+
+	Point Subtract(const Point& a, const Point& b)
+	{
+		return { a.x - b.x, a.y - b.y, a.z - b.z };
+	}
+
+	Point Cross(const Point& a, const Point& b)
+	{
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	double Dot(const Point& a, const Point& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	double Length(const Point& a)
+	{
+		return sqrt(Dot(a, a));
+	}
+
+	//The weighted sum of squared distances to a set of planes, as v'Av + 2b'v + c
+	struct Quadric
+	{
+		double A00, A11, A22, A01, A02, A12;
+		double B0, B1, B2;
+		double C;
+		double Weight;
+	};
+
+	Quadric PlaneQuadric(const Point& normal, double distance, double weight)
+	{
+		Quadric quadric;
+		quadric.A00 = normal.x * normal.x * weight;
+		quadric.A11 = normal.y * normal.y * weight;
+		quadric.A22 = normal.z * normal.z * weight;
+		quadric.A01 = normal.x * normal.y * weight;
+		quadric.A02 = normal.x * normal.z * weight;
+		quadric.A12 = normal.y * normal.z * weight;
+		quadric.B0 = normal.x * distance * weight;
+		quadric.B1 = normal.y * distance * weight;
+		quadric.B2 = normal.z * distance * weight;
+		quadric.C = distance * distance * weight;
+		quadric.Weight = weight;
+		return quadric;
+	}
+
+	void AddQuadric(Quadric& quadric, const Quadric& other)
+	{
+		quadric.A00 += other.A00;
+		quadric.A11 += other.A11;
+		quadric.A22 += other.A22;
+		quadric.A01 += other.A01;
+		quadric.A02 += other.A02;
+		quadric.A12 += other.A12;
+		quadric.B0 += other.B0;
+		quadric.B1 += other.B1;
+		quadric.B2 += other.B2;
+		quadric.C += other.C;
+		quadric.Weight += other.Weight;
+	}
+
+	//The weighted mean of the squared distances from a point to the quadric's planes, so its square root is in model units
+	double QuadricError(const Quadric& quadric, const Point& point)
+	{
+		if (quadric.Weight <= 0.0)
+		{
+			return 0.0;
+		}
+
+		double rx = quadric.A00 * point.x + quadric.A01 * point.y + quadric.A02 * point.z;
+		double ry = quadric.A01 * point.x + quadric.A11 * point.y + quadric.A12 * point.z;
+		double rz = quadric.A02 * point.x + quadric.A12 * point.y + quadric.A22 * point.z;
+		double error = rx * point.x + ry * point.y + rz * point.z + 2.0 * (quadric.B0 * point.x + quadric.B1 * point.y + quadric.B2 * point.z) + quadric.C;
+
+		//Rounding can take a sum of squares very slightly below zero
+		return fabs(error) / quadric.Weight;
+	}
+
+	struct Collapse
+	{
+		unsigned int From;
+		unsigned int To;
+		double Error;
+	};
+
+	uint64_t EdgeKey(unsigned int from, unsigned int to)
+	{
+		return ((uint64_t)from << 32) | to;
+	}
+
+	//Border and seam loops that pointed at a collapsed vertex now point at the vertex it collapsed onto. If the vertex a loop pointed at
+	//collapsed back onto the start of the loop, the loop skips over it to wherever that vertex's loop went
+	void RemapLoops(std::vector<unsigned int>& loop, const std::vector<unsigned int>& collapseRemap)
+	{
+		for (size_t v = 0; v < loop.size(); v++)
+		{
+			if (loop[v] != NoVertex)
+			{
+				unsigned int next = loop[v];
+				unsigned int remapped = collapseRemap[next];
+				loop[v] = remapped == v ? loop[next] : remapped;
+			}
+		}
+	}
+
+	Point Add(const Point& a, const Point& b)
+	{
+		return { a.x + b.x, a.y + b.y, a.z + b.z };
+	}
+
+	Point Scale(const Point& a, double scale)
+	{
+		return { a.x * scale, a.y * scale, a.z * scale };
+	}
+
+	//The distance from a point to the nearest point on a triangle, from Ericson's "Real-Time Collision Detection": find which of the triangle's
+	//corners, edges or face the point is nearest to from where it projects onto each edge
+	double PointTriangleDistance(const Point& p, const Point& a, const Point& b, const Point& c)
+	{
+		Point ab = Subtract(b, a);
+		Point ac = Subtract(c, a);
+		Point ap = Subtract(p, a);
+		double d1 = Dot(ab, ap);
+		double d2 = Dot(ac, ap);
+		if (d1 <= 0.0 && d2 <= 0.0)
+		{
+			return Length(ap);
+		}
+
+		Point bp = Subtract(p, b);
+		double d3 = Dot(ab, bp);
+		double d4 = Dot(ac, bp);
+		if (d3 >= 0.0 && d4 <= d3)
+		{
+			return Length(bp);
+		}
+
+		double vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+		{
+			return Length(Subtract(p, Add(a, Scale(ab, d1 / (d1 - d3)))));
+		}
+
+		Point cp = Subtract(p, c);
+		double d5 = Dot(ab, cp);
+		double d6 = Dot(ac, cp);
+		if (d6 >= 0.0 && d5 <= d6)
+		{
+			return Length(cp);
+		}
+
+		double vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+		{
+			return Length(Subtract(p, Add(a, Scale(ac, d2 / (d2 - d6)))));
+		}
+
+		double va = d3 * d6 - d5 * d4;
+		if (va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0)
+		{
+			return Length(Subtract(p, Add(b, Scale(Subtract(c, b), (d4 - d3) / ((d4 - d3) + (d5 - d6))))));
+		}
+
+		double denominator = va + vb + vc;
+		if (denominator <= 0.0)
+		{
+			//No area, so it's a line or a point, which the corner distances bound well enough
+			return std::min(Length(ap), std::min(Length(bp), Length(cp)));
+		}
+		return Length(Subtract(p, Add(a, Add(Scale(ab, vb / denominator), Scale(ac, vc / denominator)))));
+	}
+
+	//Buckets triangles into a uniform grid over their bounds, so the nearest one to a point can be found by searching outwards from the
+	//point's cell rather than testing every triangle
+	class TriangleGrid
+	{
+	private:
+		const std::vector<SimpleVertex>& m_vertices;
+		const std::vector<unsigned int>& m_indices;
+		Point m_minimum;
+		double m_cellSize;
+		int m_size[3];
+		//The triangles in each cell, in cell order
+		std::vector<unsigned int> m_firstTriangle;
+		std::vector<unsigned int> m_triangles;
+		//The last search that tested each triangle, so triangles in several cells are only tested once per search
+		std::vector<unsigned int> m_testedBy;
+		unsigned int m_search;
+
+		int GetCell(double value, int axis) const
+		{
+			int cell = (int)floor((value - (&m_minimum.x)[axis]) / m_cellSize);
+			return std::min(std::max(cell, 0), m_size[axis] - 1);
+		}
+
+	public:
+		TriangleGrid(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices)
+			: m_vertices(vertices), m_indices(indices), m_search(0)
+		{
+			size_t triangleCount = indices.size() / 3;
+			Point maximum = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+			m_minimum = { DBL_MAX, DBL_MAX, DBL_MAX };
+			for (unsigned int index : indices)
+			{
+				Point point = GetPoint(vertices[index]);
+				m_minimum = { std::min(m_minimum.x, point.x), std::min(m_minimum.y, point.y), std::min(m_minimum.z, point.z) };
+				maximum = { std::max(maximum.x, point.x), std::max(maximum.y, point.y), std::max(maximum.z, point.z) };
+			}
+
+			//Aim for about one triangle per cell, with cells as wide as the widest side over 64 at the least
+			Point extent = triangleCount == 0 ? Point{ 0.0, 0.0, 0.0 } : Subtract(maximum, m_minimum);
+			double widest = std::max(extent.x, std::max(extent.y, extent.z));
+			double volume = std::max(extent.x, widest / 64.0) * std::max(extent.y, widest / 64.0) * std::max(extent.z, widest / 64.0);
+			m_cellSize = std::max(std::max(cbrt(volume / std::max(triangleCount, (size_t)1)), widest / 64.0), DBL_MIN);
+			size_t cellCount = 1;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				m_size[axis] = (int)((&extent.x)[axis] / m_cellSize) + 1;
+				cellCount *= m_size[axis];
+			}
+
+			//Each triangle goes in every cell its bounding box touches, counted first then filled in
+			m_firstTriangle.assign(cellCount + 1, 0);
+			for (int pass = 0; pass < 2; pass++)
+			{
+				std::vector<unsigned int> filled(m_firstTriangle.begin(), m_firstTriangle.end() - 1);
+				for (size_t t = 0; t < triangleCount; t++)
+				{
+					int low[3], high[3];
+					for (int axis = 0; axis < 3; axis++)
+					{
+						double a = (&vertices[indices[t * 3]].Pos.x)[axis];
+						double b = (&vertices[indices[t * 3 + 1]].Pos.x)[axis];
+						double c = (&vertices[indices[t * 3 + 2]].Pos.x)[axis];
+						low[axis] = GetCell(std::min(a, std::min(b, c)), axis);
+						high[axis] = GetCell(std::max(a, std::max(b, c)), axis);
+					}
+
+					for (int z = low[2]; z <= high[2]; z++)
+					for (int y = low[1]; y <= high[1]; y++)
+					for (int x = low[0]; x <= high[0]; x++)
+					{
+						size_t cell = ((size_t)z * m_size[1] + y) * m_size[0] + x;
+						if (pass == 0) m_firstTriangle[cell + 1]++;
+						else m_triangles[filled[cell]++] = (unsigned int)t;
+					}
+				}
+
+				if (pass == 0)
+				{
+					for (size_t cell = 0; cell < cellCount; cell++)
+					{
+						m_firstTriangle[cell + 1] += m_firstTriangle[cell];
+					}
+					m_triangles.resize(m_firstTriangle[cellCount]);
+				}
+			}
+			m_testedBy.assign(triangleCount, 0);
+		}
+
+		//How far a point is from the nearest triangle. Searches shells of cells outwards from the point's cell until the nearest triangle found
+		//is closer than anything in the next shell could be
+		double Distance(const Point& point)
+		{
+			m_search++;
+			int centre[3] = { GetCell(point.x, 0), GetCell(point.y, 1), GetCell(point.z, 2) };
+			int largest = std::max(m_size[0], std::max(m_size[1], m_size[2]));
+			double nearest = DBL_MAX;
+			for (int ring = 0; ring <= largest && nearest > (ring - 1) * m_cellSize; ring++)
+			{
+				for (int z = std::max(centre[2] - ring, 0); z <= std::min(centre[2] + ring, m_size[2] - 1); z++)
+				for (int y = std::max(centre[1] - ring, 0); y <= std::min(centre[1] + ring, m_size[1] - 1); y++)
+				for (int x = std::max(centre[0] - ring, 0); x <= std::min(centre[0] + ring, m_size[0] - 1); x++)
+				{
+					//Only the cells on the surface of the shell are new
+					if (std::max(abs(x - centre[0]), std::max(abs(y - centre[1]), abs(z - centre[2]))) != ring)
+					{
+						continue;
+					}
+
+					size_t cell = ((size_t)z * m_size[1] + y) * m_size[0] + x;
+					for (unsigned int i = m_firstTriangle[cell]; i < m_firstTriangle[cell + 1]; i++)
+					{
+						unsigned int t = m_triangles[i];
+						if (m_testedBy[t] == m_search)
+						{
+							continue;
+						}
+						m_testedBy[t] = m_search;
+
+						const unsigned int* triangle = &m_indices[t * 3];
+						nearest = std::min(nearest, PointTriangleDistance(point, GetPoint(m_vertices[triangle[0]]), GetPoint(m_vertices[triangle[1]]), GetPoint(m_vertices[triangle[2]])));
+					}
+				}
+			}
+			return nearest;
+		}
+	};
+
+	//The quadric error is a weighted mean, so a thin part whose narrow sides have little area can collapse cheaply while moving a long way.
+	//A level's error is measured instead, as the furthest any of the original vertices is from the level's surface
+	double MeasureError(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<unsigned int>& points)
+	{
+		if (indices.empty())
+		{
+			return 0.0;
+		}
+
+		TriangleGrid grid(vertices, indices);
+		double error = 0.0;
+		for (unsigned int point : points)
+		{
+			error = std::max(error, grid.Distance(GetPoint(vertices[point])));
+		}
+		return error;
+	}
+
+	//Whether moving from onto to would turn any of the triangles around from too far, which would fold the surface over
+	bool HasFlips(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap,
+		const std::vector<unsigned int>& collapseRemap, const std::vector<unsigned int>& firstTriangle, const std::vector<unsigned int>& positionTriangles,
+		unsigned int from, unsigned int to)
+	{
+		unsigned int fromPosition = remap[from];
+		unsigned int toPosition = remap[to];
+		Point before = GetPoint(vertices[from]);
+		Point after = GetPoint(vertices[to]);
+
+		for (unsigned int i = firstTriangle[fromPosition]; i < firstTriangle[fromPosition + 1]; i++)
+		{
+			const unsigned int* triangle = &indices[positionTriangles[i] * 3];
+			unsigned int corners[3] = { collapseRemap[triangle[0]], collapseRemap[triangle[1]], collapseRemap[triangle[2]] };
+
+			//Triangles along the collapsed edge disappear, so can't flip
+			int moving = 0;
+			bool collapsed = false;
+			for (int k = 0; k < 3; k++)
+			{
+				if (remap[corners[k]] == fromPosition) moving = k;
+				if (remap[corners[k]] == toPosition) collapsed = true;
+			}
+			if (collapsed)
+			{
+				continue;
+			}
+
+			Point b = GetPoint(vertices[corners[(moving + 1) % 3]]);
+			Point c = GetPoint(vertices[corners[(moving + 2) % 3]]);
+			Point normalBefore = Cross(Subtract(b, before), Subtract(c, before));
+			Point normalAfter = Cross(Subtract(b, after), Subtract(c, after));
+			if (Dot(normalBefore, normalAfter) < MinTurnCosine * Length(normalBefore) * Length(normalAfter))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+void Simplifier::Simplify(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<size_t>& targetIndexCounts,
+	std::vector<std::vector<unsigned int>>& results, std::vector<float>& errors)
+{
+	size_t vertexCount = vertices.size();
+	results.assign(targetIndexCounts.size(), std::vector<unsigned int>());
+	errors.assign(targetIndexCounts.size(), 0.0f);
+
+	//Vertices that only differ by their normal or texture coordinate share a position and have to move together. remap is the first
+	//vertex at each position, which quadrics are kept against, and wedge links every vertex at a position into a loop
+	std::vector<unsigned int> remap(vertexCount);
+	std::vector<unsigned int> wedge(vertexCount);
+	{
+		VertexWelder positions(vertexCount);
+		std::vector<unsigned int> firstAtPosition;
+		firstAtPosition.reserve(vertexCount);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			SimpleVertex position = {};
+			position.Pos = vertices[v].Pos;
+			unsigned int id = positions.Insert(position);
+			if (id == firstAtPosition.size())
+			{
+				firstAtPosition.push_back((unsigned int)v);
+			}
+
+			unsigned int first = firstAtPosition[id];
+			remap[v] = first;
+			wedge[v] = v == first ? (unsigned int)v : wedge[first];
+			wedge[first] = (unsigned int)v;
+		}
+	}
+
+	//One vertex at each position the mesh uses, to measure each level's error from
+	std::vector<unsigned int> surfacePoints;
+	{
+		std::vector<bool> used(vertexCount, false);
+		for (unsigned int index : indices)
+		{
+			if (!used[remap[index]])
+			{
+				used[remap[index]] = true;
+				surfacePoints.push_back(remap[index]);
+			}
+		}
+	}
+
+	//An edge is open if no triangle has it the other way round, which is true along borders and along both sides of a seam.
+	//Each vertex remembers the open edges leaving and arriving at it, or itself if there's more than one
+	std::vector<uint64_t> edges(indices.size());
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		edges[i] = EdgeKey(indices[i], indices[i - i % 3 + (i + 1) % 3]);
+	}
+	std::sort(edges.begin(), edges.end());
+
+	std::vector<bool> open(indices.size());
+	std::vector<unsigned int> openOut(vertexCount, NoVertex);
+	std::vector<unsigned int> openIn(vertexCount, NoVertex);
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		unsigned int from = indices[i];
+		unsigned int to = indices[i - i % 3 + (i + 1) % 3];
+		open[i] = !std::binary_search(edges.begin(), edges.end(), EdgeKey(to, from));
+		if (open[i])
+		{
+			openOut[from] = openOut[from] == NoVertex ? to : from;
+			openIn[to] = openIn[to] == NoVertex ? from : to;
+		}
+	}
+
+	std::vector<VertexKind> kinds(vertexCount, Locked);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		if (remap[v] != v)
+		{
+			continue;
+		}
+
+		VertexKind kind = Locked;
+		unsigned int twin = wedge[v];
+		if (twin == v)
+		{
+			if (openOut[v] == NoVertex && openIn[v] == NoVertex)
+			{
+				kind = Manifold;
+			}
+			else if (openOut[v] != NoVertex && openIn[v] != NoVertex && openOut[v] != v && openIn[v] != v)
+			{
+				kind = Border;
+			}
+		}
+		else if (wedge[twin] == v)
+		{
+			//Exactly two sets of attributes. It's a seam if the seam leaving one side arrives at the other from the same position, and the other way round
+			bool single = openOut[v] != NoVertex && openIn[v] != NoVertex && openOut[twin] != NoVertex && openIn[twin] != NoVertex
+				&& openOut[v] != v && openIn[v] != v && openOut[twin] != twin && openIn[twin] != twin;
+			if (single && remap[openOut[v]] == remap[openIn[twin]] && remap[openIn[v]] == remap[openOut[twin]])
+			{
+				kind = Seam;
+			}
+		}
+
+		//Every vertex at the position moves the same way
+		unsigned int w = (unsigned int)v;
+		do
+		{
+			kinds[w] = kind;
+			w = wedge[w];
+		} while (w != v);
+	}
+
+	//Each triangle's plane, weighted by its area, goes into the quadric of each of its corners' positions
+	std::vector<Quadric> quadrics(vertexCount, Quadric());
+	for (size_t t = 0; t < indices.size() / 3; t++)
+	{
+		const unsigned int* triangle = &indices[t * 3];
+		Point a = GetPoint(vertices[triangle[0]]);
+		Point b = GetPoint(vertices[triangle[1]]);
+		Point c = GetPoint(vertices[triangle[2]]);
+		Point normal = Cross(Subtract(b, a), Subtract(c, a));
+		double length = Length(normal);
+		if (length == 0.0)
+		{
+			continue;
+		}
+		normal = { normal.x / length, normal.y / length, normal.z / length };
+
+		Quadric plane = PlaneQuadric(normal, -Dot(normal, a), length * 0.5);
+		for (int k = 0; k < 3; k++)
+		{
+			AddQuadric(quadrics[remap[triangle[k]]], plane);
+		}
+
+		for (int k = 0; k < 3; k++)
+		{
+			if (!open[t * 3 + k])
+			{
+				continue;
+			}
+
+			unsigned int from = triangle[k];
+			unsigned int to = triangle[(k + 1) % 3];
+			Point start = GetPoint(vertices[from]);
+			Point edge = Subtract(GetPoint(vertices[to]), start);
+			double edgeLength = Length(edge);
+			if (edgeLength == 0.0)
+			{
+				continue;
+			}
+
+			//Edge and normal are unit length and at right angles, so their cross product is too. Weighted by the length squared to match the area weights
+			Point edgeNormal = Cross({ edge.x / edgeLength, edge.y / edgeLength, edge.z / edgeLength }, normal);
+			double weight = (kinds[from] == Border || kinds[to] == Border ? BorderWeight : SeamWeight) * edgeLength * edgeLength;
+			Quadric edgePlane = PlaneQuadric(edgeNormal, -Dot(edgeNormal, start), weight);
+			AddQuadric(quadrics[remap[from]], edgePlane);
+			AddQuadric(quadrics[remap[to]], edgePlane);
+		}
+	}
+
+	//Can from collapse onto to, and if so how much error would it add
+	auto tryCollapse = [&](unsigned int from, unsigned int to, Collapse& collapse)
+	{
+		VertexKind fromKind = kinds[from];
+		if (!CanCollapse[fromKind][kinds[to]] || remap[from] == remap[to])
+		{
+			return false;
+		}
+		if ((fromKind == Border || fromKind == Seam) && openOut[from] != to && openIn[from] != to)
+		{
+			return false;
+		}
+		if (fromKind == Seam)
+		{
+			//The twins on the other side of the seam have to be joined by the same edge, running the other way
+			unsigned int fromTwin = wedge[from];
+			unsigned int toTwin = wedge[to];
+			if (!(openOut[from] == to && openIn[fromTwin] == toTwin) && !(openIn[from] == to && openOut[fromTwin] == toTwin))
+			{
+				return false;
+			}
+		}
+
+		collapse.From = from;
+		collapse.To = to;
+		collapse.Error = QuadricError(quadrics[remap[from]], GetPoint(vertices[to]));
+		return true;
+	};
+
+	std::vector<unsigned int> current = indices;
+	std::vector<unsigned int> collapseRemap(vertexCount);
+	std::vector<bool> moved(vertexCount);
+	std::vector<Collapse> collapses;
+	std::vector<unsigned int> firstTriangle(vertexCount + 1);
+	std::vector<unsigned int> positionTriangles;
+	float levelError = 0.0f;
+	size_t level = 0;
+
+	//Each pass finds the cheapest way to collapse every edge, then makes as many of those collapses as it can without two touching
+	//the same position, so the costs it sorted by stay true
+	while (true)
+	{
+		if (level < targetIndexCounts.size() && current.size() <= targetIndexCounts[level])
+		{
+			//Each level is simplified further than the one before, so it can't be closer to the original
+			levelError = std::max(levelError, (float)MeasureError(vertices, current, surfacePoints));
+			while (level < targetIndexCounts.size() && current.size() <= targetIndexCounts[level])
+			{
+				results[level] = current;
+				errors[level] = levelError;
+				level++;
+			}
+		}
+		if (level == targetIndexCounts.size())
+		{
+			break;
+		}
+
+		collapses.clear();
+		for (size_t i = 0; i < current.size(); i++)
+		{
+			unsigned int a = current[i];
+			unsigned int b = current[i - i % 3 + (i + 1) % 3];
+
+			//Closed edges are in two triangles, so only look at them from one
+			if (remap[a] > remap[b] && openOut[a] != b)
+			{
+				continue;
+			}
+
+			Collapse forward, backward;
+			bool canForward = tryCollapse(a, b, forward);
+			bool canBackward = tryCollapse(b, a, backward);
+			if (canForward || canBackward)
+			{
+				collapses.push_back(!canBackward || (canForward && forward.Error <= backward.Error) ? forward : backward);
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Error < b.Error; });
+
+		//Most collapses remove two triangles
+		size_t triangleGoal = (current.size() - targetIndexCounts[level]) / 3;
+		size_t collapseGoal = std::max(triangleGoal / 2, (size_t)1);
+		double errorGoal = collapseGoal < collapses.size() ? collapses[collapseGoal].Error * PassErrorSlack : DBL_MAX;
+
+		//The triangles around each position, to check for flips
+		std::fill(firstTriangle.begin(), firstTriangle.end(), 0);
+		for (unsigned int index : current)
+		{
+			firstTriangle[remap[index] + 1]++;
+		}
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			firstTriangle[v + 1] += firstTriangle[v];
+		}
+		positionTriangles.resize(current.size());
+		std::vector<unsigned int> filled(firstTriangle.begin(), firstTriangle.end() - 1);
+		for (size_t i = 0; i < current.size(); i++)
+		{
+			positionTriangles[filled[remap[current[i]]]++] = (unsigned int)(i / 3);
+		}
+
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			collapseRemap[v] = (unsigned int)v;
+		}
+		std::fill(moved.begin(), moved.end(), false);
+
+		size_t removed = 0;
+		for (const Collapse& collapse : collapses)
+		{
+			//Past the error goal, carry on only until something has been collapsed, so a pass whose cheapest collapses all flip doesn't stall
+			if (removed >= triangleGoal || (collapse.Error > errorGoal && removed > 0))
+			{
+				break;
+			}
+
+			unsigned int fromPosition = remap[collapse.From];
+			unsigned int toPosition = remap[collapse.To];
+			if (moved[fromPosition] || moved[toPosition])
+			{
+				continue;
+			}
+			if (HasFlips(vertices, current, remap, collapseRemap, firstTriangle, positionTriangles, collapse.From, collapse.To))
+			{
+				continue;
+			}
+
+			collapseRemap[collapse.From] = collapse.To;
+			if (kinds[collapse.From] == Seam)
+			{
+				collapseRemap[wedge[collapse.From]] = wedge[collapse.To];
+			}
+			AddQuadric(quadrics[toPosition], quadrics[fromPosition]);
+			moved[fromPosition] = true;
+			moved[toPosition] = true;
+
+			removed += kinds[collapse.From] == Border ? 1 : 2;
+		}
+
+		//Nothing left can be collapsed, so the rest of the levels stop here
+		if (removed == 0)
+		{
+			levelError = std::max(levelError, (float)MeasureError(vertices, current, surfacePoints));
+			for (; level < targetIndexCounts.size(); level++)
+			{
+				results[level] = current;
+				errors[level] = levelError;
+			}
+			break;
+		}
+
+		//Move the collapsed vertices and drop the triangles that lost their area
+		size_t written = 0;
+		for (size_t i = 0; i < current.size(); i += 3)
+		{
+			unsigned int a = collapseRemap[current[i]];
+			unsigned int b = collapseRemap[current[i + 1]];
+			unsigned int c = collapseRemap[current[i + 2]];
+			if (remap[a] == remap[b] || remap[b] == remap[c] || remap[a] == remap[c])
+			{
+				continue;
+			}
+
+			current[written++] = a;
+			current[written++] = b;
+			current[written++] = c;
+		}
+		current.resize(written);
+
+		RemapLoops(openOut, collapseRemap);
+		RemapLoops(openIn, collapseRemap);
+	}
+}
+
+void Simplifier::BuildLods(const std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices, std::vector<MeshLod>& lods)
+{
+	lods.clear();
+	lods.push_back({ 0, (uint32_t)indices.size(), 0.0f });
+
+	std::vector<size_t> targets(LodCount);
+	for (unsigned int level = 0; level < LodCount; level++)
+	{
+		targets[level] = (size_t)(indices.size() / 3 * LodRatios[level]) * 3;
+	}
+
+	std::vector<std::vector<unsigned int>> levels;
+	std::vector<float> errors;
+	Simplify(vertices, indices, targets, levels, errors);
+
+	for (unsigned int level = 0; level < LodCount; level++)
+	{
+		std::vector<unsigned int>& levelIndices = levels[level];
+		if (levelIndices.empty() || levelIndices.size() > lods.back().IndexCount / 4 * 3)
+		{
+			continue;
+		}
+
+		//Collapsing leaves the triangles in their old order, which has gaps in it now
+		MeshOptimizer::OptimizeVertexCache(levelIndices, vertices.size());
+		MeshOptimizer::OptimizeOverdraw(vertices, levelIndices);
+
+		lods.push_back({ (uint32_t)indices.size(), (uint32_t)levelIndices.size(), errors[level] });
+		indices.insert(indices.end(), levelIndices.begin(), levelIndices.end());
+	}
+}
+
+unsigned int Simplifier::SelectLod(const std::vector<MeshLod>& lods, float distance, float pixelScale, float maxPixelError)
+{
+	return SelectLod(lods.data(), lods.size(), distance, pixelScale, maxPixelError);
+}
+
+unsigned int Simplifier::SelectLod(const MeshLod* lods, size_t lodCount, float distance, float pixelScale, float maxPixelError)
+{
+	//A level's error covers about error * pixelScale / distance pixels, and the error only grows with each level, so take the last one that's small enough
+	unsigned int selected = 0;
+	for (unsigned int level = 1; level < lodCount; level++)
+	{
+		if (lods[level].Error * pixelScale > maxPixelError * distance)
+		{
+			break;
+		}
+		selected = level;
+	}
+	return selected;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Vertices.h"
+
+/// <summary><para>One level of detail of a mesh: a range of its index buffer, drawn with the same vertex buffer as every other level. </para>
+/// <para>Levels are stored in binary meshes as they are, so every field is fixed width.</para></summary>
+struct MeshLod
+{
+	uint32_t IndexStart;
+	uint32_t IndexCount;
+	/// <summary>How far the full detail mesh's vertices may be from the level's surface, in model units. 0 for the full detail level</summary>
+	float Error;
+};
+
+/// <summary><para>Builds lower levels of detail of a mesh at import time by collapsing edges, cheapest first, using quadric error metrics. </para>
+/// <para>Collapses only ever move a vertex onto one of its neighbours, so every level is drawn from the full detail vertex buffer.</para></summary>
+namespace Simplifier
+{
+	/// <summary>How many levels BuildLods aims for after the full detail one</summary>
+	const unsigned int LodCount = 4;
+	/// <summary>The fraction of the full detail mesh's triangles each level aims for</summary>
+	const float LodRatios[LodCount] = { 0.5f, 0.25f, 0.125f, 0.0625f };
+	/// <summary>How many pixels SelectLod lets a level's error cover by default</summary>
+	const float DefaultPixelError = 1.0f;
+
+	/// <summary><para>Collapses the edges of a triangle list until it has no more than each of the target index counts. </para>
+	/// <para>This is Garland and Heckbert's "Surface Simplification Using Quadric Error Metrics". Vertices that share a position are moved together,
+	/// so UV and normal seams stay closed: seam vertices only slide along their seam, border vertices only along their border, and corners stay put.
+	/// Collapses that would flip a triangle are rejected. A level may end up with more indices than its target if nothing more can be collapsed.</para></summary>
+	/// <param name="targetIndexCounts">The index count of each level, largest first</param>
+	/// <param name="results">Replaced with the triangles of each level, which only use vertices from the original list</param>
+	/// <param name="errors">Replaced with the error of each level, see MeshLod::Error</param>
+	void Simplify(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<size_t>& targetIndexCounts,
+		std::vector<std::vector<unsigned int>>& results, std::vector<float>& errors);
+
+	/// <summary><para>Simplifies a mesh to each of LodRatios, optimizes each level for the vertex cache and overdraw, and appends them to the index buffer. </para>
+	/// <para>A level that doesn't remove at least a quarter of the triangles of the level before it isn't worth its memory, so is left out.</para></summary>
+	/// <param name="indices">The full detail triangle list, which the levels are appended to</param>
+	/// <param name="lods">Replaced with every level including the full detail one, which is first</param>
+	void BuildLods(const std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices, std::vector<MeshLod>& lods);
+
+	/// <summary>Picks the coarsest level whose error would cover no more than maxPixelError pixels on screen</summary>
+	/// <param name="distance">How far the mesh is from the camera, in the mesh's model units</param>
+	/// <param name="pixelScale">How many pixels tall something 1 unit tall looks from 1 unit away, see Camera::GetPixelScale</param>
+	/// <returns>An index into lods. 0 if there are no lower levels</returns>
+	unsigned int SelectLod(const std::vector<MeshLod>& lods, float distance, float pixelScale, float maxPixelError = DefaultPixelError);
+
+	/// <summary>Picks from a range of a mesh's levels, such as one submesh's</summary>
+	/// <returns>An index into the range. 0 if there are no lower levels</returns>
+	unsigned int SelectLod(const MeshLod* lods, size_t lodCount, float distance, float pixelScale, float maxPixelError = DefaultPixelError);
+};
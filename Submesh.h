@@ -0,0 +1,47 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/// <summary><para>The part of a mesh drawn with one material: every face of its .obj file that a usemtl record gave that material. </para>
+/// <para>All of a mesh's submeshes share its vertex and index buffers, so they're drawn with one bind and a DrawIndexed per submesh.
+/// Each has its own meshlets and levels of detail, so it can be culled and simplified without touching the others. </para>
+/// <para>Submeshes are stored in binary meshes as they are, so every field is fixed width.</para></summary>
+struct Submesh
+{
+	/// <summary>The range of the index buffer holding the full detail triangles, which is also the submesh's first level of detail</summary>
+	uint32_t IndexStart;
+	uint32_t IndexCount;
+	/// <summary>The range of the mesh's meshlets that covers the full detail triangles</summary>
+	uint32_t MeshletStart;
+	uint32_t MeshletCount;
+	/// <summary>The range of the mesh's levels of detail that belongs to this submesh, full detail first</summary>
+	uint32_t LodStart;
+	uint32_t LodCount;
+	/// <summary>The area of the full detail triangles in model space, and the area of texture coordinates they cover, see GetTexCoordDensity</summary>
+	float ModelArea;
+	float TexCoordArea;
+	/// <summary>The name its usemtl record gave the material, empty for faces before any usemtl. Cut short if it's too long to fit,
+	/// and only terminated if it's shorter, so read it with GetMaterialName</summary>
+	char MaterialName[40];
+
+	/// <summary>How far across its textures a model unit of the surface goes on average, 0 if it has no area. Multiplied by a texture's size,
+	/// it's how many texels a unit shows, which decides how much of the texture's detail the surface needs from a distance</summary>
+	float GetTexCoordDensity() const
+	{
+		return ModelArea > 0.0f ? sqrtf(TexCoordArea / ModelArea) : 0.0f;
+	}
+
+	std::string GetMaterialName() const
+	{
+		return std::string(MaterialName, strnlen(MaterialName, sizeof(MaterialName)));
+	}
+
+	void SetMaterialName(const std::string& name)
+	{
+		memset(MaterialName, 0, sizeof(MaterialName));
+		memcpy(MaterialName, name.data(), name.size() < sizeof(MaterialName) ? name.size() : sizeof(MaterialName));
+	}
+};
+static_assert(sizeof(Submesh) == 72, "Submeshes are stored in binary meshes as they are");
@@ -0,0 +1,137 @@
+#include "TextureLoadQueue.h"
+#include <algorithm>
+#include <cstring>
+
+TextureLoadQueue::TextureLoadQueue(ThreadPool* pool, size_t tailSize)
+{
+	m_pool = pool != nullptr ? pool : &ThreadPool::GetShared();
+	m_tailSize = tailSize;
+	m_inFlight = 0;
+	m_cancelled = false;
+	m_requested = 0;
+	m_taken = 0;
+	m_failed = 0;
+	m_takenBytes = 0;
+}
+
+TextureLoadQueue::~TextureLoadQueue()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cancelled = true;
+	m_finished.wait(lock, [this] { return m_inFlight == 0; });
+}
+
+uint32_t TextureLoadQueue::Request(const std::string& path)
+{
+	uint32_t id;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		id = m_requested++;
+		m_inFlight++;
+	}
+	m_pool->Enqueue([this, id, path] { Read(id, path); });
+	return id;
+}
+
+void TextureLoadQueue::Read(uint32_t id, const std::string& path)
+{
+	std::unique_ptr<LoadedTexture> loaded;
+	bool cancelled;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		cancelled = m_cancelled;
+	}
+
+	if (!cancelled)
+	{
+		loaded.reset(new LoadedTexture());
+		loaded->Id = id;
+		loaded->Path = path;
+		loaded->Valid = false;
+		memset(&loaded->Info, 0, sizeof(loaded->Info));
+
+		const MappedFile& file = loaded->File;
+		if (loaded->File.Open(path) && file.GetData() != nullptr)
+		{
+			const uint8_t* data = (const uint8_t*)file.GetData();
+			loaded->Valid = DDSProbe::Parse(data, file.GetSize(), loaded->Info) && loaded->Info.DataOffset + loaded->Info.DataBytes <= file.GetSize();
+
+			//Mapping a file doesn't read it, so a byte of every page is read here to fault the whole file in on the worker rather than while uploading
+			if (loaded->Valid)
+			{
+				const volatile uint8_t* pages = data;
+				uint8_t sum = 0;
+				for (size_t at = 0; at < file.GetSize(); at += 4096)
+				{
+					sum += pages[at];
+				}
+				(void)sum;
+			}
+		}
+		if (!loaded->Valid)
+		{
+			loaded->File.Close();
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (loaded)
+	{
+		//Kept in the order requested, whatever order the workers finish in
+		auto at = std::upper_bound(m_ready.begin(), m_ready.end(), id, [](uint32_t id, const std::unique_ptr<LoadedTexture>& ready) { return id < ready->Id; });
+		m_ready.insert(at, std::move(loaded));
+	}
+	m_inFlight--;
+	m_finished.notify_all();
+}
+
+uint64_t TextureLoadQueue::TakeReady(uint64_t budget, std::vector<std::unique_ptr<LoadedTexture>>& taken)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	uint64_t takenBytes = 0;
+	size_t count = 0;
+	for (; count < m_ready.size(); count++)
+	{
+		const LoadedTexture& ready = *m_ready[count];
+		uint64_t bytes = ready.Valid ? DDSProbe::GetBytes(ready.Info, MipStreamer::GetTailMip(ready.Info, m_tailSize)) : 0;
+		if (count > 0 && takenBytes + bytes > budget)
+		{
+			break;
+		}
+		takenBytes += bytes;
+		m_failed += ready.Valid ? 0 : 1;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		taken.push_back(std::move(m_ready[i]));
+	}
+	m_ready.erase(m_ready.begin(), m_ready.begin() + count);
+	m_taken += (uint32_t)count;
+	m_takenBytes += takenBytes;
+	return takenBytes;
+}
+
+void TextureLoadQueue::WaitForAll()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_finished.wait(lock, [this] { return m_inFlight == 0; });
+}
+
+bool TextureLoadQueue::IsIdle()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_inFlight == 0 && m_ready.empty();
+}
+
+TextureLoadQueueStats TextureLoadQueue::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	TextureLoadQueueStats stats;
+	stats.Requested = m_requested;
+	stats.Ready = (uint32_t)m_ready.size();
+	stats.Taken = m_taken;
+	stats.Failed = m_failed;
+	stats.TakenBytes = m_takenBytes;
+	return stats;
+}
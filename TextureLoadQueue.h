@@ -0,0 +1,97 @@
+#pragma once
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "DDSProbe.h"
+#include "MappedFile.h"
+#include "MipStreamer.h"
+#include "ThreadPool.h"
+
+/// <summary>A DDS file a worker has mapped, read in and parsed, waiting to be uploaded</summary>
+struct LoadedTexture
+{
+	/// <summary>What TextureLoadQueue::Request returned for it, which counts up from 0 in the order they were requested</summary>
+	uint32_t Id;
+	std::string Path;
+	/// <summary>false if the file couldn't be mapped, or isn't a DDS file DDSTextureLoader can load. Nothing else is set then</summary>
+	bool Valid;
+	DDSTextureInfo Info;
+	/// <summary>The whole file, every page of it already read in, so uploading it copies from memory rather than waiting on the disk</summary>
+	MappedFile File;
+};
+
+/// <summary>How far a TextureLoadQueue has got</summary>
+struct TextureLoadQueueStats
+{
+	uint32_t Requested;
+	/// <summary>Read by a worker and waiting to be taken</summary>
+	uint32_t Ready;
+	uint32_t Taken;
+	/// <summary>Of those taken, the ones that couldn't be read</summary>
+	uint32_t Failed;
+	/// <summary>The pixel data of every texture taken, counting only its tail if the queue was given a tail size</summary>
+	uint64_t TakenBytes;
+};
+
+/// <summary><para>Reads DDS files on the shared ThreadPool's workers, and hands them back a frame's worth at a time. </para>
+/// <para>Requesting a file only queues it, so however many textures a level has, loading it doesn't wait on any of them. Each call to TakeReady takes
+/// the files finished since the last, in the order they were requested, until the pixel data taken reaches the budget. A texture bigger than the
+/// budget is still taken when it's the first ready, so nothing is left waiting forever. </para>
+/// <para>Nothing here needs Direct3D: TextureLoader does the uploading, so the scheduling can be tested without a GPU, see TextureChecks textures.
+/// Requested and taken from one thread.</para></summary>
+class TextureLoadQueue
+{
+private:
+	ThreadPool* m_pool;
+	/// <summary>Only the tail of each texture counts against TakeReady's budget, see MipStreamer. 0 for every mip</summary>
+	size_t m_tailSize;
+
+	std::mutex m_mutex;
+	/// <summary>Signalled when a worker finishes a file</summary>
+	std::condition_variable m_finished;
+	/// <summary>Finished files not yet taken, kept sorted by Id</summary>
+	std::vector<std::unique_ptr<LoadedTexture>> m_ready;
+	/// <summary>Files queued on the pool that a worker hasn't finished yet</summary>
+	uint32_t m_inFlight;
+	/// <summary>Set when the queue is being destroyed, so files not yet started are skipped</summary>
+	bool m_cancelled;
+
+	uint32_t m_requested;
+	uint32_t m_taken;
+	uint32_t m_failed;
+	uint64_t m_takenBytes;
+
+public:
+	/// <param name="pool">Where the files are read. Null for the shared pool</param>
+	/// <param name="tailSize">When only each texture's tail is uploaded at first, the size of it, so only it counts against TakeReady's budget. 0 for every mip</param>
+	TextureLoadQueue(ThreadPool* pool = nullptr, size_t tailSize = 0);
+	/// <summary>Skips the files no worker has started on, and waits for the rest</summary>
+	~TextureLoadQueue();
+
+	TextureLoadQueue(const TextureLoadQueue&) = delete;
+	TextureLoadQueue& operator=(const TextureLoadQueue&) = delete;
+
+	/// <summary>Queues a DDS file to be read on a worker, and returns straight away</summary>
+	/// <returns>The id its LoadedTexture will have</returns>
+	uint32_t Request(const std::string& path);
+
+	/// <summary>Takes the files finished since the last call, in the order they were requested, until their pixel data reaches budget bytes</summary>
+	/// <param name="budget">How much pixel data to take. The first file ready is always taken, however big it is, as are files that failed</param>
+	/// <param name="taken">Has what was taken appended to it</param>
+	/// <returns>How much pixel data was taken</returns>
+	uint64_t TakeReady(uint64_t budget, std::vector<std::unique_ptr<LoadedTexture>>& taken);
+
+	/// <summary>Blocks until every file requested has been read. TakeReady still has to be called to take them</summary>
+	void WaitForAll();
+
+	/// <summary>Whether every file requested has been taken</summary>
+	bool IsIdle();
+	TextureLoadQueueStats GetStats();
+
+private:
+	/// <summary>Run on a worker: maps the file, reads in each page of it and parses its headers</summary>
+	void Read(uint32_t id, const std::string& path);
+};
@@ -0,0 +1,214 @@
+#include "TextureLoader.h"
+#include <cstdio>
+
+TextureLoader::TextureLoader(ID3D11Device* d3dDevice, uint64_t uploadBudget, uint64_t memoryBudget)
+	: m_queue(nullptr, MipStreamer::DefaultTailSize), m_streamer(memoryBudget, MipStreamer::DefaultTailSize)
+{
+	m_d3dDevice = d3dDevice;
+	m_placeholder = nullptr;
+	m_uploadBudget = uploadBudget;
+	m_memoryBudget = memoryBudget;
+	m_settled = true;
+	m_uploadFrames = 0;
+	m_frames = 0;
+	m_uploaded = 0;
+	m_failed = 0;
+	m_uploadedBytes = 0;
+	m_largestFrameBytes = 0;
+
+	CreatePlaceholder();
+}
+
+TextureLoader::~TextureLoader()
+{
+	//m_queue is destroyed after this, which waits for the workers still reading
+	if (m_placeholder) m_placeholder->Release();
+}
+
+void TextureLoader::CreatePlaceholder()
+{
+	//Mid grey, so an actor still loading is shaded by its material and lights without standing out
+	const uint32_t grey = 0xff808080;
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = 1;
+	desc.Height = 1;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	D3D11_SUBRESOURCE_DATA initData = {};
+	initData.pSysMem = &grey;
+	initData.SysMemPitch = sizeof(grey);
+
+	ID3D11Texture2D* texture = nullptr;
+	if (SUCCEEDED(m_d3dDevice->CreateTexture2D(&desc, &initData, &texture)))
+	{
+		m_d3dDevice->CreateShaderResourceView(texture, nullptr, &m_placeholder);
+		texture->Release();
+	}
+}
+
+Texture* TextureLoader::Load(const std::string& path)
+{
+	Texture* texture = new Texture;
+	texture->View = m_placeholder;
+	texture->StreamIndex = Texture::NotStreamed;
+	if (m_placeholder) m_placeholder->AddRef();
+
+	m_loading.insert({ m_queue.Request(path), texture });
+	return texture;
+}
+
+void TextureLoader::Require(Texture* texture, float texCoordDensity, float distance, float pixelScale)
+{
+	if (texture == nullptr || texture->StreamIndex >= m_streamed.size() || m_streamed[texture->StreamIndex] != texture)
+	{
+		return;
+	}
+	uint32_t index = texture->StreamIndex;
+	m_streamer.Require(index, MipStreamer::GetRequiredMip(m_streamer.GetInfo(index), texCoordDensity, distance, pixelScale));
+}
+
+ID3D11ShaderResourceView* TextureLoader::Upload(const LoadedTexture& loaded, uint32_t firstMip)
+{
+	//The file was read and its headers checked on a worker, so all that's left is the copy from the mapping to the GPU.
+	//maxsize leaves out every mip before firstMip, the way FillInitData skips mips too big for the hardware
+	ID3D11ShaderResourceView* view = nullptr;
+	size_t maxSize = firstMip > 0 ? DDSProbe::GetMaxSize(loaded.Info, firstMip) : 0;
+	CreateDDSTextureFromMemory(m_d3dDevice, (const uint8_t*)loaded.File.GetData(), loaded.File.GetSize(), nullptr, &view, maxSize);
+	return view;
+}
+
+bool TextureLoader::Update()
+{
+	bool loading = !m_loading.empty();
+	uint64_t frameBytes = loading ? UploadLoaded() : 0;
+
+	//Streaming gets whatever of the budget the tails left
+	bool settled = m_streamed.empty() || StreamMips(frameBytes < m_uploadBudget ? m_uploadBudget - frameBytes : 0);
+	bool justSettled = settled && !m_settled;
+	m_settled = settled;
+	return (loading && m_loading.empty()) || (justSettled && m_loading.empty());
+}
+
+uint64_t TextureLoader::UploadLoaded()
+{
+	m_frames++;
+
+	std::vector<std::unique_ptr<LoadedTexture>> ready;
+	uint64_t frameBytes = m_queue.TakeReady(m_uploadBudget, ready);
+	for (std::unique_ptr<LoadedTexture>& loaded : ready)
+	{
+		auto found = m_loading.find(loaded->Id);
+		Texture* texture = found->second;
+		m_loading.erase(found);
+
+		//Only the tail to begin with, the rest of the mips are streamed in once something is drawn close enough to need them
+		ID3D11ShaderResourceView* view = nullptr;
+		if (loaded->Valid)
+		{
+			view = Upload(*loaded, MipStreamer::GetTailMip(loaded->Info, MipStreamer::DefaultTailSize));
+		}
+		if (view == nullptr)
+		{
+			char line[320];
+			sprintf_s(line, "%s: couldn't be loaded, drawn with the placeholder\n", loaded->Path.c_str());
+			OutputDebugStringA(line);
+			m_failed++;
+			continue;
+		}
+
+		if (texture->View) texture->View->Release();
+		texture->View = view;
+		texture->StreamIndex = m_streamer.Add(loaded->Info);
+		m_streamed.push_back(texture);
+		m_streamedFiles.push_back(std::move(loaded));
+		m_uploaded++;
+	}
+
+	if (!ready.empty())
+	{
+		m_uploadFrames++;
+		m_uploadedBytes += frameBytes;
+		m_largestFrameBytes = std::max<uint64_t>(m_largestFrameBytes, frameBytes);
+	}
+	return frameBytes;
+}
+
+bool TextureLoader::StreamMips(uint64_t uploadBudget)
+{
+	std::vector<MipChange> changes;
+	bool settled = m_streamer.Update(uploadBudget, changes);
+	for (const MipChange& change : changes)
+	{
+		//An evicted texture is drawn with the placeholder until it's drawn again and its mips are uploaded again from the mapping
+		Texture* texture = m_streamed[change.Index];
+		if (change.ToMip >= m_streamer.GetInfo(change.Index).MipCount)
+		{
+			if (texture->View) texture->View->Release();
+			texture->View = m_placeholder;
+			if (m_placeholder) m_placeholder->AddRef();
+			continue;
+		}
+
+		//Uploaded again from the mapping with a different first mip. A view can't be given more mips than its texture has, so it's a new texture
+		ID3D11ShaderResourceView* view = Upload(*m_streamedFiles[change.Index], change.ToMip);
+		if (view == nullptr)
+		{
+			char line[320];
+			sprintf_s(line, "%s: couldn't be uploaded from mip %u, kept from mip %u\n", m_streamedFiles[change.Index]->Path.c_str(), change.ToMip, change.FromMip);
+			OutputDebugStringA(line);
+			m_streamer.SetResidentMip(change.Index, change.FromMip);
+			continue;
+		}
+
+		if (texture->View) texture->View->Release();
+		texture->View = view;
+	}
+	return settled;
+}
+
+bool TextureLoader::IsIdle()
+{
+	return m_loading.empty();
+}
+
+void TextureLoader::ReportFrame(const char* name)
+{
+	//Only frames where a texture was evicted or drawn while evicted, as the rest are quiet once streaming settles
+	const MipStreamerFrame& frame = m_streamer.GetFrame();
+	if (frame.Evictions == 0 && frame.Stalls == 0)
+	{
+		return;
+	}
+
+	char line[320];
+	sprintf_s(line, "%s: frame %u: %.2f MB resident of %.2f MB, %u textures evicted, %u stalled waiting to be uploaded again, %u mips changes, %.2f MB uploaded\n",
+		name, frame.Frame, frame.ResidentBytes / (1024.0 * 1024.0), m_memoryBudget / (1024.0 * 1024.0), frame.Evictions, frame.Stalls,
+		frame.Upgrades + frame.Downgrades - frame.Evictions, frame.UploadedBytes / (1024.0 * 1024.0));
+	OutputDebugStringA(line);
+}
+
+const MipStreamerFrame& TextureLoader::GetFrameStats()
+{
+	return m_streamer.GetFrame();
+}
+
+void TextureLoader::Report(const char* name)
+{
+	char line[320];
+	sprintf_s(line, "%s: %u textures uploaded in %u of %u frames, %u failed, %.2f MB of tails in all, at most %.2f MB in a frame against a budget of %.2f MB\n",
+		name, m_uploaded, m_uploadFrames, m_frames, m_failed, m_uploadedBytes / (1024.0 * 1024.0), m_largestFrameBytes / (1024.0 * 1024.0),
+		m_uploadBudget / (1024.0 * 1024.0));
+	OutputDebugStringA(line);
+
+	const MipStreamerStats& stats = m_streamer.GetStats();
+	sprintf_s(line, "%s: mips streamed in %u times and out %u times, %u textures evicted, %u stalls, %.2f MB uploaded, %.2f MB resident of %.2f MB asked for and a budget of %.2f MB, at most %.2f MB\n",
+		name, stats.Upgrades, stats.Downgrades, stats.Evictions, stats.Stalls, stats.UploadedBytes / (1024.0 * 1024.0), stats.ResidentBytes / (1024.0 * 1024.0),
+		stats.RequiredBytes / (1024.0 * 1024.0), m_memoryBudget / (1024.0 * 1024.0), stats.PeakResidentBytes / (1024.0 * 1024.0));
+	OutputDebugStringA(line);
+}
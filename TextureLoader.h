@@ -0,0 +1,97 @@
+#pragma once
+#include <d3d11_1.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Loading.h"
+#include "MipStreamer.h"
+#include "TextureLoadQueue.h"
+
+/// <summary><para>Loads a level's textures in the background, and streams in their mips as they're needed. </para>
+/// <para>Load hands back a texture straight away, drawn with a 1x1 grey placeholder, and queues its file on a TextureLoadQueue to be read on a worker.
+/// Each frame, Update uploads the tails of the files the workers have finished, the mips no bigger than MipStreamer's tail size, up to a budget of
+/// pixel data, and swaps each texture's view for its own, so however many textures a level has the first frame isn't kept waiting for them, and no
+/// frame stalls uploading too many at once. </para>
+/// <para>Each file stays mapped once its tail is uploaded. Whatever draws a texture says how much of its detail is needed with Require, and the
+/// rest of each frame's upload budget goes on uploading the mips MipStreamer picks from the mapping, within the memory budget. Over the budget,
+/// the textures drawn least recently give up their mips first, and those not drawn at all are evicted back to the placeholder until they are. </para>
+/// <para>A texture whose file can't be loaded keeps the placeholder. Only used from the thread that owns the immediate context.</para></summary>
+class TextureLoader
+{
+public:
+	/// <summary>How much pixel data Update uploads a frame unless told otherwise: a 2048x2048 BC1 texture with its mips, or about two</summary>
+	static const uint64_t DefaultUploadBudget = 4 * 1024 * 1024;
+
+private:
+	ID3D11Device* m_d3dDevice;
+	TextureLoadQueue m_queue;
+	/// <summary>The textures still drawn with the placeholder, by the id their file was requested with</summary>
+	std::map<uint32_t, Texture*> m_loading;
+	/// <summary>Shared by every texture still loading, each with a reference of its own</summary>
+	ID3D11ShaderResourceView* m_placeholder;
+	uint64_t m_uploadBudget;
+	uint64_t m_memoryBudget;
+
+	MipStreamer m_streamer;
+	/// <summary>Each texture whose tail has been uploaded, and its file, by its index in m_streamer</summary>
+	std::vector<Texture*> m_streamed;
+	std::vector<std::unique_ptr<LoadedTexture>> m_streamedFiles;
+	/// <summary>Whether m_streamer had every texture at the mips planned for it last frame</summary>
+	bool m_settled;
+
+	/// <summary>How many frames Update has uploaded something in, and how many it's run in since the first texture was loaded</summary>
+	uint32_t m_uploadFrames;
+	uint32_t m_frames;
+	uint32_t m_uploaded;
+	uint32_t m_failed;
+	uint64_t m_uploadedBytes;
+	/// <summary>The most pixel data uploaded in one frame</summary>
+	uint64_t m_largestFrameBytes;
+
+public:
+	/// <param name="uploadBudget">How much pixel data to upload a frame. A texture bigger than this is uploaded on a frame of its own</param>
+	/// <param name="memoryBudget">How much pixel data to keep on the GPU. The tail of every texture drawn is kept whatever the budget</param>
+	TextureLoader(ID3D11Device* d3dDevice, uint64_t uploadBudget = DefaultUploadBudget, uint64_t memoryBudget = MipStreamer::DefaultMemoryBudget);
+	/// <summary>Stops reading the files not yet started, and releases the placeholder. The textures handed out are the caller's, and keep a reference to it
+	/// while they're still using it</summary>
+	~TextureLoader();
+
+	TextureLoader(const TextureLoader&) = delete;
+	TextureLoader& operator=(const TextureLoader&) = delete;
+
+	/// <summary>Queues a DDS file to be loaded in the background</summary>
+	/// <returns>A texture drawn with the placeholder until the file's tail is uploaded. The caller owns it, and releases its View then deletes it</returns>
+	Texture* Load(const std::string& path);
+
+	/// <summary>Asks for a texture to have the detail a surface drawn with it needs this frame, see MipStreamer::GetRequiredMip, and marks it
+	/// drawn this frame so it's the last to give up its mips. Textures still loading, or not loaded by this loader, are left alone</summary>
+	void Require(Texture* texture, float texCoordDensity, float distance, float pixelScale);
+
+	/// <summary>Uploads the tails of the textures finished since the last frame, then the mips streamed in or out, up to the upload budget. Called once a frame</summary>
+	/// <returns>true on the frame the last texture loading is uploaded, and on each frame streaming settles with every texture at the mips planned for it</returns>
+	bool Update();
+
+	/// <summary>Whether every texture loaded has been uploaded, or given up on</summary>
+	bool IsIdle();
+	/// <summary>Writes how many textures have been uploaded, over how many frames, and how much of the memory budget their mips take up, to the debug output</summary>
+	void Report(const char* name);
+	/// <summary>Writes what the textures took up after the last Update, and how many were evicted or drawn while evicted, to the debug output,
+	/// on frames where any were</summary>
+	void ReportFrame(const char* name);
+	/// <summary>What the last Update's streaming did, and what the textures took up after it</summary>
+	const MipStreamerFrame& GetFrameStats();
+
+private:
+	void CreatePlaceholder();
+	/// <summary>Creates a view of a file's texture with every mip from firstMip on</summary>
+	/// <returns>null if Direct3D turned it away</returns>
+	ID3D11ShaderResourceView* Upload(const LoadedTexture& loaded, uint32_t firstMip);
+	/// <summary>Uploads the tails of the files finished since the last frame, up to the upload budget</summary>
+	/// <returns>The pixel data uploaded</returns>
+	uint64_t UploadLoaded();
+	/// <summary>Uploads the changes MipStreamer picks within what's left of the upload budget</summary>
+	/// <returns>Whether there was nothing to change</returns>
+	bool StreamMips(uint64_t uploadBudget);
+};
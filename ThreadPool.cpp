@@ -0,0 +1,154 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::thread::hardware_concurrency();
+		if (threadCount == 0) threadCount = 1; //hardware_concurrency is allowed to return 0 if it can't tell
+	}
+
+	m_running = 0;
+	m_stopping = false;
+
+	m_workers.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_taskAvailable.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+	m_taskAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_idle.wait(lock, [this] { return m_tasks.empty() && m_running == 0; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_taskAvailable.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+
+			//Only stop once everything that was queued has been run
+			if (m_tasks.empty())
+			{
+				return;
+			}
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+			m_running++;
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_running--;
+			if (m_running == 0 && m_tasks.empty())
+			{
+				m_idle.notify_all();
+			}
+		}
+	}
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	if (count == 1)
+	{
+		body(0);
+		return;
+	}
+
+	//Shared between the caller and its helpers. Helpers that only get to run after every item has been claimed do nothing,
+	//so the caller never has to wait for a helper that is stuck in the queue behind other work
+	struct Job
+	{
+		std::atomic<size_t> next;
+		size_t active;
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->next = 0;
+	job->active = 0;
+
+	const std::function<void(size_t)>* bodyPointer = &body;
+	auto work = [job, bodyPointer, count]()
+	{
+		//Each thread takes the next unclaimed item until there are none left
+		for (size_t i = job->next++; i < count; i = job->next++)
+		{
+			(*bodyPointer)(i);
+		}
+	};
+
+	size_t helpers = count - 1 < m_workers.size() ? count - 1 : m_workers.size();
+	for (size_t i = 0; i < helpers; i++)
+	{
+		Enqueue([job, work]()
+		{
+			{
+				std::lock_guard<std::mutex> lock(job->mutex);
+				job->active++;
+			}
+
+			work();
+
+			std::lock_guard<std::mutex> lock(job->mutex);
+			job->active--;
+			job->finished.notify_one();
+		});
+	}
+
+	work();
+
+	//Every item has been claimed, wait for the ones still being worked on by helpers
+	std::unique_lock<std::mutex> lock(job->mutex);
+	job->finished.wait(lock, [&job] { return job->active == 0; });
+}
+
+unsigned int ThreadPool::GetThreadCount() const
+{
+	return (unsigned int)m_workers.size();
+}
+
+ThreadPool& ThreadPool::GetShared()
+{
+	static ThreadPool pool;
+	return pool;
+}
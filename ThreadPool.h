@@ -0,0 +1,50 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary><para>A fixed set of worker threads that run queued tasks. </para>
+/// <para>Loading code shares one pool through GetShared() rather than creating threads per file.</para></summary>
+class ThreadPool
+{
+private:
+	std::vector<std::thread> m_workers;
+	std::deque<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	/// <summary>Signalled when a task is queued or the pool is shutting down</summary>
+	std::condition_variable m_taskAvailable;
+	/// <summary>Signalled when the last running task finishes and the queue is empty</summary>
+	std::condition_variable m_idle;
+	/// <summary>How many tasks are currently being run by workers</summary>
+	size_t m_running;
+	bool m_stopping;
+
+public:
+	/// <param name="threadCount">How many workers to start. 0 uses one per hardware thread</param>
+	ThreadPool(unsigned int threadCount = 0);
+	/// <summary>Finishes every queued task, then joins the workers</summary>
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>Queues a task to be run on one of the workers</summary>
+	void Enqueue(std::function<void()> task);
+	/// <summary>Blocks until the queue is empty and no tasks are running</summary>
+	void Wait();
+
+	/// <summary><para>Calls body(i) for every i in [0, count), spread across the workers, and returns once they have all finished. </para>
+	/// <para>The calling thread works through items too, so this is safe to call from inside a task.</para></summary>
+	void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+	unsigned int GetThreadCount() const;
+
+	/// <summary>The pool shared by the loaders, with one worker per hardware thread</summary>
+	static ThreadPool& GetShared();
+
+private:
+	void WorkerLoop();
+};
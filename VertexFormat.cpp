@@ -0,0 +1,304 @@
+#include "VertexFormat.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+static_assert(sizeof(CompactVertex) * 2 == sizeof(SimpleVertex), "CompactVertex should be half the size of SimpleVertex");
+
+namespace
+{
+#ifdef _WIN32
+	const char* SemanticNames[] = { "POSITION", "NORMAL", "TEXCOORD" };
+#endif
+
+	uint16_t QuantizeUnorm(float value)
+	{
+		value = std::min<float>(std::max<float>(value, 0.0f), 1.0f);
+		return (uint16_t)(value * 65535.0f + 0.5f);
+	}
+
+	int16_t QuantizeSnorm(float value)
+	{
+		value = std::min<float>(std::max<float>(value, -1.0f), 1.0f);
+		return (int16_t)(value * 32767.0f + (value >= 0.0f ? 0.5f : -0.5f));
+	}
+
+	float DequantizeSnorm(int16_t value)
+	{
+		//D3D maps both -32768 and -32767 to -1
+		return std::max<float>(value / 32767.0f, -1.0f);
+	}
+
+	float SignNotZero(float value)
+	{
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	//Projects the unit sphere onto an octahedron, then unfolds the lower half over the corners of the upper half so it fits in a square
+	void EncodeOctahedral(const XMFLOAT3& normal, int16_t encoded[2])
+	{
+		float length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+		if (length == 0.0f)
+		{
+			encoded[0] = encoded[1] = 0;
+			return;
+		}
+
+		float x = normal.x / length;
+		float y = normal.y / length;
+		if (normal.z < 0.0f)
+		{
+			float foldedX = (1.0f - fabsf(y)) * SignNotZero(x);
+			float foldedY = (1.0f - fabsf(x)) * SignNotZero(y);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		encoded[0] = QuantizeSnorm(x);
+		encoded[1] = QuantizeSnorm(y);
+	}
+
+	//Matches DecodeOctahedral in DX11 Framework.hlsl
+	XMFLOAT3 DecodeOctahedral(const int16_t encoded[2])
+	{
+		float x = DequantizeSnorm(encoded[0]);
+		float y = DequantizeSnorm(encoded[1]);
+		float z = 1.0f - fabsf(x) - fabsf(y);
+		float t = std::max<float>(-z, 0.0f);
+		x += x >= 0.0f ? -t : t;
+		y += y >= 0.0f ? -t : t;
+
+		float length = sqrtf(x * x + y * y + z * z);
+		return XMFLOAT3(x / length, y / length, z / length);
+	}
+}
+
+VertexLayoutDesc VertexFormats::GetLayout(VertexFormat format)
+{
+	VertexLayoutDesc layout = {};
+	switch (format)
+	{
+	case VertexFormat::Float:
+		layout.Stride = sizeof(SimpleVertex);
+		layout.AttributeCount = 3;
+		layout.Attributes[0] = { VertexSemantic::Position, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(SimpleVertex, Pos) };
+		layout.Attributes[1] = { VertexSemantic::Normal, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(SimpleVertex, Normal) };
+		layout.Attributes[2] = { VertexSemantic::TexCoord, DXGI_FORMAT_R32G32_FLOAT, offsetof(SimpleVertex, TexCoord) };
+		break;
+	case VertexFormat::Compact:
+		layout.Stride = sizeof(CompactVertex);
+		layout.AttributeCount = 3;
+		layout.Attributes[0] = { VertexSemantic::Position, DXGI_FORMAT_R16G16B16A16_UNORM, offsetof(CompactVertex, Pos) };
+		layout.Attributes[1] = { VertexSemantic::Normal, DXGI_FORMAT_R16G16_SNORM, offsetof(CompactVertex, Normal) };
+		layout.Attributes[2] = { VertexSemantic::TexCoord, DXGI_FORMAT_R16G16_FLOAT, offsetof(CompactVertex, TexCoord) };
+		break;
+	}
+	return layout;
+}
+
+const char* VertexFormats::GetShaderEntryPoint(VertexFormat format)
+{
+	return format == VertexFormat::Compact ? "VS_Compact" : "VS";
+}
+
+const char* VertexFormats::GetName(VertexFormat format)
+{
+	return format == VertexFormat::Compact ? "compact" : "float";
+}
+
+bool VertexFormats::FromName(const std::string& name, VertexFormat& format)
+{
+	for (unsigned int i = 0; i < VertexFormatCount; i++)
+	{
+		if (name == GetName((VertexFormat)i))
+		{
+			format = (VertexFormat)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+#ifdef _WIN32
+UINT VertexFormats::CreateInputElements(const VertexLayoutDesc& layout, D3D11_INPUT_ELEMENT_DESC* elements)
+{
+	for (uint32_t i = 0; i < layout.AttributeCount; i++)
+	{
+		const VertexAttributeDesc& attribute = layout.Attributes[i];
+		elements[i].SemanticName = SemanticNames[(uint32_t)attribute.Semantic];
+		elements[i].SemanticIndex = 0;
+		elements[i].Format = (DXGI_FORMAT)attribute.Format;
+		elements[i].InputSlot = 0;
+		elements[i].AlignedByteOffset = attribute.Offset;
+		elements[i].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		elements[i].InstanceDataStepRate = 0;
+	}
+	return layout.AttributeCount;
+}
+#endif
+
+void VertexFormats::Compress(const std::vector<SimpleVertex>& vertices, std::vector<CompactVertex>& compactVertices, VertexQuantization& quantization)
+{
+	float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (const SimpleVertex& vertex : vertices)
+	{
+		const float* position = &vertex.Pos.x;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			minimum[axis] = std::min<float>(minimum[axis], position[axis]);
+			maximum[axis] = std::max<float>(maximum[axis], position[axis]);
+		}
+	}
+	if (vertices.empty())
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			minimum[axis] = maximum[axis] = 0.0f;
+		}
+	}
+
+	quantization = GetQuantization(minimum, maximum);
+	compactVertices.resize(vertices.size());
+	Compress(vertices.data(), vertices.size(), quantization, compactVertices.data());
+}
+
+void VertexFormats::Compress(const SimpleVertex* vertices, size_t count, const VertexQuantization& quantization, CompactVertex* compactVertices)
+{
+	float inverseScale[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float extent = quantization.PositionScale[axis];
+		inverseScale[axis] = extent > 0.0f ? 1.0f / extent : 0.0f;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const SimpleVertex& vertex = vertices[i];
+		CompactVertex& compact = compactVertices[i];
+
+		const float* position = &vertex.Pos.x;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			compact.Pos[axis] = QuantizeUnorm((position[axis] - quantization.PositionOffset[axis]) * inverseScale[axis]);
+		}
+		compact.Pos[3] = 0;
+
+		EncodeOctahedral(vertex.Normal, compact.Normal);
+		compact.TexCoord[0] = FloatToHalf(vertex.TexCoord.x);
+		compact.TexCoord[1] = FloatToHalf(vertex.TexCoord.y);
+	}
+}
+
+VertexQuantization VertexFormats::GetQuantization(const float minimum[3], const float maximum[3])
+{
+	//Each axis gets the full 16 bits across its own extent. A flat axis gets a scale of 0, so every vertex decodes to the same value
+	VertexQuantization quantization;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		quantization.PositionOffset[axis] = minimum[axis];
+		quantization.PositionScale[axis] = maximum[axis] - minimum[axis];
+	}
+	return quantization;
+}
+
+SimpleVertex VertexFormats::Decompress(const CompactVertex& vertex, const VertexQuantization& quantization)
+{
+	SimpleVertex result;
+	float* position = &result.Pos.x;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		position[axis] = quantization.PositionOffset[axis] + vertex.Pos[axis] / 65535.0f * quantization.PositionScale[axis];
+	}
+	result.Normal = DecodeOctahedral(vertex.Normal);
+	result.TexCoord = XMFLOAT2(HalfToFloat(vertex.TexCoord[0]), HalfToFloat(vertex.TexCoord[1]));
+	return result;
+}
+
+VertexQuantizationError VertexFormats::MeasureError(const std::vector<SimpleVertex>& vertices, const std::vector<CompactVertex>& compactVertices, const VertexQuantization& quantization)
+{
+	VertexQuantizationError error = {};
+	float smallestCos = 1.0f;
+
+	for (size_t i = 0; i < vertices.size() && i < compactVertices.size(); i++)
+	{
+		const SimpleVertex& original = vertices[i];
+		SimpleVertex decoded = Decompress(compactVertices[i], quantization);
+
+		float dx = decoded.Pos.x - original.Pos.x;
+		float dy = decoded.Pos.y - original.Pos.y;
+		float dz = decoded.Pos.z - original.Pos.z;
+		error.MaxPositionError = std::max<float>(error.MaxPositionError, sqrtf(dx * dx + dy * dy + dz * dz));
+
+		//Compare against the normalized original, the encoding can't keep the length of a normal that wasn't unit length
+		const XMFLOAT3& n = original.Normal;
+		float length = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+		if (length > 0.0f)
+		{
+			float cosAngle = (n.x * decoded.Normal.x + n.y * decoded.Normal.y + n.z * decoded.Normal.z) / length;
+			smallestCos = std::min<float>(smallestCos, cosAngle);
+		}
+
+		error.MaxTexCoordError = std::max<float>(error.MaxTexCoordError, fabsf(decoded.TexCoord.x - original.TexCoord.x));
+		error.MaxTexCoordError = std::max<float>(error.MaxTexCoordError, fabsf(decoded.TexCoord.y - original.TexCoord.y));
+	}
+
+	const float* scale = quantization.PositionScale;
+	float diagonal = sqrtf(scale[0] * scale[0] + scale[1] * scale[1] + scale[2] * scale[2]);
+	error.RelativePositionError = diagonal > 0.0f ? error.MaxPositionError / diagonal : 0.0f;
+	error.MaxNormalError = acosf(std::min<float>(std::max<float>(smallestCos, -1.0f), 1.0f)) * 180.0f / 3.14159265f;
+	return error;
+}
+
+VertexQuantization VertexFormats::GetIdentityQuantization()
+{
+	VertexQuantization quantization = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+	return quantization;
+}
+
+uint16_t VertexFormats::FloatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t magnitude = bits & 0x7FFFFFFF;
+
+	//Rebias the exponent from 127 to 15 and round the mantissa to nearest
+	uint32_t half = (magnitude - (112u << 23) + (1u << 12)) >> 13;
+
+	if (magnitude < (113u << 23)) half = 0;				//Too small for a normal half, flush to zero
+	if (magnitude >= (143u << 23)) half = 0x7C00;		//Too big, becomes infinity
+	if (magnitude > (255u << 23)) half = 0x7E00;		//NaN stays NaN
+
+	return (uint16_t)(sign | half);
+}
+
+float VertexFormats::HalfToFloat(uint16_t value)
+{
+	uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+	uint32_t exponent = (value >> 10) & 0x1F;
+	uint32_t mantissa = value & 0x3FF;
+
+	uint32_t bits;
+	if (exponent == 0)
+	{
+		//Zero or a denormal, which is just the mantissa scaled by 2^-24
+		float result = mantissa * (1.0f / 16777216.0f);
+		return sign ? -result : result;
+	}
+	else if (exponent == 31)
+	{
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
@@ -0,0 +1,133 @@
+#pragma once
+#ifdef _WIN32
+#include <d3d11_1.h>
+#else
+//The asset cooker builds without Direct3D, but layouts still store DXGI formats so it needs their values, see Cooker/CMakeLists.txt
+#include <dxgiformat.h>
+#endif
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Vertices.h"
+
+/// <summary>The ways a mesh's vertices can be stored in its vertex buffer</summary>
+enum class VertexFormat : uint32_t
+{
+	/// <summary>SimpleVertex: full floats, 32 bytes</summary>
+	Float,
+	/// <summary>CompactVertex: quantized, 16 bytes</summary>
+	Compact,
+};
+const unsigned int VertexFormatCount = 2;
+
+/// <summary>Which vertex shader input an attribute feeds</summary>
+enum class VertexSemantic : uint32_t
+{
+	Position,
+	Normal,
+	TexCoord,
+};
+
+/// <summary>One attribute of a vertex</summary>
+struct VertexAttributeDesc
+{
+	VertexSemantic Semantic;
+	/// <summary>A DXGI_FORMAT value</summary>
+	uint32_t Format;
+	/// <summary>Byte offset from the start of the vertex</summary>
+	uint32_t Offset;
+};
+
+/// <summary><para>Describes how the vertices of a format are laid out. </para>
+/// <para>This is the single description of each format: the input layout is generated from it, and it is stored in binary meshes so a cache written
+/// with a different layout is never misread.</para></summary>
+struct VertexLayoutDesc
+{
+	static const uint32_t MaxAttributes = 8;
+
+	uint32_t Stride;
+	uint32_t AttributeCount;
+	VertexAttributeDesc Attributes[MaxAttributes];
+};
+
+/// <summary><para>A 16 byte vertex, half the size of SimpleVertex. </para>
+/// <para>Position is 16 bit UNORM within the mesh's bounding box, the normal is octahedral encoded into 2 SNORM components
+/// and the texture coordinate is 2 half floats.</para></summary>
+struct CompactVertex
+{
+	/// <summary>xyz, plus a w that is always 0 as there is no 3 component 16 bit format</summary>
+	uint16_t Pos[4];
+	int16_t Normal[2];
+	uint16_t TexCoord[2];
+};
+
+/// <summary>Turns quantized positions back into model space: position = offset + quantized * scale. Offset 0 and scale 1 for float vertices</summary>
+struct VertexQuantization
+{
+	float PositionOffset[3];
+	float PositionScale[3];
+};
+
+/// <summary>How far compact vertices are from the float vertices they were made from</summary>
+struct VertexQuantizationError
+{
+	/// <summary>The largest distance between a quantized and original position, in model units</summary>
+	float MaxPositionError;
+	/// <summary>MaxPositionError as a fraction of the length of the bounding box's diagonal</summary>
+	float RelativePositionError;
+	/// <summary>The largest angle between a decoded and original normal, in degrees</summary>
+	float MaxNormalError;
+	/// <summary>The largest difference in either texture coordinate component</summary>
+	float MaxTexCoordError;
+};
+
+#ifdef _WIN32
+/// <summary>The shader and input layout used to draw each vertex format. Both arrays are indexed by VertexFormat</summary>
+struct VertexShaderSet
+{
+	ID3D11VertexShader* Shaders[VertexFormatCount];
+	ID3D11InputLayout* InputLayouts[VertexFormatCount];
+};
+#endif
+
+namespace VertexFormats
+{
+	/// <summary>The layout of a vertex format</summary>
+	VertexLayoutDesc GetLayout(VertexFormat format);
+
+	/// <summary>The entry point of the vertex shader in DX11 Framework.hlsl that reads this format</summary>
+	const char* GetShaderEntryPoint(VertexFormat format);
+
+	/// <summary>The format's name as written in level files: "float" or "compact"</summary>
+	const char* GetName(VertexFormat format);
+	/// <summary>Looks up a format from its name in a level file</summary>
+	/// <returns>false if the name isn't a format, in which case format is left untouched</returns>
+	bool FromName(const std::string& name, VertexFormat& format);
+
+#ifdef _WIN32
+	/// <summary>Fills in the D3D11 input layout for a format's layout</summary>
+	/// <param name="elements">Must have room for VertexLayoutDesc::MaxAttributes elements</param>
+	/// <returns>The number of elements filled in</returns>
+	UINT CreateInputElements(const VertexLayoutDesc& layout, D3D11_INPUT_ELEMENT_DESC* elements);
+#endif
+
+	/// <summary>Quantizes float vertices into compact ones, relative to their bounding box</summary>
+	/// <param name="quantization">Set to what the shader needs to turn the positions back into model space</param>
+	void Compress(const std::vector<SimpleVertex>& vertices, std::vector<CompactVertex>& compactVertices, VertexQuantization& quantization);
+	/// <summary>Quantizes vertices with a quantization worked out beforehand, so a mesh can be compressed a block at a time</summary>
+	/// <param name="compactVertices">Room for count vertices</param>
+	void Compress(const SimpleVertex* vertices, size_t count, const VertexQuantization& quantization, CompactVertex* compactVertices);
+	/// <summary>The quantization that spreads 16 bits across the box from minimum to maximum on each axis</summary>
+	VertexQuantization GetQuantization(const float minimum[3], const float maximum[3]);
+	/// <summary>Turns a compact vertex back into floats, the same way the vertex shader does</summary>
+	SimpleVertex Decompress(const CompactVertex& vertex, const VertexQuantization& quantization);
+	/// <summary>Compares compact vertices against the float vertices they were compressed from</summary>
+	VertexQuantizationError MeasureError(const std::vector<SimpleVertex>& vertices, const std::vector<CompactVertex>& compactVertices, const VertexQuantization& quantization);
+
+	/// <summary>The quantization of float vertices, which leaves positions as they are</summary>
+	VertexQuantization GetIdentityQuantization();
+
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+};
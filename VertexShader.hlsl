@@ -1,4 +1,4 @@
-float4 main( float4 pos : POSITION ) : SV_POSITION
-{
-	return pos;
+float4 main( float4 pos : POSITION ) : SV_POSITION
+{
+	return pos;
 }
\ No newline at end of file
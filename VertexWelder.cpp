@@ -0,0 +1,84 @@
+#include "VertexWelder.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+static_assert(sizeof(SimpleVertex) == 8 * sizeof(uint32_t), "VertexWelder hashes SimpleVertex as 8 words with no padding");
+
+VertexWelder::VertexWelder(size_t maxVertices)
+{
+	//Keep the load factor at or below 50% so probe sequences stay short
+	size_t capacity = 16;
+	while (capacity < maxVertices * 2)
+	{
+		capacity *= 2;
+	}
+
+	m_slots.assign(capacity, EmptySlot);
+	m_mask = capacity - 1;
+	m_vertices.reserve(maxVertices);
+}
+
+unsigned int VertexWelder::Hash(const SimpleVertex& vertex)
+{
+	uint32_t words[8];
+	memcpy(words, &vertex, sizeof(words));
+
+	//Murmur3's 32 bit mixing, one word at a time
+	uint32_t h = 0x9747b28c;
+	for (int i = 0; i < 8; i++)
+	{
+		uint32_t k = words[i];
+		k *= 0xcc9e2d51;
+		k = (k << 15) | (k >> 17);
+		k *= 0x1b873593;
+
+		h ^= k;
+		h = (h << 13) | (h >> 19);
+		h = h * 5 + 0xe6546b64;
+	}
+
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+unsigned int VertexWelder::Insert(const SimpleVertex& vertex)
+{
+	size_t slot = Hash(vertex) & m_mask;
+	while (true)
+	{
+		unsigned int index = m_slots[slot];
+		if (index == EmptySlot) //Not seen before, add it
+		{
+			index = (unsigned int)m_vertices.size();
+			m_vertices.push_back(vertex);
+			m_slots[slot] = index;
+			return index;
+		}
+		if (memcmp(&m_vertices[index], &vertex, sizeof(SimpleVertex)) == 0) //Already have this one, re-use its index
+		{
+			return index;
+		}
+		slot = (slot + 1) & m_mask;
+	}
+}
+
+void VertexWelder::Clear()
+{
+	std::fill(m_slots.begin(), m_slots.end(), EmptySlot);
+	m_vertices.clear();
+}
+
+const std::vector<SimpleVertex>& VertexWelder::GetVertices() const
+{
+	return m_vertices;
+}
+
+size_t VertexWelder::GetVertexCount() const
+{
+	return m_vertices.size();
+}
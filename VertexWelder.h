@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+
+#include "Vertices.h"
+
+/// <summary><para>Merges vertices whose bytes are identical, so a mesh only stores each unique vertex once. </para>
+/// <para>Uses a flat open-addressing hash table (linear probing) sized up front, so welding n vertices is O(n) with
+/// no per-vertex allocation, unlike the std::map it replaces.</para></summary>
+class VertexWelder
+{
+private:
+	/// <summary>The unique vertices, in the order they were first seen</summary>
+	std::vector<SimpleVertex> m_vertices;
+	/// <summary>The hash table. Each slot holds an index into m_vertices, or EmptySlot</summary>
+	std::vector<unsigned int> m_slots;
+	/// <summary>The table's size is a power of 2, so hashes are wrapped with a mask rather than a modulo</summary>
+	size_t m_mask;
+
+	static constexpr unsigned int EmptySlot = 0xFFFFFFFF;
+
+public:
+	/// <param name="maxVertices">The most vertices that will be inserted. The table is sized so it never needs to grow</param>
+	VertexWelder(size_t maxVertices);
+
+	/// <summary>Finds a vertex identical to this one, adding it if there isn't one yet</summary>
+	/// <returns>The index of the vertex within GetVertices()</returns>
+	unsigned int Insert(const SimpleVertex& vertex);
+
+	/// <summary>Forgets every vertex, keeping the table's memory so the welder can be used again for up to as many vertices</summary>
+	void Clear();
+
+	const std::vector<SimpleVertex>& GetVertices() const;
+	size_t GetVertexCount() const;
+
+	/// <summary>Hashes the raw bytes of a vertex</summary>
+	static unsigned int Hash(const SimpleVertex& vertex);
+};
@@ -1,29 +1,29 @@
-//{{NO_DEPENDENCIES}}
-// Microsoft Visual C++ generated include file.
-// Used by DX11 Framework.rc
-//
-
-#define IDS_APP_TITLE           103
-
-#define IDR_MAINFRAME           128
-#define IDD_TUTORIAL1_DIALOG    102
-#define IDD_ABOUTBOX            103
-#define IDM_ABOUT               104
-#define IDM_EXIT                105
-#define IDI_TUTORIAL1           107
-#define IDI_SMALL               108
-#define IDC_TUTORIAL1           109
-#define IDC_MYICON              2
-#define IDC_STATIC              -1
-// Next default values for new objects
-// 
-#ifdef APSTUDIO_INVOKED
-#ifndef APSTUDIO_READONLY_SYMBOLS
-
-#define _APS_NO_MFC                 130
-#define _APS_NEXT_RESOURCE_VALUE    129
-#define _APS_NEXT_COMMAND_VALUE     32771
-#define _APS_NEXT_CONTROL_VALUE     1000
-#define _APS_NEXT_SYMED_VALUE       110
-#endif
-#endif
+//{{NO_DEPENDENCIES}}
+// Microsoft Visual C++ generated include file.
+// Used by DX11 Framework.rc
+//
+
+#define IDS_APP_TITLE           103
+
+#define IDR_MAINFRAME           128
+#define IDD_TUTORIAL1_DIALOG    102
+#define IDD_ABOUTBOX            103
+#define IDM_ABOUT               104
+#define IDM_EXIT                105
+#define IDI_TUTORIAL1           107
+#define IDI_SMALL               108
+#define IDC_TUTORIAL1           109
+#define IDC_MYICON              2
+#define IDC_STATIC              -1
+// Next default values for new objects
+// 
+#ifdef APSTUDIO_INVOKED
+#ifndef APSTUDIO_READONLY_SYMBOLS
+
+#define _APS_NO_MFC                 130
+#define _APS_NEXT_RESOURCE_VALUE    129
+#define _APS_NEXT_COMMAND_VALUE     32771
+#define _APS_NEXT_CONTROL_VALUE     1000
+#define _APS_NEXT_SYMED_VALUE       110
+#endif
+#endif